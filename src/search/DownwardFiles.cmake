@@ -49,6 +49,7 @@ fast_downward_plugin(
         planner
         abstract_task
         axioms
+        evaluation_batch
         evaluation_context
         evaluation_result
         evaluator
@@ -63,6 +64,7 @@ fast_downward_plugin(
         operator_id
         option_parser
         option_parser_util
+        packed_state_view
         per_state_information
         plugin
         pruning_method
@@ -86,6 +88,7 @@ fast_downward_plugin(
         planner
         abstract_task
         axioms
+        evaluation_batch
         evaluation_context
         evaluation_result
         evaluator
@@ -99,6 +102,7 @@ fast_downward_plugin(
         operator_id
         option_parser
         option_parser_util
+        packed_state_view
         plugin
         pruning_method
         search_engine
@@ -110,11 +114,14 @@ fast_downward_plugin(
 
         external/closed_list
         external/closed_list_factory
+        external/utils/block_codec
         external/utils/named_fstream
         external/utils/wall_timer
         external/utils/errors
 
-    DEPENDS CAUSAL_GRAPH INT_PACKER ORDERED_SET SUCCESSOR_GENERATOR TASK_PROPERTIES BLIND_SEARCH_HEURISTIC PDBS MAS_HEURISTIC PLUGIN_ASTAR_IDD PLUGIN_EXTERNAL_ASTAR PLUGIN_ASTAR_DDD
+        pdbs/pattern_database_on_disk
+
+    DEPENDS CAUSAL_GRAPH INT_PACKER ORDERED_SET SUCCESSOR_GENERATOR TASK_PROPERTIES BLIND_SEARCH_HEURISTIC LANDMARK_CUT_HEURISTIC PDBS MAS_HEURISTIC PLUGIN_ASTAR_IDD PLUGIN_EXTERNAL_ASTAR PLUGIN_ASTAR_DDD PLUGIN_HYBRID_ASTAR_IDD PLUGIN_EXTERNAL_GREEDY PLUGIN_BIDIRECTIONAL_DDD
     DEPENDENCY_ONLY
 )
 
@@ -146,6 +153,33 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
  )
 
+fast_downward_plugin(
+    NAME PLUGIN_HYBRID_ASTAR_IDD
+    HELP "Hybrid in-memory A* switching to A*-IDD"
+    SOURCES
+        external/search_engines/plugin_hybrid_astar_idd
+    DEPENDS HYBRID_SEARCH EXTERNAL_SEARCH_COMMON
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME PLUGIN_EXTERNAL_GREEDY
+    HELP "External greedy best-first search"
+    SOURCES
+        external/search_engines/plugin_external_greedy
+    DEPENDS EXTERNAL_LAZY_SEARCH EXTERNAL_GREEDY_OPEN_LIST EXTERNAL_SEARCH_COMMON
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME PLUGIN_BIDIRECTIONAL_DDD
+    HELP "Bidirectional breadth-first search with hash-based DDD"
+    SOURCES
+        external/search_engines/plugin_bidirectional_ddd
+    DEPENDS BIDIRECTIONAL_DDD_SEARCH
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME EXTERNAL_SEARCH_COMMON
     HELP "Basic classes used for all external search engines"
@@ -182,6 +216,24 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME BIDIRECTIONAL_DDD_SEARCH
+    HELP "Bidirectional breadth-first search algorithm with hash-based DDD"
+    SOURCES
+        external/search_engines/bidirectional_ddd_search
+    DEPENDS SUCCESSOR_GENERATOR
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME HYBRID_SEARCH
+    HELP "Hybrid in-memory/external search algorithm"
+    SOURCES
+        external/search_engines/hybrid_search
+    DEPENDS NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR IN_MEMORY_TIEBREAKING_OPEN_LIST IN_MEMORY_CLOSED_LIST EXTERNAL_TIEBREAKING_OPEN_LIST COMPRESS_CLOSED_LIST
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME EXTERNAL_TIEBREAKING_OPEN_LIST
     HELP "External tiebreaking open list"
@@ -190,6 +242,22 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME EXTERNAL_GREEDY_OPEN_LIST
+    HELP "External greedy open list with preferred successor queue"
+    SOURCES
+        external/open_lists/external_greedy_open_list
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME IN_MEMORY_TIEBREAKING_OPEN_LIST
+    HELP "In-memory tiebreaking open list for external search nodes"
+    SOURCES
+        external/open_lists/in_memory_tiebreaking_open_list
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME EXTERNAL_ASTAR_OPEN_LIST
     HELP "External A* (Edelkamp) open list"
@@ -216,6 +284,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME IN_MEMORY_CLOSED_LIST
+    HELP "In-memory closed list"
+    SOURCES
+        external/closed_lists/in_memory/in_memory_closed_list
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME HASH_FUNCTIONS
     HELP "HASH FUNCTIONS"
@@ -260,11 +336,13 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/parallel
         utils/rng
         utils/rng_options
         utils/system
         utils/system_unix
         utils/system_windows
+        utils/table_file
         utils/timer
     CORE_PLUGIN
 )
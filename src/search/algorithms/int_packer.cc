@@ -62,6 +62,10 @@ public:
         Bin &bin = buffer[bin_index];
         bin = (bin & clear_mask) | (value << shift);
     }
+
+    VariableLocation get_location() const {
+        return VariableLocation {bin_index, shift, read_mask};
+    }
 };
 
 
@@ -81,6 +85,10 @@ void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
 
+IntPacker::VariableLocation IntPacker::get_location(int var) const {
+    return var_infos[var].get_location();
+}
+
 void IntPacker::pack_bins(const vector<int> &ranges) {
     assert(var_infos.empty());
 
@@ -42,6 +42,18 @@ public:
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    /*
+      Bits that hold a variable. Code that writes the same values many
+      times, such as operator effects, can precompute the word operation
+      buffer[bin_index] = (buffer[bin_index] & ~mask) | (value << shift).
+    */
+    struct VariableLocation {
+        int bin_index;
+        int shift;
+        Bin mask;
+    };
+    VariableLocation get_location(int var) const;
+
     int get_num_bins() const {return num_bins; }
 };
 }
@@ -2,15 +2,25 @@
 
 #include "algorithms/int_packer.h"
 #include "task_utils/task_properties.h"
+#include "utils/system.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <map>
 #include <vector>
 
 using namespace std;
 
-AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy) {
+/*
+  Upper bound on the number of rules and conditions stored for incremental
+  evaluation. Operators beyond it use the full evaluation.
+*/
+static const size_t MAX_AFFECTED_AXIOMS_ENTRIES = 1 << 24;
+
+AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy)
+    : validation_interval(0),
+      evaluations_since_validation(0) {
     task_has_axioms = task_properties::has_axioms(task_proxy);
     if (task_has_axioms) {
         VariablesProxy variables = task_proxy.get_variables();
@@ -32,6 +42,7 @@ AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy) {
         }
 
         // Cross-reference rules and literals
+        vector<vector<FactPair>> rule_conditions(rules.size());
         for (OperatorProxy axiom : axioms) {
             EffectProxy effect = axiom.get_effects()[0];
             for (FactProxy condition : effect.get_conditions()) {
@@ -39,6 +50,7 @@ AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy) {
                 int val = condition.get_value();
                 AxiomRule *rule = &rules[axiom.get_id()];
                 axiom_literals[var_id][val].condition_of.push_back(rule);
+                rule_conditions[axiom.get_id()].emplace_back(var_id, val);
             }
         }
 
@@ -70,6 +82,131 @@ AxiomEvaluator::AxiomEvaluator(const TaskProxy &task_proxy) {
             else
                 default_values.emplace_back(-1);
         }
+
+        compute_affected_axioms(task_proxy, rule_conditions);
+    }
+}
+
+void AxiomEvaluator::compute_affected_axioms(
+    const TaskProxy &task_proxy,
+    const vector<vector<FactPair>> &rule_conditions) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    int last_layer = nbf_info_by_layer.size() - 1;
+
+    // dependents[var]: derived variables with a rule that has a condition on var
+    vector<vector<int>> dependents(num_variables);
+    vector<vector<int>> rules_by_effect_var(num_variables);
+    for (size_t rule_no = 0; rule_no < rules.size(); ++rule_no) {
+        int effect_var = rules[rule_no].effect_var;
+        rules_by_effect_var[effect_var].push_back(rule_no);
+        for (const FactPair &condition : rule_conditions[rule_no])
+            dependents[condition.var].push_back(effect_var);
+    }
+    for (vector<int> &vars : dependents) {
+        sort(vars.begin(), vars.end());
+        vars.erase(unique(vars.begin(), vars.end()), vars.end());
+    }
+
+    // Operators with the same effect variables share their affected axioms.
+    map<vector<int>, int> index_by_effect_vars;
+    size_t num_stored_entries = 0;
+    vector<bool> is_affected(num_variables, false);
+    OperatorsProxy operators = task_proxy.get_operators();
+    affected_axioms_by_operator.reserve(operators.size());
+    for (OperatorProxy op : operators) {
+        vector<int> effect_vars;
+        for (EffectProxy effect : op.get_effects())
+            effect_vars.push_back(effect.get_fact().get_variable().get_id());
+        sort(effect_vars.begin(), effect_vars.end());
+        effect_vars.erase(unique(effect_vars.begin(), effect_vars.end()),
+                          effect_vars.end());
+
+        auto it = index_by_effect_vars.find(effect_vars);
+        if (it != index_by_effect_vars.end()) {
+            affected_axioms_by_operator.push_back(it->second);
+            continue;
+        }
+
+        AffectedAxioms affected;
+        vector<int> open(effect_vars);
+        while (!open.empty()) {
+            int var = open.back();
+            open.pop_back();
+            for (int dependent : dependents[var]) {
+                if (!is_affected[dependent]) {
+                    is_affected[dependent] = true;
+                    affected.derived_vars.push_back(dependent);
+                    open.push_back(dependent);
+                }
+            }
+        }
+
+        size_t num_affected_rules = 0;
+        for (int var : affected.derived_vars)
+            num_affected_rules += rules_by_effect_var[var].size();
+        bool use_incremental_evaluation = 2 * num_affected_rules <= rules.size();
+        if (use_incremental_evaluation) {
+            affected.nbf_info_by_layer.resize(nbf_info_by_layer.size());
+            for (int var : affected.derived_vars) {
+                int layer = variables[var].get_axiom_layer();
+                if (layer != last_layer) {
+                    affected.nbf_info_by_layer[layer].emplace_back(
+                        var, &axiom_literals[var][default_values[var]]);
+                }
+                for (int rule_no : rules_by_effect_var[var]) {
+                    AffectedRule rule;
+                    rule.rule_no = rule_no;
+                    rule.num_affected_conditions = 0;
+                    rule.conditions_begin = affected.checked_conditions.size();
+                    for (const FactPair &condition : rule_conditions[rule_no]) {
+                        if (is_affected[condition.var])
+                            ++rule.num_affected_conditions;
+                        else
+                            affected.checked_conditions.push_back(condition);
+                    }
+                    rule.conditions_end = affected.checked_conditions.size();
+                    affected.rules.push_back(rule);
+                }
+            }
+        }
+        for (int var : affected.derived_vars)
+            is_affected[var] = false;
+        int index = -1;
+        if (use_incremental_evaluation) {
+            num_stored_entries += affected.rules.size() +
+                                  affected.checked_conditions.size();
+            if (num_stored_entries <= MAX_AFFECTED_AXIOMS_ENTRIES) {
+                index = affected_axioms.size();
+                affected_axioms.push_back(move(affected));
+            }
+        }
+        index_by_effect_vars[effect_vars] = index;
+        affected_axioms_by_operator.push_back(index);
+    }
+}
+
+void AxiomEvaluator::fire_rule(AxiomRule &rule, PackedStateBin *buffer,
+                               const int_packer::IntPacker &state_packer) {
+    int var_no = rule.effect_var;
+    int val = rule.effect_val;
+    if (state_packer.get(buffer, var_no) != val) {
+        state_packer.set(buffer, var_no, val);
+        queue.push_back(rule.effect_literal);
+    }
+}
+
+// Applies Horn rules until the queue is empty.
+void AxiomEvaluator::propagate(PackedStateBin *buffer,
+                               const int_packer::IntPacker &state_packer) {
+    while (!queue.empty()) {
+        AxiomLiteral *curr_literal = queue.back();
+        queue.pop_back();
+        for (size_t i = 0; i < curr_literal->condition_of.size(); ++i) {
+            AxiomRule *rule = curr_literal->condition_of[i];
+            if (--rule->unsatisfied_conditions == 0)
+                fire_rule(*rule, buffer, state_packer);
+        }
     }
 }
 
@@ -99,38 +236,12 @@ void AxiomEvaluator::evaluate(PackedStateBin *buffer,
           instead of the following block.
           assert(rule.condition_count != 0);
         */
-        if (rule.condition_count == 0) {
-            /*
-              NOTE: This duplicates code from the main loop below.
-              I don't mind because this is (hopefully!) going away
-              some time.
-            */
-            int var_no = rule.effect_var;
-            int val = rule.effect_val;
-            if (state_packer.get(buffer, var_no) != val) {
-                state_packer.set(buffer, var_no, val);
-                queue.push_back(rule.effect_literal);
-            }
-        }
+        if (rule.condition_count == 0)
+            fire_rule(rule, buffer, state_packer);
     }
 
     for (size_t layer_no = 0; layer_no < nbf_info_by_layer.size(); ++layer_no) {
-        // Apply Horn rules.
-        while (!queue.empty()) {
-            AxiomLiteral *curr_literal = queue.back();
-            queue.pop_back();
-            for (size_t i = 0; i < curr_literal->condition_of.size(); ++i) {
-                AxiomRule *rule = curr_literal->condition_of[i];
-                if (--rule->unsatisfied_conditions == 0) {
-                    int var_no = rule->effect_var;
-                    int val = rule->effect_val;
-                    if (state_packer.get(buffer, var_no) != val) {
-                        state_packer.set(buffer, var_no, val);
-                        queue.push_back(rule->effect_literal);
-                    }
-                }
-            }
-        }
+        propagate(buffer, state_packer);
 
         /*
           Apply negation by failure rules. Skip this in last iteration
@@ -148,3 +259,81 @@ void AxiomEvaluator::evaluate(PackedStateBin *buffer,
         }
     }
 }
+
+void AxiomEvaluator::evaluate_affected(
+    const AffectedAxioms &affected, PackedStateBin *buffer,
+    const int_packer::IntPacker &state_packer) {
+    assert(queue.empty());
+    for (int var_no : affected.derived_vars)
+        state_packer.set(buffer, var_no, default_values[var_no]);
+
+    /*
+      The unaffected variables already hold their final values, so the
+      conditions on them are tested once. The conditions on affected
+      variables are satisfied by propagation as in the full evaluation.
+    */
+    for (const AffectedRule &affected_rule : affected.rules) {
+        AxiomRule &rule = rules[affected_rule.rule_no];
+        int unsatisfied = affected_rule.num_affected_conditions;
+        for (int i = affected_rule.conditions_begin;
+             i < affected_rule.conditions_end; ++i) {
+            const FactPair &condition = affected.checked_conditions[i];
+            if (state_packer.get(buffer, condition.var) != condition.value)
+                ++unsatisfied;
+        }
+        rule.unsatisfied_conditions = unsatisfied;
+        if (unsatisfied == 0)
+            fire_rule(rule, buffer, state_packer);
+    }
+
+    for (size_t layer_no = 0; layer_no < affected.nbf_info_by_layer.size(); ++layer_no) {
+        propagate(buffer, state_packer);
+        for (const NegationByFailureInfo &info : affected.nbf_info_by_layer[layer_no]) {
+            if (state_packer.get(buffer, info.var_no) == default_values[info.var_no])
+                queue.push_back(info.literal);
+        }
+    }
+    assert(queue.empty());
+}
+
+void AxiomEvaluator::evaluate_successor(
+    PackedStateBin *buffer, const int_packer::IntPacker &state_packer,
+    int op_no) {
+    if (!task_has_axioms)
+        return;
+    int index = affected_axioms_by_operator[op_no];
+    if (index == -1) {
+        evaluate(buffer, state_packer);
+        return;
+    }
+    bool validate_state = validation_interval > 0 &&
+        ++evaluations_since_validation == validation_interval;
+    if (validate_state) {
+        evaluations_since_validation = 0;
+        validation_buffer.assign(buffer, buffer + state_packer.get_num_bins());
+    }
+    evaluate_affected(affected_axioms[index], buffer, state_packer);
+    if (validate_state)
+        validate(buffer, state_packer);
+}
+
+void AxiomEvaluator::validate(const PackedStateBin *buffer,
+                              const int_packer::IntPacker &state_packer) {
+    evaluate(validation_buffer.data(), state_packer);
+    for (size_t var_no = 0; var_no < default_values.size(); ++var_no) {
+        int value = state_packer.get(buffer, var_no);
+        int expected = state_packer.get(validation_buffer.data(), var_no);
+        if (value != expected) {
+            cerr << "Incremental axiom evaluation set variable " << var_no
+                 << " to " << value << ", full evaluation to " << expected
+                 << endl;
+            utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+        }
+    }
+}
+
+void AxiomEvaluator::set_validation_interval(int interval) {
+    assert(interval >= 0);
+    validation_interval = interval;
+    evaluations_since_validation = 0;
+}
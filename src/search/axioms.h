@@ -33,6 +33,30 @@ class AxiomEvaluator {
         NegationByFailureInfo(int var, AxiomLiteral *lit)
             : var_no(var), literal(lit) {}
     };
+    /*
+      An axiom rule whose effect variable depends on the effects of an
+      operator. Its conditions on affected variables are unsatisfied
+      when the evaluation starts. The others (conditions_begin to
+      conditions_end in checked_conditions) are tested in the state.
+    */
+    struct AffectedRule {
+        int rule_no;
+        int num_affected_conditions;
+        int conditions_begin;
+        int conditions_end;
+    };
+    /*
+      The derived variables that can change when an operator with a given
+      set of effect variables is applied, i.e., those that depend on the
+      effect variables through the axiom rules, and the rules that derive
+      them. All other derived variables keep the value of the predecessor.
+    */
+    struct AffectedAxioms {
+        std::vector<int> derived_vars;
+        std::vector<AffectedRule> rules;
+        std::vector<FactPair> checked_conditions;
+        std::vector<std::vector<NegationByFailureInfo>> nbf_info_by_layer;
+    };
 
     bool task_has_axioms;
 
@@ -57,9 +81,43 @@ class AxiomEvaluator {
       to reduce reallocation effort. See issue420.
     */
     std::vector<AxiomLiteral *> queue;
+
+    std::vector<AffectedAxioms> affected_axioms;
+    // Index into affected_axioms for each operator, -1 for operators that
+    // affect so many rules that evaluating all axioms is cheaper.
+    std::vector<int> affected_axioms_by_operator;
+
+    // Every validation_interval-th incremental evaluation is compared to
+    // a full evaluation. 0 disables the validation.
+    int validation_interval;
+    int evaluations_since_validation;
+    std::vector<PackedStateBin> validation_buffer;
+
+    void compute_affected_axioms(
+        const TaskProxy &task_proxy,
+        const std::vector<std::vector<FactPair>> &rule_conditions);
+    void fire_rule(AxiomRule &rule, PackedStateBin *buffer,
+                   const int_packer::IntPacker &state_packer);
+    void propagate(PackedStateBin *buffer,
+                   const int_packer::IntPacker &state_packer);
+    void evaluate_affected(const AffectedAxioms &affected,
+                           PackedStateBin *buffer,
+                           const int_packer::IntPacker &state_packer);
+    void validate(const PackedStateBin *buffer,
+                  const int_packer::IntPacker &state_packer);
 public:
     explicit AxiomEvaluator(const TaskProxy &task_proxy);
     void evaluate(PackedStateBin *buffer, const int_packer::IntPacker &state_packer);
+    /*
+      Evaluates the axioms in the successor that results from applying the
+      operator with index op_no. The buffer must hold the derived values of
+      the predecessor. Only the derived variables that depend on the
+      effects of the operator are recomputed.
+    */
+    void evaluate_successor(PackedStateBin *buffer,
+                            const int_packer::IntPacker &state_packer,
+                            int op_no);
+    void set_validation_interval(int interval);
 };
 
 #endif
@@ -0,0 +1,21 @@
+#include "evaluation_batch.h"
+
+#include "global_state.h"
+#include "heuristic.h"
+#include "search_statistics.h"
+
+using namespace std;
+
+EvaluationBatch::EvaluationBatch(const set<Heuristic *> &heuristics)
+    : heuristics(heuristics.begin(), heuristics.end()),
+      values(heuristics.size()) {
+}
+
+void EvaluationBatch::evaluate(const vector<GlobalState> &states,
+                               SearchStatistics *statistics) {
+    for (size_t i = 0; i < heuristics.size(); ++i) {
+        heuristics[i]->compute_values(states, values[i]);
+        if (statistics)
+            statistics->inc_evaluations(states.size());
+    }
+}
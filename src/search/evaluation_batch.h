@@ -0,0 +1,48 @@
+#ifndef EVALUATION_BATCH_H
+#define EVALUATION_BATCH_H
+
+#include <cstddef>
+#include <set>
+#include <vector>
+
+class Evaluator;
+class GlobalState;
+class Heuristic;
+class SearchStatistics;
+
+/*
+  Heuristic values for a batch of states, e.g. the successors of an
+  expanded state. Each heuristic evaluates the whole batch with one call
+  to compute_values, which allows it to interleave the work for
+  independent states. Evaluation contexts created for states of the batch
+  look up these values instead of calling the heuristics again.
+
+  A batch is filled and read by one thread at a time.
+*/
+class EvaluationBatch {
+    std::vector<Evaluator *> heuristics;
+    // values[i][j]: estimate of heuristics[i] for the j-th state
+    std::vector<std::vector<int>> values;
+public:
+    explicit EvaluationBatch(const std::set<Heuristic *> &heuristics);
+
+    void evaluate(const std::vector<GlobalState> &states,
+                  SearchStatistics *statistics);
+
+    /*
+      Sets value to the estimate of evaluator for the state with the given
+      index in the last evaluated batch. Returns false if the evaluator is
+      not a heuristic of this batch.
+    */
+    bool lookup(const Evaluator *evaluator, int index, int &value) const {
+        for (std::size_t i = 0; i < heuristics.size(); ++i) {
+            if (evaluator == heuristics[i]) {
+                value = values[i][index];
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif
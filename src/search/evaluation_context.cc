@@ -7,6 +7,8 @@
 #include <cassert>
 
 #ifdef EXTERNAL_SEARCH
+#include "evaluation_batch.h"
+
 // this is to access GlobalState.get_g(), to prevent unnecessary storing of
 // g value in EvaluationContext as GlobalState stores its own g value
 #include "global_state.h"
@@ -20,10 +22,25 @@ EvaluationContext::EvaluationContext(const GlobalState &state,
                                      SearchStatistics *statistics,
                                      bool calculate_preferred)
     : state(state),
+      batch(nullptr),
+      batch_index(-1),
       preferred(is_preferred),
       statistics(statistics),
       calculate_preferred(calculate_preferred) {
 }
+
+EvaluationContext::EvaluationContext(const EvaluationBatch &batch,
+                                     int batch_index,
+                                     const GlobalState &state,
+                                     bool is_preferred,
+                                     SearchStatistics *statistics)
+    : state(state),
+      batch(&batch),
+      batch_index(batch_index),
+      preferred(is_preferred),
+      statistics(statistics),
+      calculate_preferred(false) {
+}
 #else
 EvaluationContext::EvaluationContext(
     const HeuristicCache &cache, int g_value, bool is_preferred,
@@ -50,6 +67,14 @@ EvaluationContext::EvaluationContext(
 
 #ifdef EXTERNAL_SEARCH
 EvaluationResult EvaluationContext::get_result(Evaluator *heur) {
+    int batch_value;
+    if (batch && batch->lookup(heur, batch_index, batch_value)) {
+        // counted when the batch was evaluated
+        EvaluationResult result;
+        result.set_h_value(batch_value);
+        result.set_count_evaluation(false);
+        return result;
+    }
     EvaluationResult result = heur->compute_result(*this);
     if (statistics && dynamic_cast<const Heuristic *>(heur)) {
         /* Only count evaluations of actual Heuristics, not arbitrary
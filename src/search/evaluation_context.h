@@ -11,6 +11,7 @@
 
 #include <unordered_map>
 
+class EvaluationBatch;
 class Evaluator;
 class GlobalState;
 class SearchStatistics;
@@ -53,6 +54,8 @@ class SearchStatistics;
 class EvaluationContext {
 #ifdef EXTERNAL_SEARCH
     const GlobalState &state;
+    const EvaluationBatch *batch;
+    int batch_index;
 #else
     HeuristicCache cache;
     int g_value;
@@ -69,6 +72,13 @@ public:
                       bool is_preferred,
                       SearchStatistics *statistics,
                       bool calculate_preferred = false);
+    /*
+      Evaluation context for the state with the given index in an
+      evaluated batch. Heuristic values are taken from the batch.
+    */
+    EvaluationContext(const EvaluationBatch &batch, int batch_index,
+                      const GlobalState &state, bool is_preferred,
+                      SearchStatistics *statistics);
 #else
     /*
       Copy existing heuristic cache and use it to look up heuristic values.
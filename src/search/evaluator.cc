@@ -1,5 +1,7 @@
 #include "evaluator.h"
 
+#include "evaluation_context.h"
+#include "global_state.h"
 #include "plugin.h"
 
 using namespace std;
@@ -9,6 +11,23 @@ bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+bool Evaluator::supports_concurrent_evaluation() const {
+    return false;
+}
+
+void Evaluator::compute_values(const vector<GlobalState> &states,
+                               vector<int> &values) {
+    values.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+#ifdef EXTERNAL_SEARCH
+        EvaluationContext eval_context(states[i], false, nullptr);
+#else
+        EvaluationContext eval_context(states[i]);
+#endif
+        values[i] = eval_context.get_heuristic_value_or_infinity(this);
+    }
+}
+
 
 static PluginTypePlugin<Evaluator> _type_plugin(
     "Evaluator",
@@ -4,8 +4,10 @@
 #include "evaluation_result.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
+class GlobalState;
 class Heuristic;
 
 class Evaluator {
@@ -21,6 +23,18 @@ public:
     */
     virtual bool dead_ends_are_reliable() const;
 
+    /*
+      supports_concurrent_evaluation should return true if several
+      threads may call compute_result and compute_values at the same
+      time. Implementations must only read their members while
+      evaluating states: scratch space, caches, random number generators
+      or statistics kept in the evaluator rule this out. An evaluator
+      built from others may only return true if all of them do.
+
+      The default implementation returns false.
+    */
+    virtual bool supports_concurrent_evaluation() const;
+
     /*
       get_involved_heuristics should insert all heuristics that this
       evaluator directly or indirectly depends on into the result set,
@@ -56,6 +70,19 @@ public:
     */
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) = 0;
+
+    /*
+      compute_values evaluates a batch of states, e.g. all successors of
+      an expanded state, and stores the estimate for states[i] in
+      values[i] (EvaluationResult::INFTY for dead ends). No preferred
+      operators are computed.
+
+      The default implementation evaluates the states one by one with
+      compute_result. Heuristics can override it to work on all states
+      at once, e.g. to interleave independent table lookups.
+    */
+    virtual void compute_values(const std::vector<GlobalState> &states,
+                                std::vector<int> &values);
 };
 
 #endif
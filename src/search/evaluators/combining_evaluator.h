@@ -36,6 +36,7 @@ public:
     */
 
     virtual bool dead_ends_are_reliable() const override;
+    virtual bool supports_concurrent_evaluation() const override;
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
     virtual void get_involved_heuristics(std::set<Heuristic *> &hset) override;
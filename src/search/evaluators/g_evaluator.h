@@ -11,6 +11,10 @@ public:
     GEvaluator() = default;
     virtual ~GEvaluator() override = default;
 
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
+
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
 
@@ -5,6 +5,7 @@
 #include <utility>
 #include "../global_state.h"
 #include "../global_operator.h"
+#include "../utils/system.h"
 
 using found = bool;
 using reopened = bool;
@@ -20,6 +21,10 @@ class ClosedList {
         trace_path(const Entry &entry) const = 0;
     virtual void clear() = 0;
     virtual void print_statistics() const = 0;
+
+    // Moves every entry into other, leaving this closed list empty. Used by
+    // search engines that switch closed list representation mid-search.
+    virtual void transfer_to(ClosedList<Entry> &other);
 };
 
 using StateClosedListEntry = GlobalState;
@@ -30,4 +35,11 @@ ClosedList<Entry>::ClosedList(bool reopen_closed)
 : reopen_closed(reopen_closed) {
 }
 
+template<class Entry>
+void ClosedList<Entry>::transfer_to(ClosedList<Entry> &) {
+    std::cerr << "Closed list does not support transferring its entries"
+              << std::endl;
+    utils::exit_with(utils::ExitCode::UNSUPPORTED);
+}
+
 #endif
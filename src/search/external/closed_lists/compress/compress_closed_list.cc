@@ -9,6 +9,7 @@
 #include "../../../utils/memory.h"
 #include "../../../globals.h"
 #include "../../hash_functions/state_hash.h"
+#include "../../hash_functions/tabulation.h"
 #include "../../hash_functions/zobrist.h"
 #include "../../utils/errors.h"
 #include "../../utils/named_fstream.h"
@@ -98,16 +99,19 @@ namespace compress_closed_list {
         // set max buffer entries
         max_buffer_entries = max_buffer_size_in_bytes / Entry::get_size_in_bytes();
 
-        // initialize primary hash
-        Entry::initialize_hash_function(utils::make_unique_ptr<ZobristHash<Entry> >());
+        // initialize primary hash, unless a previous closed list already did:
+        // parent hash values of existing nodes must remain valid
+        if (!Entry::has_hash_function())
+            Entry::initialize_hash_function(utils::make_unique_ptr<ZobristHash<Entry> >());
         
         // initialize partition table
         if (enable_partitioning) {
             partition_table =
                 utils::make_unique_ptr<MappingTable>(max_buffer_entries);
 
+            // computed from scratch for every lookup, so hash packed bytes
             partition_hash =
-                utils::make_unique_ptr<ZobristHash<Entry> >();
+                utils::make_unique_ptr<TabulationHash<Entry> >();
            
             buffers.resize(n_partitions);
         } else {
@@ -145,6 +149,7 @@ namespace compress_closed_list {
     template<class Entry>
     CompressClosedList<Entry>::CompressClosedList(const Options &opts)
         : ClosedList<Entry>(opts.get<bool>("reopen_closed")),
+        reopen_closed(opts.get<bool>("reopen_closed")),
         enable_partitioning(opts.get<bool>("enable_partitioning")),
         double_hashing(opts.get<bool>("double_hashing")) 
     {
@@ -153,10 +158,12 @@ namespace compress_closed_list {
         if (enable_partitioning)
             cout << "with " << n_partitions << " partitions ";
         if (double_hashing) {
-            cout << "with double hashing\n";
+            cout << "with double hashing ";
         } else {
-            cout << "with linear probing\n";
+            cout << "with linear probing ";
         }
+        cout << (reopen_closed ? "with" : "without")
+             << " reopening of closed nodes\n";
         cout << "Maximum capacity (entries) of closed list: "
              << internal_closed.get_max_entries()
              << endl;
@@ -0,0 +1,167 @@
+#include "in_memory_closed_list.h"
+
+#include "../../closed_list.h"
+#include "../../../option_parser.h"
+#include "../../../plugin.h"
+#include "../../../global_operator.h"
+#include "../../../utils/memory.h"
+#include "../../../utils/system.h"
+#include "../../../globals.h"
+#include "../../hash_functions/zobrist.h"
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+
+using namespace std;
+using namespace statehash;
+
+using found = bool;
+using reopened = bool;
+
+/*                                                                      \
+| Closed list that keeps every node in RAM. Intended as the first stage |
+| of search engines that later move their nodes into an external closed |
+| list (see transfer_to), so it shares the primary hash function with   |
+| them instead of using its own.                                        |
+\======================================================================*/
+
+namespace in_memory_closed_list {
+    template<class Entry>
+    class InMemoryClosedList : public ClosedList<Entry> {
+        bool reopen_closed;
+
+        unordered_set<Entry> closed;
+
+        bool initialized = false; // lazy initialization
+
+        size_t hits = 0;
+
+        void initialize();
+
+    public:
+        explicit InMemoryClosedList(const Options &opts);
+        virtual ~InMemoryClosedList() override = default;
+
+        virtual pair<found, reopened> find_insert(const Entry &entry) override;
+        virtual vector<const GlobalOperator*> trace_path(const Entry &entry)
+            const override;
+
+        virtual void clear() override;
+        virtual void print_statistics() const override;
+        virtual void transfer_to(ClosedList<Entry> &other) override;
+    };
+
+    template<class Entry>
+    InMemoryClosedList<Entry>::InMemoryClosedList(const Options &opts)
+        : ClosedList<Entry>(opts.get<bool>("reopen_closed")),
+        reopen_closed(opts.get<bool>("reopen_closed")) {
+        cout << "Using in-memory closed list" << endl;
+    }
+
+    // Hash function can only be created once variable domains are known.
+    template<class Entry>
+    void InMemoryClosedList<Entry>::initialize() {
+        if (!Entry::has_hash_function())
+            Entry::initialize_hash_function(utils::make_unique_ptr<ZobristHash<Entry> >());
+        initialized = true;
+    }
+
+    template<class Entry>
+    pair<found, reopened> InMemoryClosedList<Entry>::
+    find_insert(const Entry &entry) {
+        if (!initialized) initialize();
+
+        auto it = closed.find(entry);
+        if (it != closed.end()) {
+            ++hits;
+            if (reopen_closed) {
+                if (entry.get_g() < it->get_g()) {
+                    closed.erase(it);
+                    closed.insert(entry);
+                    return make_pair(true, true);
+                }
+            }
+            return make_pair(true, false);
+        }
+        closed.insert(entry);
+        return make_pair(false, false);
+    }
+
+    template<class Entry>
+    vector<const GlobalOperator *> InMemoryClosedList<Entry>::
+    trace_path(const Entry &entry) const {
+        // Nodes are hashed by state, so index them by id for the backward walk
+        unordered_map<StateID, const Entry *> nodes_by_id;
+        nodes_by_id.reserve(closed.size());
+        for (auto &node : closed)
+            nodes_by_id[node.get_state_id()] = &node;
+
+        vector<const GlobalOperator *> path;
+        const Entry *current_state = &entry;
+        while (current_state->get_creating_operator() != -1) {
+            path.push_back(&g_operators[current_state->get_creating_operator()]);
+            auto parent = nodes_by_id.find(current_state->get_parent_state_id());
+            if (parent == nodes_by_id.end()) {
+                // the parent of a closed node is always closed before it
+                cerr << "Parent of a closed node is missing from the "
+                     << "closed list" << endl;
+                utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+            }
+            current_state = parent->second;
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    template<class Entry>
+    void InMemoryClosedList<Entry>::transfer_to(ClosedList<Entry> &other) {
+        // erase while transferring so that peak memory does not grow further
+        auto it = closed.begin();
+        while (it != closed.end()) {
+            other.find_insert(*it);
+            it = closed.erase(it);
+        }
+        unordered_set<Entry>().swap(closed); // release bucket array
+    }
+
+    template<class Entry>
+    void InMemoryClosedList<Entry>::clear() {
+        unordered_set<Entry>().swap(closed);
+    }
+
+    template<class Entry>
+    void InMemoryClosedList<Entry>::print_statistics() const {
+        cout << "Number of entries in the in-memory closed list: "
+             << closed.size()
+             << "\nIn-memory closed list hits: " << hits << endl;
+    }
+
+    InMemoryClosedListFactory::
+    InMemoryClosedListFactory(const Options &options)
+        : options(options) {
+    }
+
+    unique_ptr<StateClosedList>
+    InMemoryClosedListFactory::create_state_closed_list() {
+        return utils::make_unique_ptr
+            <InMemoryClosedList<StateClosedListEntry> >(options);
+    }
+
+    static shared_ptr<ClosedListFactory> _parse(OptionParser &parser) {
+        parser.document_synopsis("In-memory closed list", "");
+        parser.add_option<bool>(
+                                "reopen_closed",
+                                "reopen closed nodes with lower g values");
+        Options opts = parser.parse();
+        if (parser.dry_run())
+            return nullptr;
+        else
+            return make_shared<InMemoryClosedListFactory>(opts);
+    }
+
+    static PluginShared<ClosedListFactory> _plugin("in_memory", _parse);
+}
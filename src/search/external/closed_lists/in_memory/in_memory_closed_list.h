@@ -0,0 +1,19 @@
+#ifndef EXTERNAL_CLOSED_LISTS_IN_MEMORY_H
+#define EXTERNAL_CLOSED_LISTS_IN_MEMORY_H
+
+#include "../../closed_list_factory.h"
+#include "../../../option_parser_util.h"
+
+namespace in_memory_closed_list {
+    class InMemoryClosedListFactory : public ClosedListFactory {
+        Options options;
+    public:
+        explicit InMemoryClosedListFactory(const Options &options);
+        virtual ~InMemoryClosedListFactory() override = default;
+
+        virtual std::unique_ptr<StateClosedList>
+            create_state_closed_list() override;
+    };
+}
+
+#endif
@@ -15,6 +15,15 @@ namespace statehash {
         virtual ~StateHash() {};
         // returns hash value
         virtual std::size_t operator()(const Entry& entry) const = 0;
+
+        // Whether hash values can be updated one variable at a time
+        virtual bool is_incremental() const { return false; }
+        // Hash value after var changes from old_value to new_value, only
+        // defined for incremental hash functions
+        virtual std::size_t update(std::size_t hash_value, int /*var*/,
+                                   int /*old_value*/, int /*new_value*/) const {
+            return hash_value;
+        }
     };      
 }
 
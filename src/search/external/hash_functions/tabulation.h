@@ -0,0 +1,77 @@
+#ifndef TABULATION_H
+#define TABULATION_H
+
+#include "../../utils/memory.h"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "state_hash.h"
+
+// Simple tabulation hashing over the bytes of the packed state.
+// ZobristHash tabulates over variables and has to unpack every variable
+// through the int packer. This hash reads the packed bins directly and looks
+// up one contiguous table with a row of 256 bitstrings per byte. Like Zobrist
+// hashing it is 3-independent, and every instance draws its own table, so
+// e.g. the primary and the partition hash of the compress closed list stay
+// independent of each other. It cannot be updated incrementally, since a
+// byte may hold bits of several variables.
+namespace statehash {
+    template<class Entry>
+    class TabulationHash : public StateHash<Entry> {
+        // shared by all instances, so that each draws different bitstrings
+        static std::unique_ptr<std::mt19937_64> mt_ptr;
+
+        std::size_t num_bytes;
+        std::vector<std::size_t> table; // num_bytes rows of 256 bitstrings
+
+    public:
+        TabulationHash();
+
+        std::size_t operator()(const Entry& entry) const override;
+    };
+
+    template<class Entry>
+    std::unique_ptr<std::mt19937_64> TabulationHash<Entry>::mt_ptr = nullptr;
+
+    // Requires the size of packed states to be known, i.e. the task loaded.
+    template<class Entry>
+    TabulationHash<Entry>::TabulationHash()
+        : num_bytes(Entry::get_packedState_bytes()),
+          table(num_bytes * 256) {
+        if (!mt_ptr) {
+            // fixed seed, different from the one used for Zobrist hashing
+            std::seed_seq seq {2};
+            mt_ptr = utils::make_unique_ptr<std::mt19937_64>(std::mt19937_64(seq));
+        }
+        std::uniform_int_distribution<std::size_t>
+            dis(0, std::numeric_limits<std::size_t>::max());
+        for (auto& val : table) {
+            val = dis(*mt_ptr);
+        }
+    }
+
+    template<class Entry>
+    std::size_t TabulationHash<Entry>::operator()(const Entry& entry) const {
+        const unsigned char *bytes =
+            reinterpret_cast<const unsigned char *>(entry.get_packed_buffer());
+        const std::size_t *row = table.data();
+        // four independent lookups per iteration to keep the loads in flight
+        std::size_t h0 = 0, h1 = 0, h2 = 0, h3 = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= num_bytes; i += 4, row += 4 * 256) {
+            h0 ^= row[bytes[i]];
+            h1 ^= row[256 + bytes[i + 1]];
+            h2 ^= row[2 * 256 + bytes[i + 2]];
+            h3 ^= row[3 * 256 + bytes[i + 3]];
+        }
+        for (; i < num_bytes; ++i, row += 256) {
+            h0 ^= row[bytes[i]];
+        }
+        return h0 ^ h1 ^ h2 ^ h3;
+    }
+}
+#endif
@@ -34,12 +34,29 @@ namespace statehash {
 
         size_t get_rand_bitstring() const;
 
-        std::vector< std::vector<size_t> > table;
+        // bitstrings of all values of all variables, stored contiguously
+        std::vector<std::size_t> table;
+        // index of the first value of each variable in table, plus the end
+        std::vector<std::size_t> var_offsets;
         
     public:
         ZobristHash();
         
         std::size_t operator()(const Entry& entry) const override; // hash value
+
+        // The twisted variant mixes the last variable with the hash of the
+        // others, so only plain Zobrist hashing can be updated incrementally
+#ifdef TWISTED
+        bool is_incremental() const override { return false; }
+#else
+        bool is_incremental() const override { return true; }
+#endif
+        std::size_t update(std::size_t hash_value, int var,
+                           int old_value, int new_value) const override {
+            std::size_t offset = var_offsets[var];
+            return hash_value ^ table[offset + old_value] ^
+                table[offset + new_value];
+        }
     };
 
     template<class Entry>
@@ -76,17 +93,17 @@ namespace statehash {
             mt_ptr = utils::make_unique_ptr<std::mt19937_64>(std::mt19937_64(seq));
         }
         
-        // resize table to match dimensions of variables and their  values
-        table.resize(g_variable_domain.size());
-        for (std::size_t i = 0; i < table.size(); ++i) {
-            table[i].resize(g_variable_domain[i]);
+        // one bitstring for every value of every variable
+        var_offsets.resize(g_variable_domain.size() + 1);
+        var_offsets[0] = 0;
+        for (std::size_t i = 0; i < g_variable_domain.size(); ++i) {
+            var_offsets[i + 1] = var_offsets[i] + g_variable_domain[i];
         }
 
         // fill table with random bitstrings (64 bit)
-        for (auto& var : table) {
-            for (auto& val : var) {
-                val = get_rand_bitstring();
-            }
+        table.resize(var_offsets.back());
+        for (auto& val : table) {
+            val = get_rand_bitstring();
         }
         // Use of g_variable_domain creates dependency on globals.
         // Consider moving these to static values in Entry class?
@@ -100,16 +117,19 @@ namespace statehash {
     template<class Entry>
     std::size_t ZobristHash<Entry>::operator()(const Entry& entry) const {
         std::size_t hash_value = 0;
+        const std::size_t num_vars = var_offsets.size() - 1;
 #ifdef TWISTED
         std::size_t i = 0;
-        for (; i < table.size() - 1; ++i) {
-            hash_value ^= table[i][entry[i]];
+        for (; i < num_vars - 1; ++i) {
+            hash_value ^= table[var_offsets[i] + entry[i]];
         }
         
-        hash_value ^= table[i][(entry[i] ^ hash_value) % table[i].size()];
+        std::size_t domain_size = var_offsets[i + 1] - var_offsets[i];
+        hash_value ^= table[var_offsets[i] +
+                            (entry[i] ^ hash_value) % domain_size];
 #else
-        for (std::size_t i = 0; i < table.size(); ++i) {
-            hash_value ^= table[i][entry[i]];
+        for (std::size_t i = 0; i < num_vars; ++i) {
+            hash_value ^= table[var_offsets[i] + entry[i]];
         }
 #endif
         return hash_value;
@@ -6,6 +6,7 @@
 
 #include "../../utils/memory.h"
 
+#include "../utils/block_reader.h"
 #include "../utils/named_fstream.h"
 #include "../utils/errors.h"
 #include "../utils/compunits.h"
@@ -152,8 +153,8 @@ namespace astar_ddd_open_list {
             next_buckets[i]->clear();
             next_buckets[i]->seekg(0, ios::beg);
             Entry next_entry;
-            next_entry.read(*next_buckets[i]);
-            while (!next_buckets[i]->eof()) {
+            BlockReader<Entry> next_reader(*next_buckets[i]);
+            while (next_reader.read(next_entry)) {
                 auto it = hash_table.find(next_entry);
                 if (it != hash_table.end()) {
                     if (it->get_g() > next_entry.get_g()) {
@@ -163,10 +164,9 @@ namespace astar_ddd_open_list {
                 } else {
                     hash_table.insert(next_entry);
                 }
-                next_entry.read(*next_buckets[i]);
             }
 
-            size_t bucket_size_in_bytes = hash_table.size() * sizeof(Entry);
+            size_t bucket_size_in_bytes = hash_table.size() * Entry::get_memory_in_bytes();
             if (bucket_size_in_bytes > max_bucket_size_in_bytes)
                 max_bucket_size_in_bytes = bucket_size_in_bytes;
             next_buckets[i].reset(nullptr);
@@ -179,13 +179,12 @@ namespace astar_ddd_open_list {
             closed_buckets[i]->clear();
             closed_buckets[i]->seekg(0, ios::beg);
             Entry closed_entry;
-            closed_entry.read(*closed_buckets[i]);
-            while (!closed_buckets[i]->eof()) {
+            BlockReader<Entry> closed_reader(*closed_buckets[i]);
+            while (closed_reader.read(closed_entry)) {
                 auto it = hash_table.find(closed_entry);
                 if (it != hash_table.end()) {
                     hash_table.erase(it);
                 }
-                closed_entry.read(*closed_buckets[i]);
             }
             closed_buckets[i]->clear();
             closed_buckets[i]->seekg(0, ios::end);
@@ -465,14 +464,13 @@ namespace astar_ddd_open_list {
             closed_buckets[bucket_index]->seekg(0, ios::beg);
 
             Entry closed_entry;
-            closed_entry.read(*closed_buckets[bucket_index]);
-            while (!closed_buckets[bucket_index]->eof()) {
+            BlockReader<Entry> closed_reader(*closed_buckets[bucket_index]);
+            while (closed_reader.read(closed_entry)) {
                 if (closed_entry.get_state_id() ==
                     current_state.get_parent_state_id()) {
                     current_state = closed_entry;
                     goto startloop;
                 }
-                closed_entry.read(*closed_buckets[bucket_index]);
             }
             break; // parent not found
         }
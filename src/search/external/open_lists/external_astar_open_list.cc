@@ -6,12 +6,15 @@
 
 #include "../../utils/memory.h"
 
+#include "../utils/block_reader.h"
+#include "../utils/block_writer.h"
 #include "../utils/named_fstream.h"
 #include "../utils/errors.h"
 #include "../utils/compunits.h"
 
 #include "../../global_operator.h"
 #include "../../globals.h" // for g_operator
+#include "../../utils/parallel.h"
 
 #include <utility>
 #include <map>
@@ -19,6 +22,8 @@
 #include <string>
 #include <memory>
 #include <deque>
+#include <iterator>
+#include <algorithm>
 
 // for constructing directory
 #include <sys/types.h>
@@ -28,6 +33,8 @@ using namespace std;
 using namespace compunits;
 
 const size_t MERGE_CHUNK_BYTES = 900_MiB;
+// per thread; smaller blocks and buckets are sorted and merged serially
+const size_t MIN_PARALLEL_ENTRIES = 1 << 12;
 // #define TEST_EXTERNALASTAR_DDD
 
 // This only works on unit cost domains! Otherwise behavior is undefined.
@@ -36,15 +43,45 @@ namespace external_astar_open_list {
     template<class Entry>
     class ExternalAStarOpenList : public OpenList<Entry> {
 
-        map<int, map<int, named_fstream> > fg_buckets;
+        using Buckets = map<int, map<int, named_fstream> >;
+
+        Buckets fg_buckets;
+        // Successors inserted concurrently, one set of buckets per thread.
+        // They are folded into fg_buckets when their bucket is sorted.
+        vector<Buckets> thread_fg_buckets;
         pair<int, int> current_fg; // to track when merge needs to be performed
         vector<Evaluator *> evaluators; // f, h
+        const int num_threads;
+        // compress deduplicated buckets, which are sorted
+        const bool compress;
+        // scan over the bucket current_fg
+        unique_ptr<BlockReader<Entry> > bucket_reader;
         void remove_duplicates(int f, int g);
         bool first_insert = true; // to initialize current_fg
 
+        int get_f_value(EvaluationContext &eval_context);
+        void register_thread_buckets();
+        void flush_block(vector<Entry> &block, fstream &sorted_blocks,
+                         vector<streampos> &k_offsets) const;
+        void merge_runs(fstream &sorted_blocks,
+                        vector<streampos> current_k_offsets,
+                        const vector<streampos> &k_offsets,
+                        vector<BlockReader<Entry> *> duplicate_readers,
+                        fstream &target_stream) const;
+        void parallel_merge_runs(fstream &sorted_blocks,
+                                 const string &sorted_blocks_name,
+                                 const vector<streampos> &k_begins,
+                                 const vector<streampos> &k_offsets,
+                                 const vector<string> &duplicate_names,
+                                 int f, int g, fstream &target_stream) const;
+        streampos lower_bound(fstream &file, streampos begin, streampos end,
+                              const Entry &key) const;
+
         bool exists_bucket(int f, int g) const;
+        bool is_deduplicated_bucket(int f, int g) const;
         void create_bucket(int f, int g);
-        string get_bucket_string(int f, int g) const;
+        string get_bucket_string(int f, int g,
+                                 const string &suffix = "") const;
 
     protected:
         virtual void do_insertion(EvaluationContext &eval_context,
@@ -55,6 +92,11 @@ namespace external_astar_open_list {
         virtual ~ExternalAStarOpenList() override = default;
 
         virtual Entry remove_min() override;
+        virtual void remove_min_batch(vector<Entry> &batch,
+                                      size_t max_entries) override;
+        virtual void insert_concurrently(int thread_index,
+                                         EvaluationContext &eval_context,
+                                         const Entry &entry) override;
         virtual void clear() override;
         virtual bool empty() const override;
         virtual void get_involved_heuristics(set<Heuristic *> &hset) override;
@@ -67,8 +109,13 @@ namespace external_astar_open_list {
     template<class Entry>
     ExternalAStarOpenList<Entry>::ExternalAStarOpenList(const Options &opts)
         : OpenList<Entry>(false), //opts.get<bool>("pref_only")),
-        evaluators(opts.get_list<Evaluator *>("evals"))
+        evaluators(opts.get_list<Evaluator *>("evals")),
+        num_threads(opts.get<int>("threads", 1)),
+        compress(opts.get<bool>("compress", false))
     {
+        thread_fg_buckets.resize(num_threads);
+        // parents are looked up by state id in the buckets of g - 1
+        Entry::set_parent_hash_value_stored(false);
         // create directory for open list files if not exist
         mkdir("open_list_buckets", 0744);
     }
@@ -80,192 +127,350 @@ namespace external_astar_open_list {
         // divided by the memory buffer allocated for one run (block).
         // Also performs duplicate detection against itself, and the buffers
         // f-1, g-1 and f-2, g-2, as per External A* (Edelkamp)
+        // Successors written by other threads are sorted along.
+
+        vector<named_fstream *> input_streams = {&fg_buckets[f][g]};
+        for (auto &buckets : thread_fg_buckets) {
+            auto f_bucket = buckets.find(f);
+            if (f_bucket == buckets.end()) continue;
+            auto g_bucket = f_bucket->second.find(g);
+            if (g_bucket != f_bucket->second.end())
+                input_streams.push_back(&g_bucket->second);
+        }
 
-        named_fstream * target_stream = &fg_buckets[f][g];
-        target_stream->clear();
-        target_stream->seekg(0, ios::beg);
-        
         vector<streampos> k_offsets; // keeps track of divisions in merge file
 
         // Allocate ~500mb for one block
-        size_t block_entries = MERGE_CHUNK_BYTES / (sizeof(Entry) + Entry::get_packedState_bytes()); // round down
+        size_t block_entries = MERGE_CHUNK_BYTES / Entry::get_memory_in_bytes(); // round down
         vector<Entry> block;
         block.reserve(block_entries);
-        
-        named_fstream sorted_blocks("temp.bucket");
- 
+
+        const string sorted_blocks_name = "temp.bucket";
+        named_fstream sorted_blocks(sorted_blocks_name);
+
         Entry entry;
-        entry.read(*target_stream);
-        while (!target_stream->eof()) {
-            block.push_back(entry);
-            // flush block if full
-            if (block.size() == block_entries) {
-                // sort
-                sort(block.begin(), block.end());
-                for (auto& blk_entry: block) {
-                    blk_entry.write(sorted_blocks);
-                }
-                k_offsets.push_back(sorted_blocks.tellg());
+        for (named_fstream *input_stream : input_streams) {
+            input_stream->clear();
+            input_stream->seekg(0, ios::beg);
+            BlockReader<Entry> reader(*input_stream);
+            while (reader.read(entry)) {
+                block.push_back(entry);
+                // flush block if full
+                if (block.size() == block_entries)
+                    flush_block(block, sorted_blocks, k_offsets);
             }
-            entry.read(*target_stream);
         }
         // flush remainder
-        sort(block.begin(), block.end());
-        for (auto& blk_entry : block) {
-            blk_entry.write(sorted_blocks);
-        }
-        k_offsets.push_back(sorted_blocks.tellg());
+        flush_block(block, sorted_blocks, k_offsets);
 
         vector<Entry>().swap(block); // clear block
-        fg_buckets[f].erase(g); // erase bucket to remove file
-        target_stream = nullptr;
-        
-        // Merge step
-        size_t buffer_entries = BUFFER_BYTES / Entry::get_size_in_bytes();
-        auto k_value = k_offsets.size();
-        vector< deque<Entry> > merge_buffers(k_value);
-
-        vector<streampos> current_k_offsets; //track increment to offsets
-        current_k_offsets.push_back(0);
-        current_k_offsets.insert(current_k_offsets.end(), k_offsets.begin(),
-                                 k_offsets.end() - 1);
+        // erase buckets to remove files
+        fg_buckets[f].erase(g);
+        for (auto &buckets : thread_fg_buckets) {
+            auto f_bucket = buckets.find(f);
+            if (f_bucket == buckets.end()) continue;
+            f_bucket->second.erase(g);
+            if (f_bucket->second.empty())
+                buckets.erase(f_bucket);
+        }
 
-        // initial fill of buffers
-        for (size_t k = 0; k < k_value; ++k) {
-            sorted_blocks.seekg(current_k_offsets[k]);
-            for (size_t i = 0; i < buffer_entries; ++i) {
-                if (sorted_blocks.tellg() >= k_offsets[k]) break; // end of block
-                Entry entry;
-                entry.read(sorted_blocks);
-                merge_buffers[k].push_back(entry);
-            }
-            current_k_offsets[k] = sorted_blocks.tellg();
+        const streamoff entry_bytes = Entry::get_size_in_bytes();
+        vector<streampos> k_begins;
+        size_t num_entries = 0;
+        streampos k_begin = 0;
+        for (streampos k_offset : k_offsets) {
+            k_begins.push_back(k_begin);
+            num_entries += (k_offset - k_begin) / entry_bytes;
+            k_begin = k_offset;
         }
 
         // For duplicate detection against other buckets
-        named_fstream* duplicate_stream_1 = nullptr;
-        Entry duplicate_entry_1;
-
-        named_fstream* duplicate_stream_2 = nullptr;
-        Entry duplicate_entry_2;
- 
-        if (exists_bucket(f-1, g-1)) {
-            duplicate_stream_1 = &(fg_buckets[f-1][g-1]);
-            duplicate_stream_1->clear();   
-            duplicate_stream_1->seekg(0, ios::beg);
-            duplicate_entry_1.read(*duplicate_stream_1);
-        }
-        if (exists_bucket(f-2, g-2)) {
-            duplicate_stream_2 = &(fg_buckets[f-2][g-2]);
-            duplicate_stream_2->clear();
-            duplicate_stream_2->seekg(0, ios::beg);
-            duplicate_entry_2.read(*duplicate_stream_2);
+        vector<fstream *> duplicate_streams;
+        vector<unique_ptr<BlockReader<Entry> > > duplicate_readers;
+        vector<string> duplicate_names;
+        for (int delta = 1; delta <= 2; ++delta) {
+            if (!exists_bucket(f - delta, g - delta)) continue;
+            named_fstream &duplicate_stream = fg_buckets[f - delta][g - delta];
+            duplicate_stream.clear();
+            duplicate_stream.seekg(0, ios::beg);
+            duplicate_streams.push_back(&duplicate_stream);
+            duplicate_readers.push_back(utils::make_unique_ptr<BlockReader<Entry> >(
+                                            duplicate_stream, compress));
+            duplicate_names.push_back(get_bucket_string(f - delta, g - delta));
         }
 
         // create output bucket to store non-duplicate entries
         create_bucket(f, g);
-        target_stream = &fg_buckets[f][g];
-        target_stream->clear();
-        target_stream->seekg(0, ios::beg);
-        
-        // output buffer
-        vector<Entry> output_buffer;
-        output_buffer.reserve(buffer_entries);
-        std::unique_ptr<Entry> previous_entry; // track intra bucket duplicates
-        
-        while (true) {
-            bool end_of_merge = true; // flag to terminate output step
+        named_fstream &target_stream = fg_buckets[f][g];
+        target_stream.clear();
+        target_stream.seekg(0, ios::beg);
+
+        if (num_threads > 1 &&
+            num_entries >= MIN_PARALLEL_ENTRIES * num_threads) {
+            sorted_blocks.flush();
+            for (fstream *duplicate_stream : duplicate_streams)
+                duplicate_stream->flush();
+            parallel_merge_runs(sorted_blocks, sorted_blocks_name, k_begins,
+                                k_offsets, duplicate_names, f, g,
+                                target_stream);
+        } else {
+            vector<BlockReader<Entry> *> readers;
+            for (auto &reader : duplicate_readers)
+                readers.push_back(reader.get());
+            merge_runs(sorted_blocks, k_begins, k_offsets, readers,
+                       target_stream);
+        }
 
+        target_stream.clear();
+        target_stream.seekg(0, ios::beg);
+    }
+
+    // Sorts the block and appends it to sorted_blocks. With several threads,
+    // the block is sorted in slices, each of which becomes a run of its own.
+    template<class Entry>
+    void ExternalAStarOpenList<Entry>::
+    flush_block(vector<Entry> &block, fstream &sorted_blocks,
+                vector<streampos> &k_offsets) const {
+        if (block.empty()) return;
+        int num_slices =
+            block.size() >= MIN_PARALLEL_ENTRIES * num_threads ? num_threads : 1;
+        vector<size_t> slice_begins(num_slices + 1);
+        for (int i = 0; i <= num_slices; ++i)
+            slice_begins[i] = block.size() * i / num_slices;
+
+        utils::run_in_parallel(num_slices, [&](int i) {
+                sort(block.begin() + slice_begins[i],
+                     block.begin() + slice_begins[i + 1]);
+            });
+
+        for (int i = 0; i < num_slices; ++i) {
+            if (!Entry::write_block(sorted_blocks, &block[slice_begins[i]],
+                                    slice_begins[i + 1] - slice_begins[i]))
+                throw IOException("Fail to write state to fstream.");
+            k_offsets.push_back(sorted_blocks.tellp());
+        }
+        block.clear();
+    }
+
+    // Merges the runs [current_k_offsets[k], k_offsets[k]) of sorted_blocks
+    // into target_stream. Entries equal to their predecessor or to an entry
+    // of one of the (sorted) duplicate buckets, read from their current
+    // position on, are dropped.
+    template<class Entry>
+    void ExternalAStarOpenList<Entry>::
+    merge_runs(fstream &sorted_blocks,
+               vector<streampos> current_k_offsets,
+               const vector<streampos> &k_offsets,
+               vector<BlockReader<Entry> *> duplicate_readers,
+               fstream &target_stream) const {
+        const streamoff entry_bytes = Entry::get_size_in_bytes();
+        size_t buffer_entries = BUFFER_BYTES / entry_bytes;
+        auto k_value = k_offsets.size();
+        vector< deque<Entry> > merge_buffers(k_value);
+        vector<Entry> merge_block; // for refilling merge buffers
+
+        vector<Entry> duplicate_entries(duplicate_readers.size());
+        for (size_t i = 0; i < duplicate_readers.size(); ++i) {
+            if (!duplicate_readers[i]->read(duplicate_entries[i]))
+                duplicate_readers[i] = nullptr;
+        }
+
+        BlockWriter<Entry> writer(target_stream, compress);
+        Entry previous_entry; // track intra bucket duplicates
+        bool has_previous_entry = false;
+
+        while (true) {
             // look for minimum entry amongst all buffers
-            size_t min_index;
-            unique_ptr<Entry> min_entry = nullptr;
-           
+            int min_index = -1;
             for (size_t k = 0; k < k_value; ++k) {
                 if (merge_buffers[k].empty()) {
-                    if (current_k_offsets[k] == k_offsets[k]) continue; // nothing to fetch
-                    sorted_blocks.seekg(current_k_offsets[k]); // fill empty merge buffer
-                    for (size_t i = 0; i < buffer_entries; ++i) {
-                        if (sorted_blocks.tellg() >= k_offsets[k]) break; // end of block
-                        Entry entry;
-                        entry.read(sorted_blocks);
-                        merge_buffers[k].push_back(entry); // change this to a deque
-                    }
-                    current_k_offsets[k] = sorted_blocks.tellg();
+                    size_t remaining =
+                        (k_offsets[k] - current_k_offsets[k]) / entry_bytes;
+                    if (remaining == 0) continue; // nothing to fetch
+                    // fill empty merge buffer
+                    sorted_blocks.seekg(current_k_offsets[k]);
+                    size_t num_reads = min(buffer_entries, remaining);
+                    merge_block.clear();
+                    Entry::read_block(sorted_blocks, merge_block, num_reads);
+                    merge_buffers[k].insert(merge_buffers[k].end(),
+                                            make_move_iterator(merge_block.begin()),
+                                            make_move_iterator(merge_block.end()));
+                    current_k_offsets[k] += num_reads * entry_bytes;
                 }
-                end_of_merge = false; // exists an unprocessed entry
-                auto& entry = merge_buffers[k].front();
-                if (!min_entry || entry < *min_entry) { // set candidate min entry
-                    min_entry = utils::make_unique_ptr<Entry>(entry);
+                if (min_index == -1 ||
+                    merge_buffers[k].front() < merge_buffers[min_index].front())
                     min_index = k;
-                }
             }
-            if (end_of_merge) break;
+            if (min_index == -1) break; // end of merge
 
             // remove min_entry from merge buffer
+            Entry min_entry = move(merge_buffers[min_index].front());
             merge_buffers[min_index].pop_front();
 
             // intra bucket duplicate detection
-            if (previous_entry) {
-                if (*min_entry == *previous_entry) {
-                    continue;
-                }
-            }
-
-            // inter bucket duplicate detection
-            if (duplicate_stream_1 != nullptr) {
-                while (*min_entry > duplicate_entry_1) { // align streams
-                    duplicate_entry_1.read(*duplicate_stream_1);
-                    if (duplicate_stream_1->eof()) {
-                        duplicate_stream_1 = nullptr;
-                        break;
-                    }
-                }
-                if (*min_entry == duplicate_entry_1) {
-                    continue;
-                } 
-            }
+            if (has_previous_entry && min_entry == previous_entry)
+                continue;
 
             // inter bucket duplicate detection
-            if (duplicate_stream_2 != nullptr) {
-                while (*min_entry > duplicate_entry_2) { // align streams
-                    duplicate_entry_2.read(*duplicate_stream_2);
-                    if (duplicate_stream_2->eof()) {
-                        duplicate_stream_2 = nullptr;
+            bool is_duplicate = false;
+            for (size_t i = 0; i < duplicate_readers.size(); ++i) {
+                if (duplicate_readers[i] == nullptr) continue;
+                while (min_entry > duplicate_entries[i]) { // align streams
+                    if (!duplicate_readers[i]->read(duplicate_entries[i])) {
+                        duplicate_readers[i] = nullptr;
                         break;
                     }
                 }
-                if (*min_entry == duplicate_entry_2) {
-                    continue;
+                if (duplicate_readers[i] != nullptr &&
+                    min_entry == duplicate_entries[i]) {
+                    is_duplicate = true;
+                    break;
                 }
             }
+            if (is_duplicate) continue;
 
             // process minimum entry
-            output_buffer.emplace_back(*min_entry);
-            previous_entry = utils::make_unique_ptr<Entry>(*min_entry);
-            // flush
-            if (output_buffer.size() == buffer_entries) {
-                for (auto& entry : output_buffer) {
-                    entry.write(*target_stream);
-                }
-            output_buffer.clear();
-            }
+            writer.write(min_entry);
+            previous_entry = move(min_entry);
+            has_previous_entry = true;
         }
 
         // flush any remainders
-        for (auto& entry : output_buffer) {
-            entry.write(*target_stream);
+        writer.flush();
+    }
+
+    /*
+      Splits the merge into one key range per thread, bounded by splitters
+      sampled from the runs. Equal entries always fall into the same range,
+      so every thread detects duplicates on its own, using its own file
+      handles. The ranges are merged into separate files that are appended
+      to target_stream in order.
+    */
+    template<class Entry>
+    void ExternalAStarOpenList<Entry>::
+    parallel_merge_runs(fstream &sorted_blocks,
+                        const string &sorted_blocks_name,
+                        const vector<streampos> &k_begins,
+                        const vector<streampos> &k_offsets,
+                        const vector<string> &duplicate_names,
+                        int f, int g, fstream &target_stream) const {
+        const streamoff entry_bytes = Entry::get_size_in_bytes();
+
+        vector<Entry> samples;
+        for (size_t k = 0; k < k_offsets.size(); ++k) {
+            streamoff run_entries = (k_offsets[k] - k_begins[k]) / entry_bytes;
+            for (int i = 1; i < num_threads; ++i) {
+                Entry sample;
+                sorted_blocks.seekg(k_begins[k] +
+                                    run_entries * i / num_threads * entry_bytes);
+                sample.read(sorted_blocks);
+                samples.push_back(move(sample));
+            }
+        }
+        sort(samples.begin(), samples.end());
+        vector<Entry> splitters;
+        for (int i = 1; i < num_threads; ++i)
+            splitters.push_back(samples[samples.size() * i / num_threads]);
+
+        vector<unique_ptr<named_fstream> > parts;
+        for (int i = 0; i < num_threads; ++i) {
+            parts.push_back(utils::make_unique_ptr<named_fstream>(
+                                get_bucket_string(f, g, ".merge" + to_string(i))));
+            if (!parts.back()->is_open())
+                throw IOException("Fail to open open list fstream");
         }
 
-        target_stream->clear();
-        target_stream->seekg(0, ios::beg);
+        utils::run_in_parallel(num_threads, [&](int i) {
+                fstream runs(sorted_blocks_name, ios::in | ios::binary);
+                if (!runs.is_open())
+                    throw IOException("Fail to open open list fstream");
+                vector<streampos> begins(k_begins);
+                vector<streampos> ends(k_offsets);
+                for (size_t k = 0; k < k_offsets.size(); ++k) {
+                    if (i > 0)
+                        begins[k] = lower_bound(runs, k_begins[k],
+                                                k_offsets[k], splitters[i - 1]);
+                    if (i < num_threads - 1)
+                        ends[k] = lower_bound(runs, k_begins[k],
+                                              k_offsets[k], splitters[i]);
+                }
+
+                vector<unique_ptr<fstream> > duplicate_files;
+                vector<unique_ptr<BlockReader<Entry> > > duplicate_readers;
+                vector<BlockReader<Entry> *> readers;
+                for (const string &duplicate_name : duplicate_names) {
+                    duplicate_files.push_back(utils::make_unique_ptr<fstream>(
+                                                  duplicate_name,
+                                                  ios::in | ios::binary));
+                    fstream &file = *duplicate_files.back();
+                    if (!file.is_open())
+                        throw IOException("Fail to open open list fstream");
+                    duplicate_readers.push_back(
+                        utils::make_unique_ptr<BlockReader<Entry> >(file, compress));
+                    readers.push_back(duplicate_readers.back().get());
+                    if (i == 0) continue;
+                    if (compress) {
+                        readers.back()->skip_blocks_below(splitters[i - 1]);
+                    } else {
+                        file.seekg(0, ios::end);
+                        streampos end = file.tellg();
+                        file.seekg(lower_bound(file, 0, end, splitters[i - 1]));
+                    }
+                }
+
+                merge_runs(runs, begins, ends, readers, *parts[i]);
+            });
+
+        for (auto &part : parts) {
+            if (part->tellp() == 0) continue; // nothing to append
+            part->seekg(0, ios::beg);
+            if (!(target_stream << part->rdbuf()))
+                throw IOException("Fail to write state to fstream.");
+        }
     }
 
+    // Returns the position of the first entry in the sorted range
+    // [begin, end) of file that is not less than key.
     template<class Entry>
-    void ExternalAStarOpenList<Entry>::
-    do_insertion(EvaluationContext &eval_context, const Entry &entry) {
-        
+    streampos ExternalAStarOpenList<Entry>::
+    lower_bound(fstream &file, streampos begin, streampos end,
+                const Entry &key) const {
+        const streamoff entry_bytes = Entry::get_size_in_bytes();
+        streamoff first = 0;
+        streamoff count = (end - begin) / entry_bytes;
+        Entry entry;
+        while (count > 0) {
+            streamoff step = count / 2;
+            file.seekg(begin + (first + step) * entry_bytes);
+            entry.read(file);
+            if (entry < key) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return begin + first * entry_bytes;
+    }
+
+    template<class Entry>
+    int ExternalAStarOpenList<Entry>::
+    get_f_value(EvaluationContext &eval_context) {
         assert(evaluators.size() == 1);
         auto f = eval_context.get_heuristic_value_or_infinity(evaluators[0]);
+
+        // With weighted (or inconsistent) evaluators, successors may have a
+        // lower f than the bucket being expanded. Buckets below the current
+        // f are never revisited, so such nodes join the current f layer.
+        if (!first_insert && f < current_fg.first)
+            f = current_fg.first;
+        return f;
+    }
+
+    template<class Entry>
+    void ExternalAStarOpenList<Entry>::
+    do_insertion(EvaluationContext &eval_context, const Entry &entry) {
+        auto f = get_f_value(eval_context);
         auto g = entry.get_g();
 
         if (!exists_bucket(f, g)) create_bucket(f, g);
@@ -281,6 +486,59 @@ namespace external_astar_open_list {
 
     }
 
+    // Only touches the buckets of the given thread, so that successors of
+    // the current bucket can be inserted by several threads at once.
+    template<class Entry>
+    void ExternalAStarOpenList<Entry>::
+    insert_concurrently(int thread_index, EvaluationContext &eval_context,
+                        const Entry &entry) {
+        // the caller has already skipped dead ends
+        assert(!first_insert);
+        auto f = get_f_value(eval_context);
+        auto g = entry.get_g();
+
+        auto &f_bucket = thread_fg_buckets[thread_index][f];
+        auto g_bucket = f_bucket.find(g);
+        if (g_bucket == f_bucket.end()) {
+            // to prevent copying of strings, in-place construction
+            g_bucket = f_bucket.emplace(
+                piecewise_construct, forward_as_tuple(g),
+                forward_as_tuple(get_bucket_string(
+                                     f, g, ".t" + to_string(thread_index))))
+                .first;
+            if (!g_bucket->second.is_open())
+                throw IOException("Fail to open open list fstream");
+        }
+        if (!entry.write(g_bucket->second))
+            throw IOException("Fail to write state to fstream.");
+    }
+
+    // Makes the buckets filled by other threads visible to remove_min.
+    template<class Entry>
+    void ExternalAStarOpenList<Entry>::register_thread_buckets() {
+        for (auto &buckets : thread_fg_buckets)
+            for (auto &f_bucket : buckets)
+                for (auto &g_bucket : f_bucket.second)
+                    if (!exists_bucket(f_bucket.first, g_bucket.first))
+                        create_bucket(f_bucket.first, g_bucket.first);
+    }
+
+    /*
+      Nodes of one bucket only have successors in later buckets, so they can
+      be expanded in any order. A batch ends with the current bucket, such
+      that the successors of all its nodes are inserted before the next
+      bucket is sorted.
+    */
+    template<class Entry>
+    void ExternalAStarOpenList<Entry>::
+    remove_min_batch(vector<Entry> &batch, size_t max_entries) {
+        batch.clear();
+        batch.push_back(remove_min());
+        Entry entry;
+        while (batch.size() < max_entries && bucket_reader->read(entry))
+            batch.push_back(move(entry));
+    }
+
     template<class Entry>
     Entry ExternalAStarOpenList<Entry>::remove_min() {
         
@@ -289,11 +547,18 @@ namespace external_astar_open_list {
         int f, g;
         tie(f, g) = current_fg;
 
-        // attempt to read
-        min_entry.read(fg_buckets[f][g]);
+        if (!bucket_reader) {
+            if (first_insert) throw OpenListEmpty();
+            // the bucket of the initial state is stored like all others
+            remove_duplicates(f, g);
+            bucket_reader = utils::make_unique_ptr<BlockReader<Entry> >(
+                fg_buckets[f][g], compress);
+        }
 
         // update f, g values, and perform duplicate detection
-        if (fg_buckets[f][g].eof()) {
+        if (!bucket_reader->read(min_entry)) {
+            bucket_reader = nullptr;
+            register_thread_buckets();
             auto g_bucket = fg_buckets[f].begin();
             while (g_bucket != fg_buckets[f].end() && g_bucket->first <= g) ++g_bucket;
             if (g_bucket == fg_buckets[f].end()) {
@@ -312,31 +577,14 @@ namespace external_astar_open_list {
 
 #ifdef TEST_EXTERNALASTAR_DDD
             vector<Entry> duplicate_vector;
-            if (exists_bucket(f-1, g-1)) {
-                fg_buckets[f-1][g-1].clear();
-                fg_buckets[f-1][g-1].seekg(0);
+            for (int delta = 0; delta <= 2; ++delta) {
+                if (!exists_bucket(f-delta, g-delta)) continue;
+                fg_buckets[f-delta][g-delta].clear();
+                fg_buckets[f-delta][g-delta].seekg(0);
+                BlockReader<Entry> reader(fg_buckets[f-delta][g-delta], compress);
                 Entry entry;
-                entry.read(fg_buckets[f-1][g-1]);
-                while (!fg_buckets[f-1][g-1].eof()) {
+                while (reader.read(entry))
                     duplicate_vector.push_back(entry);
-                    entry.read(fg_buckets[f-1][g-1]);
-                }
-            }
-            if (exists_bucket(f-2, g-2)) {
-                fg_buckets[f-2][g-2].clear();
-                fg_buckets[f-2][g-2].seekg(0);
-                Entry entry;
-                entry.read(fg_buckets[f-2][g-2]);
-                while (!fg_buckets[f-2][g-2].eof()) {
-                    duplicate_vector.push_back(entry);
-                    entry.read(fg_buckets[f-2][g-2]);
-                }
-            }
-            Entry entry;
-            entry.read(fg_buckets[f][g]);
-            while (!fg_buckets[f][g].eof()) {
-                duplicate_vector.push_back(entry);
-                entry.read(fg_buckets[f][g]);
             }
 
             set<Entry> duplicate_set(duplicate_vector.begin(), duplicate_vector.end());
@@ -347,6 +595,8 @@ namespace external_astar_open_list {
             fg_buckets[f][g].clear();
             fg_buckets[f][g].seekg(0, ios::beg);
 #endif                      
+            bucket_reader = utils::make_unique_ptr<BlockReader<Entry> >(
+                fg_buckets[f][g], compress);
             return remove_min();
         }
 
@@ -363,7 +613,10 @@ namespace external_astar_open_list {
 
     template<class Entry>
     void ExternalAStarOpenList<Entry>::clear() {
+        bucket_reader = nullptr;
         fg_buckets.clear();
+        for (auto &buckets : thread_fg_buckets)
+            buckets.clear();
         // remove empty directory, this fails if directory is not empty
         rmdir("open_list_buckets");
     }
@@ -408,9 +661,9 @@ namespace external_astar_open_list {
 
     template<class Entry>
     string ExternalAStarOpenList<Entry>::
-    get_bucket_string(int f, int g) const {
+    get_bucket_string(int f, int g, const string &suffix) const {
         std::ostringstream oss;
-        oss << "open_list_buckets/" <<  f << "_" << g << ".bucket";
+        oss << "open_list_buckets/" <<  f << "_" << g << suffix << ".bucket";
         return oss.str();
     }
 
@@ -424,6 +677,13 @@ namespace external_astar_open_list {
         return true;
     }
 
+    // Buckets are deduplicated in order of f, then g, when they are reached.
+    template<class Entry>
+    bool ExternalAStarOpenList<Entry>::
+    is_deduplicated_bucket(int f, int g) const {
+        return !first_insert && make_pair(f, g) <= current_fg;
+    }
+
     template<class Entry>
     void ExternalAStarOpenList<Entry>::
     create_bucket(int f, int g) {
@@ -461,14 +721,16 @@ namespace external_astar_open_list {
                         g_it->second.clear();
                         g_it->second.seekg(0, ios::beg);
                         Entry node;
-                        node.read(g_it->second);
-                        while (!g_it->second.eof()) {
+                        BlockReader<Entry> reader(
+                            g_it->second,
+                            compress &&
+                            is_deduplicated_bucket(f_it->first, g_it->first));
+                        while (reader.read(node)) {
                             if (node.get_state_id() ==
                                 current_state.get_parent_state_id()) {
                                 current_state = node;
                                 goto startloop;
                             }
-                            node.read(g_it->second);
                         }
                     }
                 }
@@ -494,6 +756,15 @@ namespace external_astar_open_list {
     static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
         parser.document_synopsis("Tie-breaking open list", "");
         parser.add_list_option<Evaluator *>("evals", "evaluators");
+        parser.add_option<int>(
+            "threads",
+            "number of threads for sorting, merging and concurrent insertion",
+            "1");
+        parser.add_option<bool>(
+            "compress",
+            "delta code the records of sorted buckets, which reduces disk "
+            "space and I/O at some CPU cost",
+            "false");
 
         Options opts = parser.parse();
         opts.verify_list_non_empty<Evaluator *>("evals");
@@ -0,0 +1,225 @@
+#include "external_greedy_open_list.h"
+
+#include "../../open_list.h"
+#include "../../option_parser.h"
+#include "../../plugin.h"
+
+#include "../../utils/memory.h"
+
+#include "../utils/named_fstream.h"
+#include "../utils/errors.h"
+
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+
+// for constructing directory
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*                                                                         \
+| Open list for greedy best-first search, with one bucket file per h value. |
+| Nodes reached by a preferred operator are additionally kept in a second   |
+| set of buckets. Like the alternation open list, both queues are served in |
+| turn, and the preferred queue is boosted whenever a new best h is seen.   |
+| A node may therefore be expanded from both queues; the closed list takes  |
+| care of the second copy.                                                  |
+\=========================================================================*/
+
+namespace external_greedy_open_list {
+    template<class Entry>
+    class ExternalGreedyOpenList : public OpenList<Entry> {
+        struct HBuckets {
+            string prefix;
+            map<int, named_fstream> buckets;
+            int size = 0;
+            int priority = 0;
+
+            explicit HBuckets(const string &prefix) : prefix(prefix) {}
+        };
+
+        Evaluator *evaluator;
+        const bool use_preferred;
+        const int boost_amount;
+        int best_h;
+
+        HBuckets all_nodes;
+        HBuckets preferred_nodes;
+
+        void push(HBuckets &queue, int h, const Entry &entry);
+        Entry pop(HBuckets &queue);
+    protected:
+        virtual void do_insertion(EvaluationContext &eval_context,
+                                  const Entry &entry) override;
+
+    public:
+        explicit ExternalGreedyOpenList(const Options &opts);
+        virtual ~ExternalGreedyOpenList() override = default;
+
+        virtual Entry remove_min() override;
+        virtual void clear() override;
+        virtual bool empty() const override;
+        virtual void boost_preferred() override;
+        virtual void get_involved_heuristics(set<Heuristic *> &hset) override;
+        virtual bool is_dead_end(EvaluationContext &eval_context) const override;
+        virtual bool is_reliable_dead_end(EvaluationContext &eval_context) const override;
+    };
+
+
+    template<class Entry>
+    ExternalGreedyOpenList<Entry>::ExternalGreedyOpenList(const Options &opts)
+        : OpenList<Entry>(false),
+        evaluator(opts.get<Evaluator *>("eval")),
+        use_preferred(opts.get<bool>("use_preferred")),
+        boost_amount(opts.get<int>("boost")),
+        best_h(numeric_limits<int>::max()),
+        all_nodes("open_list_buckets/greedy_"),
+        preferred_nodes("open_list_buckets/greedy_preferred_") {
+        // create directory for open list files if not exist
+        mkdir("open_list_buckets", 0744);
+    }
+
+    template<class Entry>
+    void ExternalGreedyOpenList<Entry>::
+    push(HBuckets &queue, int h, const Entry &entry) {
+        auto bucket = queue.buckets.find(h);
+        if (bucket == queue.buckets.end()) {
+            ostringstream oss;
+            oss << queue.prefix << h << ".bucket";
+            // to prevent copying of strings, in-place construction
+            bucket = queue.buckets.emplace(piecewise_construct,
+                                           forward_as_tuple(h),
+                                           forward_as_tuple(oss.str())).first;
+            if (!bucket->second.is_open())
+                throw IOException("Fail to open open list fstream.");
+        }
+        if (!entry.write(bucket->second))
+            throw IOException("Fail to write state to fstream.");
+        ++queue.size;
+    }
+
+    // Pops the most recently inserted node of the lowest h bucket.
+    template<class Entry>
+    Entry ExternalGreedyOpenList<Entry>::pop(HBuckets &queue) {
+        assert(queue.size > 0);
+        auto bucket = queue.buckets.begin();
+        Entry entry;
+        //reverse seek
+        bucket->second.seekp(-Entry::get_size_in_bytes(), ios::cur);
+        entry.read(bucket->second);
+        // return pointer for subsequent write / read
+        bucket->second.seekp(-Entry::get_size_in_bytes(), ios::cur);
+        if (bucket->second.tellp() == 0)
+            queue.buckets.erase(bucket);
+        --queue.size;
+        return entry;
+    }
+
+    template<class Entry>
+    void ExternalGreedyOpenList<Entry>::
+    do_insertion(EvaluationContext &eval_context, const Entry &entry) {
+        int h = eval_context.get_heuristic_value_or_infinity(evaluator);
+        push(all_nodes, h, entry);
+        if (use_preferred && eval_context.is_preferred())
+            push(preferred_nodes, h, entry);
+        if (h < best_h) {
+            // progress: favour the preferred queue for a while
+            if (best_h != numeric_limits<int>::max())
+                boost_preferred();
+            best_h = h;
+        }
+    }
+
+    template<class Entry>
+    Entry ExternalGreedyOpenList<Entry>::remove_min() {
+        assert(!empty());
+        // ties go to the queue containing all nodes
+        HBuckets *best = nullptr;
+        for (HBuckets *queue : {&all_nodes, &preferred_nodes})
+            if (queue->size > 0 &&
+                (!best || queue->priority < best->priority))
+                best = queue;
+        ++best->priority;
+        return pop(*best);
+    }
+
+    template<class Entry>
+    bool ExternalGreedyOpenList<Entry>::empty() const {
+        return all_nodes.size == 0 && preferred_nodes.size == 0;
+    }
+
+    template<class Entry>
+    void ExternalGreedyOpenList<Entry>::clear() {
+        for (HBuckets *queue : {&all_nodes, &preferred_nodes}) {
+            queue->buckets.clear();
+            queue->size = 0;
+        }
+        // remove empty directory, this fails if directory is not empty
+        rmdir("open_list_buckets");
+    }
+
+    template<class Entry>
+    void ExternalGreedyOpenList<Entry>::boost_preferred() {
+        if (use_preferred)
+            preferred_nodes.priority -= boost_amount;
+    }
+
+    template<class Entry>
+    void ExternalGreedyOpenList<Entry>::
+    get_involved_heuristics(set<Heuristic *> &hset) {
+        evaluator->get_involved_heuristics(hset);
+    }
+
+    template<class Entry>
+    bool ExternalGreedyOpenList<Entry>::
+    is_dead_end(EvaluationContext &eval_context) const {
+        return eval_context.is_heuristic_infinite(evaluator);
+    }
+
+    template<class Entry>
+    bool ExternalGreedyOpenList<Entry>::
+    is_reliable_dead_end(EvaluationContext &eval_context) const {
+        return is_dead_end(eval_context) &&
+            evaluator->dead_ends_are_reliable();
+    }
+
+
+    ExternalGreedyOpenListFactory::
+    ExternalGreedyOpenListFactory(const Options &options)
+        : options(options) {
+    }
+
+    unique_ptr<StateOpenList>
+    ExternalGreedyOpenListFactory::create_state_open_list() {
+        return utils::make_unique_ptr
+            <ExternalGreedyOpenList<StateOpenListEntry>>(options);
+    }
+
+
+    static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
+        parser.document_synopsis("External greedy open list",
+                                 "Bucket files ordered by h, with an "
+                                 "optional queue for preferred successors.");
+        parser.add_option<Evaluator *>("eval", "evaluator");
+        parser.add_option<bool>(
+            "use_preferred",
+            "keep an additional queue of preferred successors", "false");
+        parser.add_option<int>(
+            "boost",
+            "boost value for the preferred queue on progress", "0");
+
+        Options opts = parser.parse();
+        if (parser.dry_run())
+            return nullptr;
+        else
+            return make_shared<ExternalGreedyOpenListFactory>(opts);
+    }
+
+    static PluginShared<OpenListFactory> _plugin("external_greedy_open_list", _parse);
+}
@@ -0,0 +1,18 @@
+#ifndef EXTERNAL_OPEN_LISTS_EXTERNAL_GREEDY_OPEN_LIST_H
+#define EXTERNAL_OPEN_LISTS_EXTERNAL_GREEDY_OPEN_LIST_H
+
+#include "../../open_list_factory.h"
+#include "../../option_parser_util.h"
+
+namespace external_greedy_open_list {
+class ExternalGreedyOpenListFactory : public OpenListFactory {
+    Options options;
+public:
+    explicit ExternalGreedyOpenListFactory(const Options &options);
+    virtual ~ExternalGreedyOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+};
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include "in_memory_tiebreaking_open_list.h"
+
+#include "../../open_list.h"
+#include "../../option_parser.h"
+#include "../../plugin.h"
+
+#include "../../utils/memory.h"
+
+#include <utility>
+#include <map>
+#include <set>
+#include <vector>
+#include <iterator>
+#include <cassert>
+
+//#define EXTERNAL_ASTAR_TIEBREAKING
+
+// In-memory counterpart of the external tie-breaking open list. Buckets are
+// ordered identically (lowest f, then highest g, LIFO within a bucket), so a
+// search switching from this open list to the external one expands nodes in
+// the same order.
+
+using namespace std;
+
+namespace in_memory_tiebreaking_open_list {
+    template<class Entry>
+    class InMemoryTieBreakingOpenList : public OpenList<Entry> {
+
+        map<int, map<int, vector<Entry> > > fg_buckets;
+
+        int size;
+
+        vector<Evaluator *> evaluators; // f, h
+
+    protected:
+        virtual void do_insertion(EvaluationContext &eval_context,
+                                  const Entry &entry) override;
+
+    public:
+        explicit InMemoryTieBreakingOpenList(const Options &opts);
+        virtual ~InMemoryTieBreakingOpenList() override = default;
+
+        virtual Entry remove_min() override;
+        virtual void clear() override;
+        virtual bool empty() const override;
+        virtual void get_involved_heuristics(set<Heuristic *> &hset) override;
+        virtual bool is_dead_end(EvaluationContext &eval_context) const override;
+        virtual bool is_reliable_dead_end(EvaluationContext &eval_context) const override;
+    };
+
+
+    template<class Entry>
+    InMemoryTieBreakingOpenList<Entry>::InMemoryTieBreakingOpenList(const Options &opts)
+        : OpenList<Entry>(false),
+        size(0), evaluators(opts.get_list<Evaluator *>("evals")) {
+    }
+
+    template<class Entry>
+    void InMemoryTieBreakingOpenList<Entry>::
+    do_insertion(EvaluationContext &eval_context, const Entry &entry) {
+        auto f = eval_context.get_heuristic_value_or_infinity(evaluators[0]);
+        auto g = entry.get_g();
+        fg_buckets[f][g].push_back(entry);
+        ++size;
+    }
+
+    template<class Entry>
+    Entry InMemoryTieBreakingOpenList<Entry>::remove_min() {
+        assert(size > 0);
+        // tiebreak by lowest f value
+        auto f_bucket = fg_buckets.begin();
+#ifdef EXTERNAL_ASTAR_TIEBREAKING
+        // tiebreak by lowest g value
+        auto g_bucket = f_bucket->second.begin();
+#else
+        // tiebreak by highest g value
+        auto g_bucket = prev(f_bucket->second.end());
+#endif
+        Entry min_entry = move(g_bucket->second.back());
+        g_bucket->second.pop_back();
+
+        // if g bucket is empty
+        if (g_bucket->second.empty()) {
+            f_bucket->second.erase(g_bucket);
+            // if f bucket is empty
+            if (f_bucket->second.empty())
+                fg_buckets.erase(f_bucket);
+        }
+        --size;
+        return min_entry;
+    }
+
+    template<class Entry>
+    bool InMemoryTieBreakingOpenList<Entry>::empty() const {
+        return size == 0;
+    }
+
+    template<class Entry>
+    void InMemoryTieBreakingOpenList<Entry>::clear() {
+        fg_buckets.clear();
+        size = 0;
+    }
+
+    template<class Entry>
+    void InMemoryTieBreakingOpenList<Entry>::
+    get_involved_heuristics(set<Heuristic *> &hset) {
+        for (Evaluator *evaluator : evaluators)
+            evaluator->get_involved_heuristics(hset);
+    }
+
+    template<class Entry>
+    bool InMemoryTieBreakingOpenList<Entry>::
+    is_dead_end(EvaluationContext &eval_context) const {
+        // If one safe heuristic detects a dead end, return true.
+        if (is_reliable_dead_end(eval_context))
+            return true;
+
+        // Otherwise, return true if all heuristics agree this is a dead-end.
+        for (Evaluator *evaluator : evaluators)
+            if (!eval_context.is_heuristic_infinite(evaluator))
+                return false;
+        return true;
+    }
+
+    template<class Entry>
+    bool InMemoryTieBreakingOpenList<Entry>::
+    is_reliable_dead_end(EvaluationContext &eval_context) const {
+        for (Evaluator *evaluator : evaluators)
+            if (eval_context.is_heuristic_infinite(evaluator) &&
+                evaluator->dead_ends_are_reliable())
+                return true;
+        return false;
+    }
+
+
+    InMemoryTieBreakingOpenListFactory::
+    InMemoryTieBreakingOpenListFactory(const Options &options)
+        : options(options) {
+    }
+
+    unique_ptr<StateOpenList>
+    InMemoryTieBreakingOpenListFactory::create_state_open_list() {
+        return utils::make_unique_ptr
+            <InMemoryTieBreakingOpenList<StateOpenListEntry>>(options);
+    }
+
+
+    static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
+        parser.document_synopsis("In-memory tie-breaking open list", "");
+        parser.add_list_option<Evaluator *>("evals", "evaluators");
+
+        Options opts = parser.parse();
+        opts.verify_list_non_empty<Evaluator *>("evals");
+        if (parser.dry_run())
+            return nullptr;
+        else
+            return make_shared<InMemoryTieBreakingOpenListFactory>(opts);
+    }
+
+    static PluginShared<OpenListFactory> _plugin("in_memory_tiebreaking", _parse);
+}
@@ -0,0 +1,18 @@
+#ifndef EXTERNAL_OPEN_LISTS_IN_MEMORY_TIEBREAKING_OPEN_LIST_H
+#define EXTERNAL_OPEN_LISTS_IN_MEMORY_TIEBREAKING_OPEN_LIST_H
+
+#include "../../open_list_factory.h"
+#include "../../option_parser_util.h"
+
+namespace in_memory_tiebreaking_open_list {
+class InMemoryTieBreakingOpenListFactory : public OpenListFactory {
+    Options options;
+public:
+    explicit InMemoryTieBreakingOpenListFactory(const Options &options);
+    virtual ~InMemoryTieBreakingOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+};
+}
+
+#endif
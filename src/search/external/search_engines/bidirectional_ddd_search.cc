@@ -0,0 +1,463 @@
+#include "bidirectional_ddd_search.h"
+
+#include "../../evaluation_context.h"
+#include "../../evaluator.h"
+#include "../../global_operator.h"
+#include "../../globals.h"
+#include "../../heuristic.h"
+#include "../../option_parser.h"
+#include "../../operator_cost.h"
+#include "../../utils/memory.h"
+#include "../../utils/system.h"
+
+#include "../../task_utils/successor_generator.h"
+
+#include "../hash_functions/zobrist.h"
+#include "../utils/block_reader.h"
+#include "../utils/errors.h"
+
+#include <algorithm>
+#include <cassert>
+#include <set>
+
+// for constructing directory
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace statehash;
+
+namespace bidirectional_ddd_search {
+    BidirectionalDDDSearch::BidirectionalDDDSearch(const Options &opts)
+        : SearchEngine(opts),
+          n_buckets(opts.get<int>("buckets")),
+          max_goal_states(opts.get<int>("max_goal_states")),
+          evaluator(opts.get<Evaluator *>("eval", nullptr)) {
+        forward.name = "forward";
+        backward.name = "backward";
+    }
+
+    void BidirectionalDDDSearch::create_bucket(Frontier &frontier,
+                                               int bucket_index,
+                                               BucketType bucket_type) {
+        string type;
+        vector<unique_ptr<named_fstream> > *buckets;
+        switch (bucket_type) {
+        case BucketType::open:
+            type = "open";
+            buckets = &frontier.open_buckets;
+            break;
+        case BucketType::next:
+            type = "next";
+            buckets = &frontier.next_buckets;
+            break;
+        default:
+            type = "closed";
+            buckets = &frontier.closed_buckets;
+        }
+        (*buckets)[bucket_index] = utils::make_unique_ptr<named_fstream>(
+            "open_list_buckets/" + frontier.name + "_" + type + "_" +
+            to_string(bucket_index) + ".bucket");
+    }
+
+    void BidirectionalDDDSearch::initialize() {
+        cout << "Conducting bidirectional breadth-first search with hash-based "
+             << "delayed duplicate detection" << endl;
+
+        for (const GlobalOperator &op : g_operators) {
+            if (get_adjusted_action_cost(op, cost_type) != 1) {
+                cerr << "bidirectional_ddd requires unit action costs "
+                     << "(use cost_type=one to ignore costs)" << endl;
+                utils::exit_with(utils::ExitCode::UNSUPPORTED);
+            }
+        }
+        if (has_axioms() || has_conditional_effects()) {
+            cerr << "bidirectional_ddd does not support axioms or "
+                 << "conditional effects" << endl;
+            utils::exit_with(utils::ExitCode::UNSUPPORTED);
+        }
+
+        if (!GlobalState::has_hash_function())
+            GlobalState::initialize_hash_function(
+                utils::make_unique_ptr<ZobristHash<GlobalState> >());
+
+        // create directory for bucket files if not exist
+        mkdir("open_list_buckets", 0744);
+        for (Frontier *frontier : {&forward, &backward}) {
+            frontier->open_buckets.resize(n_buckets);
+            frontier->next_buckets.resize(n_buckets);
+            frontier->closed_buckets.resize(n_buckets);
+            for (int i = 0; i < n_buckets; ++i) {
+                create_bucket(*frontier, i, BucketType::open);
+                create_bucket(*frontier, i, BucketType::next);
+                create_bucket(*frontier, i, BucketType::closed);
+            }
+        }
+        cout << "Number of hash buckets per direction: " << n_buckets << endl;
+
+        for (size_t op_index = 0; op_index < g_operators.size(); ++op_index) {
+            const GlobalOperator &op = g_operators[op_index];
+            RegressionOperator regression;
+            regression.op_index = op_index;
+            set<int> effect_vars;
+            for (const GlobalEffect &effect : op.get_effects()) {
+                regression.effects.emplace_back(effect.var, effect.val);
+                effect_vars.insert(effect.var);
+            }
+            for (const GlobalCondition &pre : op.get_preconditions()) {
+                if (effect_vars.count(pre.var)) {
+                    regression.restored.emplace_back(pre.var, pre.val);
+                    effect_vars.erase(pre.var);
+                } else {
+                    regression.prevails.emplace_back(pre.var, pre.val);
+                }
+            }
+            regression.free_vars.assign(effect_vars.begin(), effect_vars.end());
+            regression_operators.push_back(move(regression));
+        }
+
+        const GlobalState &initial_state = state_registry.get_initial_state();
+        if (evaluator) {
+            set<Heuristic *> hset;
+            evaluator->get_involved_heuristics(hset);
+            for (Heuristic *heuristic : hset)
+                heuristic->notify_initial_state(initial_state);
+
+            EvaluationContext eval_context(initial_state, false, &statistics);
+            statistics.inc_evaluated_states();
+            if (eval_context.is_heuristic_infinite(evaluator)) {
+                cout << "Initial state is a dead end." << endl;
+                return;
+            }
+            statistics.report_f_value_progress(
+                eval_context.get_heuristic_value(evaluator));
+        }
+        solved_initially = test_goal(initial_state);
+        initial_state.write(
+            *forward.open_buckets[initial_state.get_hash_value() % n_buckets]);
+        forward.layer_size = 1;
+
+        vector<int> values(g_variable_domain.size(), -1);
+        vector<int> free_vars;
+        for (const pair<int, int> &goal : g_goal)
+            values[goal.first] = goal.second;
+        // Bound the number of goal states before enumerating any of them.
+        size_t max_num_goal_states = 1;
+        for (size_t var = 0; var < values.size(); ++var) {
+            if (values[var] == -1) {
+                free_vars.push_back(var);
+                size_t domain_size = g_variable_domain[var];
+                if (max_num_goal_states > max_goal_states / domain_size) {
+                    cerr << "bidirectional_ddd starts the backward search "
+                         << "from every complete goal state, but the goal "
+                         << "leaves variables free that allow more than "
+                         << "max_goal_states=" << max_goal_states
+                         << " of them. Tasks whose goal leaves this many "
+                         << "variables free are not supported." << endl;
+                    utils::exit_with(utils::ExitCode::UNSUPPORTED);
+                }
+                max_num_goal_states *= domain_size;
+            }
+        }
+        generate_goal_states(values, free_vars, 0);
+        cout << "Number of goal states: " << backward.layer_size << endl;
+    }
+
+    /*
+      The backward search starts from every complete state that satisfies the
+      goal. Non-goal variables are assigned one at a time and assignments that
+      are mutex with an earlier fact are pruned. The caller has checked that
+      there are at most max_goal_states such states.
+    */
+    void BidirectionalDDDSearch::generate_goal_states(
+        vector<int> &values, const vector<int> &free_vars, size_t index) {
+        if (index == free_vars.size()) {
+            assert(backward.layer_size < static_cast<size_t>(max_goal_states));
+            vector<PackedStateBin> buffer(g_state_packer->get_num_bins());
+            for (size_t var = 0; var < values.size(); ++var)
+                g_state_packer->set(&buffer[0], var, values[var]);
+            GlobalState goal_state(&buffer[0]);
+            goal_state.write(
+                *backward.open_buckets[goal_state.get_hash_value() % n_buckets]);
+            ++backward.layer_size;
+            return;
+        }
+        int var = free_vars[index];
+        for (int value = 0; value < g_variable_domain[var]; ++value) {
+            values[var] = -1;
+            FactPair fact(var, value);
+            bool is_mutex = false;
+            for (size_t other = 0; other < values.size() && !is_mutex; ++other)
+                if (values[other] != -1 &&
+                    are_mutex(fact, FactPair(other, values[other])))
+                    is_mutex = true;
+            if (is_mutex)
+                continue;
+            values[var] = value;
+            generate_goal_states(values, free_vars, index + 1);
+        }
+        values[var] = -1;
+    }
+
+    void BidirectionalDDDSearch::insert_next(Frontier &frontier,
+                                             const GlobalState &state) {
+        int bucket_index = state.get_hash_value() % n_buckets;
+        if (!state.write(*frontier.next_buckets[bucket_index]))
+            throw IOException("Fail to write state to fstream.");
+    }
+
+    void BidirectionalDDDSearch::expand_forward(const GlobalState &state) {
+        vector<OperatorID> applicable_ops;
+        g_successor_generator->generate_applicable_ops(state, applicable_ops);
+
+        statistics.inc_expanded();
+        for (OperatorID op_id : applicable_ops) {
+            const GlobalOperator *op = &g_operators[op_id.get_index()];
+            GlobalState succ_state = state_registry.get_successor_state(state, op);
+            statistics.inc_generated();
+
+            if (evaluator) {
+                EvaluationContext eval_context(succ_state, false, &statistics);
+                statistics.inc_evaluated_states();
+                if (eval_context.is_heuristic_infinite(evaluator)) {
+                    statistics.inc_dead_ends();
+                    continue;
+                }
+            }
+            insert_next(forward, succ_state);
+        }
+    }
+
+    /*
+      Generates every complete state from which some operator leads to the
+      given state. Nodes of the backward search store the state towards the
+      goal as their parent, and the operator leading there as their creating
+      operator.
+    */
+    void BidirectionalDDDSearch::expand_backward(const GlobalState &state) {
+        statistics.inc_expanded();
+        vector<int> values = state.get_values();
+        for (const RegressionOperator &op : regression_operators) {
+            bool applicable = true;
+            for (const FactPair &effect : op.effects)
+                if (values[effect.var] != effect.value)
+                    applicable = false;
+            for (const FactPair &prevail : op.prevails)
+                if (values[prevail.var] != prevail.value)
+                    applicable = false;
+            if (!applicable)
+                continue;
+
+            // scratch node holding the packed predecessor being built
+            GlobalState regressed(state.get_packed_buffer());
+            PackedStateBin *buffer = regressed.get_packed_buffer();
+            for (const FactPair &restored : op.restored)
+                g_state_packer->set(buffer, restored.var, restored.value);
+
+            // enumerate all values of effect variables without precondition
+            vector<int> free_values(op.free_vars.size(), 0);
+            while (true) {
+                for (size_t i = 0; i < op.free_vars.size(); ++i)
+                    g_state_packer->set(buffer, op.free_vars[i],
+                                        free_values[i]);
+                GlobalState pred_state(buffer, state.get_state_id(),
+                                       op.op_index, state.get_g() + 1,
+                                       state.get_hash_value());
+                statistics.inc_generated();
+                insert_next(backward, pred_state);
+
+                size_t i = 0;
+                while (i < free_values.size() &&
+                       ++free_values[i] == g_variable_domain[op.free_vars[i]]) {
+                    free_values[i] = 0;
+                    ++i;
+                }
+                if (i == free_values.size())
+                    break;
+            }
+        }
+    }
+
+    void BidirectionalDDDSearch::expand_layer(Frontier &frontier) {
+        for (int i = 0; i < n_buckets; ++i) {
+            named_fstream &bucket = *frontier.open_buckets[i];
+            bucket.clear();
+            bucket.seekg(0, ios::beg);
+            GlobalState state;
+            BlockReader<GlobalState> reader(bucket);
+            while (reader.read(state)) {
+                if (&frontier == &forward)
+                    expand_forward(state);
+                else
+                    expand_backward(state);
+            }
+        }
+    }
+
+    /*
+      Replaces the current layer by the deduplicated next layer, bucket by
+      bucket. Every bucket of the new layer is checked against the current
+      layer of the other direction while it is in memory.
+    */
+    void BidirectionalDDDSearch::advance_layer(Frontier &frontier,
+                                               Frontier &other) {
+        size_t layer_size = 0;
+        for (int i = 0; i < n_buckets; ++i) {
+            unordered_set<GlobalState> layer;
+            named_fstream &next_bucket = *frontier.next_buckets[i];
+            next_bucket.clear();
+            next_bucket.seekg(0, ios::beg);
+            GlobalState entry;
+            BlockReader<GlobalState> next_reader(next_bucket);
+            while (next_reader.read(entry))
+                layer.insert(entry);
+            create_bucket(frontier, i, BucketType::next);
+
+            named_fstream &closed_bucket = *frontier.closed_buckets[i];
+            closed_bucket.clear();
+            closed_bucket.seekg(0, ios::beg);
+            BlockReader<GlobalState> closed_reader(closed_bucket);
+            while (closed_reader.read(entry))
+                layer.erase(entry);
+            closed_bucket.clear();
+            closed_bucket.seekg(0, ios::end);
+
+            // close the current layer
+            named_fstream &open_bucket = *frontier.open_buckets[i];
+            open_bucket.clear();
+            open_bucket.seekg(0, ios::beg);
+            BlockReader<GlobalState> open_reader(open_bucket);
+            while (open_reader.read(entry)) {
+                layer.erase(entry);
+                if (!entry.write(closed_bucket))
+                    throw IOException("Fail to write state to fstream.");
+            }
+
+            create_bucket(frontier, i, BucketType::open);
+            for (const GlobalState &state : layer)
+                if (!state.write(*frontier.open_buckets[i]))
+                    throw IOException("Fail to write state to fstream.");
+            layer_size += layer.size();
+
+            if (!met)
+                find_meet(frontier, other, i, layer);
+        }
+        frontier.layer_size = layer_size;
+        ++frontier.depth;
+    }
+
+    void BidirectionalDDDSearch::find_meet(
+        Frontier &frontier, Frontier &other, int bucket_index,
+        const unordered_set<GlobalState> &layer) {
+        named_fstream &bucket = *other.open_buckets[bucket_index];
+        bucket.clear();
+        bucket.seekg(0, ios::beg);
+        GlobalState entry;
+        BlockReader<GlobalState> reader(bucket);
+        while (reader.read(entry)) {
+            auto it = layer.find(entry);
+            if (it != layer.end()) {
+                met = true;
+                forward_meet = (&frontier == &forward) ? *it : entry;
+                backward_meet = (&frontier == &forward) ? entry : *it;
+                break;
+            }
+        }
+        bucket.clear();
+        bucket.seekg(0, ios::end);
+    }
+
+    bool BidirectionalDDDSearch::find_parent(const Frontier &frontier,
+                                             const GlobalState &state,
+                                             GlobalState &parent) const {
+        named_fstream &bucket = *frontier.closed_buckets[
+            state.get_parent_hash_value() % n_buckets];
+        bucket.clear();
+        bucket.seekg(0, ios::beg);
+        bool found = false;
+        BlockReader<GlobalState> reader(bucket);
+        while (reader.read(parent)) {
+            if (parent.get_state_id() == state.get_parent_state_id()) {
+                found = true;
+                break;
+            }
+        }
+        bucket.clear();
+        bucket.seekg(0, ios::end);
+        return found;
+    }
+
+    /*
+      The forward half is traced from the meeting state back to the initial
+      state and reversed. The backward half already lists the operators in
+      execution order, from the meeting state towards the goal.
+    */
+    // Every expanded state's parent is in an earlier layer of its frontier.
+    static void exit_missing_parent(const string &direction) {
+        cerr << "Parent of a state is missing from the " << direction
+             << " layers" << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+
+    vector<const GlobalOperator *> BidirectionalDDDSearch::trace_path() const {
+        vector<const GlobalOperator *> path;
+        GlobalState current = forward_meet;
+        GlobalState parent;
+        while (current.get_creating_operator() != -1) {
+            path.push_back(&g_operators[current.get_creating_operator()]);
+            if (!find_parent(forward, current, parent))
+                exit_missing_parent("forward");
+            current = parent;
+        }
+        reverse(path.begin(), path.end());
+
+        current = backward_meet;
+        while (current.get_creating_operator() != -1) {
+            path.push_back(&g_operators[current.get_creating_operator()]);
+            if (!find_parent(backward, current, parent))
+                exit_missing_parent("backward");
+            current = parent;
+        }
+        return path;
+    }
+
+    SearchStatus BidirectionalDDDSearch::step() {
+        if (solved_initially) {
+            cout << "Solution found!" << endl;
+            set_plan(Plan());
+            return SOLVED;
+        }
+
+        // expand the direction with the smaller frontier
+        bool forward_step = forward.layer_size <= backward.layer_size;
+        Frontier &frontier = forward_step ? forward : backward;
+        Frontier &other = forward_step ? backward : forward;
+        if (frontier.layer_size == 0) {
+            cout << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+
+        expand_layer(frontier);
+        advance_layer(frontier, other);
+        cout << "[" << frontier.name << " depth " << frontier.depth << ": "
+             << frontier.layer_size << " states, ";
+        statistics.print_basic_statistics();
+        cout << "]" << endl;
+
+        if (met) {
+            cout << "Solution found!" << endl;
+            set_plan(trace_path());
+            return SOLVED;
+        }
+        return IN_PROGRESS;
+    }
+
+    void BidirectionalDDDSearch::print_statistics() const {
+        statistics.print_detailed_statistics();
+        cout << "Forward search depth: " << forward.depth
+             << "\nBackward search depth: " << backward.depth
+             << "\nSize of a node: " << GlobalState::get_size_in_bytes()
+             << " bytes" << endl;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef EXTERNAL_SEARCH_ENGINES_BIDIRECTIONAL_DDD_SEARCH_H
+#define EXTERNAL_SEARCH_ENGINES_BIDIRECTIONAL_DDD_SEARCH_H
+
+#include "../../abstract_task.h"
+#include "../../global_state.h"
+#include "../../search_engine.h"
+
+#include "../utils/named_fstream.h"
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class Evaluator;
+class GlobalOperator;
+
+namespace options {
+    class Options;
+}
+
+/*
+  Bidirectional breadth-first search with hash-based delayed duplicate
+  detection. Both directions keep their current layer, the layer being
+  generated and everything closed so far in hash bucket files, as in A*-DDD.
+  When a new layer is deduplicated, each bucket of it is already in RAM and is
+  checked against the same bucket of the other frontier, so the first meet
+  found yields a shortest plan. Restricted to unit-cost tasks without axioms
+  and conditional effects, because regression needs both. Unlike A*-DDD,
+  layers are not ordered by f: the optional evaluator only prunes forward
+  dead ends.
+*/
+namespace bidirectional_ddd_search {
+    enum class BucketType { open, next, closed };
+
+    // An operator prepared for regression through complete states.
+    struct RegressionOperator {
+        int op_index;
+        // facts that must hold in the successor
+        std::vector<FactPair> effects;
+        // preconditions on variables the operator does not change
+        std::vector<FactPair> prevails;
+        // preconditions on effect variables: values restored in the predecessor
+        std::vector<FactPair> restored;
+        // effect variables without precondition: any value in the predecessor
+        std::vector<int> free_vars;
+    };
+
+    struct Frontier {
+        std::string name;
+        int depth = 0;
+        size_t layer_size = 0;
+        std::vector<std::unique_ptr<named_fstream> > open_buckets;
+        std::vector<std::unique_ptr<named_fstream> > next_buckets;
+        std::vector<std::unique_ptr<named_fstream> > closed_buckets;
+    };
+
+    class BidirectionalDDDSearch : public SearchEngine {
+        const int n_buckets;
+        const int max_goal_states;
+        Evaluator *evaluator;
+
+        Frontier forward;
+        Frontier backward;
+        std::vector<RegressionOperator> regression_operators;
+
+        bool solved_initially = false;
+        bool met = false;
+        GlobalState forward_meet;
+        GlobalState backward_meet;
+
+        void create_bucket(Frontier &frontier, int bucket_index,
+                           BucketType bucket_type);
+        void insert_next(Frontier &frontier, const GlobalState &state);
+        void generate_goal_states(std::vector<int> &values,
+                                  const std::vector<int> &free_vars,
+                                  size_t index);
+
+        void expand_layer(Frontier &frontier);
+        void expand_forward(const GlobalState &state);
+        void expand_backward(const GlobalState &state);
+        void advance_layer(Frontier &frontier, Frontier &other);
+        void find_meet(Frontier &frontier, Frontier &other, int bucket_index,
+                       const std::unordered_set<GlobalState> &layer);
+
+        bool find_parent(const Frontier &frontier, const GlobalState &state,
+                         GlobalState &parent) const;
+        std::vector<const GlobalOperator *> trace_path() const;
+
+    protected:
+        virtual void initialize() override;
+        virtual SearchStatus step() override;
+    public:
+        explicit BidirectionalDDDSearch(const options::Options &opts);
+        virtual ~BidirectionalDDDSearch() = default;
+
+        virtual void print_statistics() const override;
+    };
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "external_astar_search.h"
 
+#include "../../evaluation_batch.h"
 #include "../../evaluation_context.h"
 #include "../../globals.h"
 #include "../../heuristic.h"
@@ -7,6 +8,8 @@
 #include "../../option_parser.h"
 #include "../../pruning_method.h"
 #include "../utils/errors.h"
+#include "../../utils/memory.h"
+#include "../../utils/parallel.h"
 
 
 #include "../../algorithms/ordered_set.h"
@@ -18,22 +21,37 @@
 
 using namespace std;
 
+// Nodes handed to the expansion threads at once (per thread)
+const size_t BATCH_ENTRIES_PER_THREAD = 1024;
+
 namespace external_astar_search {
     ExternalAStarSearch::ExternalAStarSearch(const Options &opts)
         : SearchEngine(opts),
           open_list(opts.get<shared_ptr<OpenListFactory> >("open")->
                     create_state_open_list()),
           f_evaluator(opts.get<Evaluator *>("f_eval", nullptr)),
+          num_threads(opts.get<int>("threads")),
           preferred_operator_heuristics(opts.get_list<Heuristic *>("preferred")),
           pruning_method(opts.get<shared_ptr<PruningMethod> >("pruning")) {
     }
 
+    ExternalAStarSearch::~ExternalAStarSearch() {
+    }
+
     void ExternalAStarSearch::initialize() {
-        cout << "Conducting best first search." << endl;
+        cout << "Conducting best first search";
+        if (num_threads > 1)
+            cout << " with " << num_threads << " threads";
+        cout << "." << endl;
         assert(open_list);
 
         set<Heuristic *> hset;
         open_list->get_involved_heuristics(hset);
+        if (f_evaluator)
+            f_evaluator->get_involved_heuristics(successor_heuristics);
+        successor_heuristics.insert(hset.begin(), hset.end());
+        evaluation_batch =
+            utils::make_unique_ptr<EvaluationBatch>(successor_heuristics);
 
         // Add heuristics that are used for preferred operators (in case they are
         // not also used in the open list).
@@ -86,6 +104,9 @@ namespace external_astar_search {
     }
 
     SearchStatus ExternalAStarSearch::step() {
+        if (num_threads > 1)
+            return parallel_step();
+
         pair<GlobalState, bool> n = fetch_next_node();
         if (!n.second) {
             return FAILED;
@@ -120,15 +141,21 @@ namespace external_astar_search {
             collect_preferred_operators(eval_context, preferred_operator_heuristics);
 
         statistics.inc_expanded();
+        vector<GlobalState> successors;
+        successors.reserve(applicable_ops.size());
         for (OperatorID op_id : applicable_ops) {
             const GlobalOperator *op = &g_operators[op_id.get_index()];
-
-            GlobalState succ_state = state_registry.get_successor_state(s, op);
+            successors.push_back(state_registry.get_successor_state(s, op));
             statistics.inc_generated();
-            bool is_preferred = preferred_operators.contains(op_id);
+        }
+        evaluation_batch->evaluate(successors, &statistics);
+
+        for (size_t i = 0; i < successors.size(); ++i) {
+            const GlobalState &succ_state = successors[i];
+            bool is_preferred = preferred_operators.contains(applicable_ops[i]);
 
             EvaluationContext eval_context(
-                                           succ_state, is_preferred, &statistics);
+                *evaluation_batch, i, succ_state, is_preferred, &statistics);
             
             statistics.inc_evaluated_states();
 
@@ -140,7 +167,91 @@ namespace external_astar_search {
         };
     }
 
-        
+
+    SearchStatus ExternalAStarSearch::parallel_step() {
+        vector<GlobalState> nodes;
+        try {
+            open_list->remove_min_batch(nodes,
+                                        num_threads * BATCH_ENTRIES_PER_THREAD);
+        } catch (OpenListEmpty& e) {
+            cout << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+        // all nodes of a batch come from the same bucket
+        update_f_value_statistics(nodes.front());
+
+        for (const GlobalState &s : nodes) {
+            if (check_goal_and_set_plan(s)) {
+                open_list->clear();
+                return SOLVED;
+            }
+        }
+
+        parallel_expand(nodes);
+
+        return IN_PROGRESS;
+    }
+
+    /*
+      Expands the nodes on num_threads threads, each inserting into its own
+      buckets of the open list. Heuristics are evaluated concurrently; the
+      plugin only uses several threads if the heuristic supports this.
+      Statistics are collected per thread and summed up afterwards.
+    */
+    void ExternalAStarSearch::parallel_expand(const vector<GlobalState> &nodes) {
+        vector<SearchStatistics> thread_statistics(num_threads);
+        utils::run_in_parallel(num_threads, [&](int thread_index) {
+                SearchStatistics &local_statistics =
+                    thread_statistics[thread_index];
+                size_t begin = nodes.size() * thread_index / num_threads;
+                size_t end = nodes.size() * (thread_index + 1) / num_threads;
+                EvaluationBatch batch(successor_heuristics);
+                vector<OperatorID> applicable_ops;
+                vector<GlobalState> successors;
+                for (size_t i = begin; i < end; ++i) {
+                    const GlobalState &s = nodes[i];
+                    applicable_ops.clear();
+                    g_successor_generator->generate_applicable_ops(
+                        s, applicable_ops);
+                    pruning_method->prune_operators(s, applicable_ops);
+
+                    local_statistics.inc_expanded();
+                    successors.clear();
+                    for (OperatorID op_id : applicable_ops) {
+                        const GlobalOperator *op =
+                            &g_operators[op_id.get_index()];
+                        successors.push_back(
+                            state_registry.get_successor_state(s, op));
+                        local_statistics.inc_generated();
+                    }
+                    batch.evaluate(successors, &local_statistics);
+
+                    for (size_t j = 0; j < successors.size(); ++j) {
+                        const GlobalState &succ_state = successors[j];
+                        EvaluationContext eval_context(
+                            batch, j, succ_state, false, &local_statistics);
+                        local_statistics.inc_evaluated_states();
+
+                        if (open_list->is_dead_end(eval_context)) {
+                            local_statistics.inc_dead_ends();
+                            continue;
+                        }
+                        open_list->insert_concurrently(
+                            thread_index, eval_context, succ_state);
+                    }
+                }
+            });
+
+        for (const SearchStatistics &local_statistics : thread_statistics) {
+            statistics.inc_expanded(local_statistics.get_expanded());
+            statistics.inc_generated(local_statistics.get_generated());
+            statistics.inc_evaluated_states(
+                local_statistics.get_evaluated_states());
+            statistics.inc_evaluations(local_statistics.get_evaluations());
+            statistics.inc_dead_ends(local_statistics.get_dead_ends());
+        }
+    }
+
     pair<GlobalState, bool> ExternalAStarSearch::fetch_next_node() {
         while (true) {
             try {
@@ -5,8 +5,10 @@
 #include "../../search_engine.h"
 
 #include <memory>
+#include <set>
 #include <vector>
 
+class EvaluationBatch;
 class Evaluator;
 class GlobalOperator;
 class Heuristic;
@@ -21,9 +23,14 @@ namespace external_astar_search {
 
         std::unique_ptr<StateOpenList> open_list;
         Evaluator *f_evaluator;
+        const int num_threads;
         
         std::vector<Heuristic *> heuristics;
         std::vector<Heuristic *> preferred_operator_heuristics;
+        // heuristics of the open list and f_evaluator, which are evaluated
+        // for all successors of a node at once
+        std::set<Heuristic *> successor_heuristics;
+        std::unique_ptr<EvaluationBatch> evaluation_batch;
         std::shared_ptr<PruningMethod> pruning_method;
 
         std::pair<GlobalState, bool> fetch_next_node();
@@ -34,13 +41,15 @@ namespace external_astar_search {
         void print_checkpoint_line(int g) const;
 
         void expand(const GlobalState &node);
+        SearchStatus parallel_step();
+        void parallel_expand(const std::vector<GlobalState> &nodes);
 
     protected:
         virtual void initialize() override;
         virtual SearchStatus step() override;
     public:
         explicit ExternalAStarSearch(const options::Options &opts);
-        virtual ~ExternalAStarSearch() = default;
+        virtual ~ExternalAStarSearch() override;
 
         virtual void print_statistics() const override;
     };
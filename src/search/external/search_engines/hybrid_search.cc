@@ -0,0 +1,229 @@
+#include "hybrid_search.h"
+
+#include "../../evaluation_context.h"
+#include "../../globals.h"
+#include "../../heuristic.h"
+#include "../../open_list_factory.h"
+#include "../closed_list_factory.h"
+#include "../../option_parser.h"
+#include "../../pruning_method.h"
+#include "../../utils/system.h"
+#include "../utils/wall_timer.h"
+
+#include "../../algorithms/ordered_set.h"
+#include "../../task_utils/successor_generator.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <memory>
+
+using namespace std;
+
+// Reading peak memory goes through /proc, so only poll it periodically.
+const size_t MEMORY_CHECK_INTERVAL = 1000; // in expansions
+
+namespace hybrid_search {
+    HybridSearch::HybridSearch(const Options &opts)
+        : SearchEngine(opts),
+          reopen_closed_nodes(opts.get<bool>("reopen_closed")),
+          open_list(opts.get<shared_ptr<OpenListFactory> >("open")->
+                    create_state_open_list()),
+          closed_list(opts.get<shared_ptr<ClosedListFactory> >("closed")->
+                      create_state_closed_list()),
+          external_open_factory(
+              opts.get<shared_ptr<OpenListFactory> >("external_open")),
+          external_closed_factory(
+              opts.get<shared_ptr<ClosedListFactory> >("external_closed")),
+          f_evaluator(opts.get<Evaluator *>("f_eval", nullptr)),
+          memory_threshold_in_kb(opts.get<int>("memory_threshold") * 1024),
+          preferred_operator_heuristics(opts.get_list<Heuristic *>("preferred")),
+          pruning_method(opts.get<shared_ptr<PruningMethod> >("pruning")) {
+    }
+
+    void HybridSearch::initialize() {
+        cout << "Conducting hybrid best first search"
+             << (reopen_closed_nodes ? " with" : " without")
+             << " reopening closed nodes, switching to external memory above "
+             << memory_threshold_in_kb / 1024 << " MiB peak memory"
+             << endl;
+        assert(open_list);
+        assert(closed_list);
+
+        set<Heuristic *> hset;
+        open_list->get_involved_heuristics(hset);
+
+        // Add heuristics that are used for preferred operators (in case they are
+        // not also used in the open list).
+        hset.insert(preferred_operator_heuristics.begin(),
+                    preferred_operator_heuristics.end());
+
+        // Add heuristics that are used in the f_evaluator. They are usually also
+        // used in the open list and are hence already included, but we want to be
+        // sure.
+        if (f_evaluator) {
+            f_evaluator->get_involved_heuristics(hset);
+        }
+
+        heuristics.assign(hset.begin(), hset.end());
+        assert(!heuristics.empty());
+
+        const GlobalState &initial_state = state_registry.get_initial_state();
+
+        for (Heuristic *heuristic : heuristics) {
+            heuristic->notify_initial_state(initial_state);
+        }
+
+        // Note: we consider the initial state as reached by a preferred
+        // operator.
+        EvaluationContext eval_context(initial_state, true, &statistics);
+
+        statistics.inc_evaluated_states();
+
+        if (open_list->is_dead_end(eval_context)) {
+            cout << "Initial state is a dead end." << endl;
+        } else {
+            start_f_value_statistics(eval_context);
+
+            open_list->insert(eval_context, initial_state);
+        }
+
+    }
+
+    void HybridSearch::print_statistics() const {
+        statistics.print_detailed_statistics();
+        cout << "Switched to external memory: "
+             << (switched_to_external ? "yes" : "no") << endl;
+        closed_list->print_statistics();
+    }
+
+    bool HybridSearch::memory_threshold_exceeded() const {
+        return utils::get_peak_memory_in_kb() >= memory_threshold_in_kb;
+    }
+
+    /*
+      Moves all nodes into the external open and closed lists. Open nodes are
+      re-inserted through the regular insertion path, so their f-values are
+      recomputed once. The hash function of the in-memory closed list is kept,
+      such that parent hash values stored in nodes remain valid for path
+      reconstruction in the external closed list.
+    */
+    void HybridSearch::switch_to_external() {
+        utils::WallTimer timer;
+        cout << "Peak memory threshold reached, switching to external memory "
+             << "[t=" << utils::overall_wall_timer << "]" << endl;
+
+        unique_ptr<StateClosedList> external_closed =
+            external_closed_factory->create_state_closed_list();
+        closed_list->transfer_to(*external_closed);
+        closed_list = move(external_closed);
+
+        unique_ptr<StateOpenList> external_open =
+            external_open_factory->create_state_open_list();
+        while (!open_list->empty()) {
+            GlobalState state = open_list->remove_min();
+            EvaluationContext eval_context(state, false, nullptr);
+            external_open->insert(eval_context, state);
+        }
+        open_list = move(external_open);
+
+        switched_to_external = true;
+        cout << "Switched to external memory in " << timer << endl;
+    }
+
+    SearchStatus HybridSearch::step() {
+        pair<GlobalState, bool> n = fetch_next_node();
+        if (!n.second) {
+            return FAILED;
+        }
+
+        GlobalState s = n.first;
+
+        if (check_goal_and_set_plan(s)) {
+            open_list->clear();
+            closed_list->clear();
+            return SOLVED;
+        }
+        bool found, reopened;
+        std::tie(found, reopened) = closed_list->find_insert(s);
+
+        if (found && !reopened) return IN_PROGRESS; // in closed node
+
+        if (reopened) statistics.inc_reopened();
+
+        vector<OperatorID> applicable_ops;
+        g_successor_generator->generate_applicable_ops(s, applicable_ops);
+
+        pruning_method->prune_operators(s, applicable_ops);
+
+        // This evaluates the expanded state (again) to get preferred ops
+        EvaluationContext eval_context(s, false, &statistics, true);
+        ordered_set::OrderedSet<OperatorID> preferred_operators =
+            collect_preferred_operators(eval_context, preferred_operator_heuristics);
+
+        statistics.inc_expanded();
+        for (OperatorID op_id : applicable_ops) {
+            const GlobalOperator *op = &g_operators[op_id.get_index()];
+
+            GlobalState succ_state = state_registry.get_successor_state(s, op);
+            statistics.inc_generated();
+            bool is_preferred = preferred_operators.contains(op_id);
+
+            EvaluationContext eval_context(
+                                           succ_state, is_preferred, &statistics);
+            statistics.inc_evaluated_states();
+
+            if (open_list->is_dead_end(eval_context)) {
+                statistics.inc_dead_ends();
+                continue;
+            }
+
+            open_list->insert(eval_context, succ_state);
+
+        }
+
+        if (!switched_to_external &&
+            statistics.get_expanded() % MEMORY_CHECK_INTERVAL == 0 &&
+            memory_threshold_exceeded())
+            switch_to_external();
+
+        return IN_PROGRESS;
+    }
+
+
+    pair<GlobalState, bool> HybridSearch::fetch_next_node() {
+        if (open_list->empty()) {
+            cout << "Completely explored state space -- no solution!" << endl;
+            return make_pair(GlobalState(), false);
+        }
+
+        GlobalState state = open_list->remove_min();
+        update_f_value_statistics(state);
+        return make_pair(state, true);
+    }
+
+
+    bool HybridSearch::check_goal_and_set_plan(const GlobalState &state) {
+        if (test_goal(state)) {
+            cout << "Solution found!" << endl;
+            set_plan(closed_list->trace_path(state));
+            return true;
+        }
+        return false;
+    }
+
+    void HybridSearch::start_f_value_statistics(EvaluationContext &eval_context) {
+        if (f_evaluator) {
+            int f_value = eval_context.get_heuristic_value(f_evaluator);
+            statistics.report_f_value_progress(f_value);
+        }
+    }
+
+    // remove_min only returns the state, so its f value is computed again.
+    void HybridSearch::update_f_value_statistics(const GlobalState &state) {
+        if (f_evaluator) {
+            EvaluationContext eval_context(state, false, &statistics);
+            int f_value = eval_context.get_heuristic_value(f_evaluator);
+            statistics.report_f_value_progress(f_value);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef EXTERNAL_SEARCH_ENGINES_HYBRID_SEARCH_H
+#define EXTERNAL_SEARCH_ENGINES_HYBRID_SEARCH_H
+
+#include "../../open_list.h"
+#include "../closed_list.h"
+#include "../../search_engine.h"
+
+#include <memory>
+#include <vector>
+
+class ClosedListFactory;
+class Evaluator;
+class GlobalOperator;
+class Heuristic;
+class OpenListFactory;
+class PruningMethod;
+
+namespace options {
+    class Options;
+}
+/*
+  Lazy best first search that starts out with in-memory open and closed lists
+  and moves all of their nodes into external ones (e.g. the external
+  tie-breaking open list and the compress closed list) once peak memory
+  exceeds a threshold. Small tasks are thus solved at RAM speed, while larger
+  ones continue as A*-IDD.
+*/
+namespace hybrid_search {
+    class HybridSearch : public SearchEngine {
+        const bool reopen_closed_nodes;
+
+        std::unique_ptr<StateOpenList> open_list;
+        std::unique_ptr<StateClosedList> closed_list;
+        std::shared_ptr<OpenListFactory> external_open_factory;
+        std::shared_ptr<ClosedListFactory> external_closed_factory;
+        Evaluator *f_evaluator;
+
+        const int memory_threshold_in_kb;
+        bool switched_to_external = false;
+
+        std::vector<Heuristic *> heuristics;
+        std::vector<Heuristic *> preferred_operator_heuristics;
+        std::shared_ptr<PruningMethod> pruning_method;
+
+        std::pair<GlobalState, bool> fetch_next_node();
+        bool check_goal_and_set_plan(const GlobalState &state);
+
+        void start_f_value_statistics(EvaluationContext &eval_context);
+        void update_f_value_statistics(const GlobalState &node);
+
+        bool memory_threshold_exceeded() const;
+        void switch_to_external();
+
+    protected:
+        virtual void initialize() override;
+        virtual SearchStatus step() override;
+    public:
+        explicit HybridSearch(const options::Options &opts);
+        virtual ~HybridSearch() = default;
+
+        virtual void print_statistics() const override;
+    };
+}
+
+#endif
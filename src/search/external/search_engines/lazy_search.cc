@@ -1,5 +1,6 @@
 #include "lazy_search.h"
 
+#include "../../evaluation_batch.h"
 #include "../../evaluation_context.h"
 #include "../../globals.h"
 #include "../../heuristic.h"
@@ -7,13 +8,18 @@
 #include "../closed_list_factory.h"
 #include "../../option_parser.h"
 #include "../../pruning_method.h"
+#include "../utils/block_reader.h"
+#include "../utils/named_fstream.h"
+#include "../utils/errors.h"
 
 #include "../../algorithms/ordered_set.h" // what is this for>
 #include "../../task_utils/successor_generator.h"
+#include "../../utils/memory.h"
 
 #include <cassert>
 #include <cstdlib>
 #include <memory>
+#include <limits>
 
 using namespace std;
 
@@ -26,10 +32,16 @@ namespace lazy_search {
           closed_list(opts.get<shared_ptr<ClosedListFactory> >("closed")->
                       create_state_closed_list()),
           f_evaluator(opts.get<Evaluator *>("f_eval", nullptr)),
+          h_evaluator(opts.get<Evaluator *>("eval")),
+          anytime_open_factories(
+              opts.get<vector<shared_ptr<OpenListFactory> > >("anytime_open")),
           preferred_operator_heuristics(opts.get_list<Heuristic *>("preferred")),
           pruning_method(opts.get<shared_ptr<PruningMethod> >("pruning")) {
     }
 
+    LazySearch::~LazySearch() {
+    }
+
     void LazySearch::initialize() {
         cout << "Conducting best first search"
              << (reopen_closed_nodes ? " with" : " without")
@@ -56,6 +68,14 @@ namespace lazy_search {
         heuristics.assign(hset.begin(), hset.end());
         assert(!heuristics.empty());
 
+        set<Heuristic *> successor_heuristics;
+        open_list->get_involved_heuristics(successor_heuristics);
+        if (f_evaluator)
+            f_evaluator->get_involved_heuristics(successor_heuristics);
+        h_evaluator->get_involved_heuristics(successor_heuristics);
+        evaluation_batch =
+            utils::make_unique_ptr<EvaluationBatch>(successor_heuristics);
+
         const GlobalState &initial_state = state_registry.get_initial_state();
         
         for (Heuristic *heuristic : heuristics) {
@@ -89,15 +109,73 @@ namespace lazy_search {
         closed_list->print_statistics();
     }
 
+    void LazySearch::save_plan_if_necessary() const {
+        // In anytime mode, each improving plan is saved when it is found.
+        if (!is_anytime())
+            SearchEngine::save_plan_if_necessary();
+    }
+
+    bool LazySearch::is_anytime() const {
+        return !anytime_open_factories.empty();
+    }
+
+    // Nodes that cannot lead to a plan cheaper than bound are pruned
+    bool LazySearch::exceeds_bound(EvaluationContext &eval_context) {
+        if (bound == numeric_limits<int>::max()) return false;
+        if (eval_context.is_heuristic_infinite(h_evaluator)) return true;
+        return eval_context.get_g_value() +
+            eval_context.get_heuristic_value(h_evaluator) >= bound;
+    }
+
+    /*
+      Continues the search with the next (smaller) weight. Open nodes are
+      stashed on disk and reinserted into an open list ordered by the new
+      weight, while the closed list, together with its best known g values,
+      is kept, so that only nodes reached more cheaply are reexpanded.
+    */
+    void LazySearch::tighten_weight() {
+        named_fstream stash("open_list_buckets/anytime.bucket");
+        while (!open_list->empty()) {
+            GlobalState state = open_list->remove_min();
+            EvaluationContext eval_context(state, false, &statistics);
+            if (!exceeds_bound(eval_context) && !state.write(stash))
+                throw IOException("Fail to write state to fstream.");
+        }
+        open_list = anytime_open_factories[next_anytime_open++]->
+            create_state_open_list();
+
+        stash.clear();
+        stash.seekg(0, ios::beg);
+        GlobalState state;
+        BlockReader<GlobalState> reader(stash);
+        while (reader.read(state)) {
+            EvaluationContext eval_context(state, false, &statistics);
+            open_list->insert(eval_context, state);
+        }
+        cout << "Anytime search: continuing with weight "
+             << anytime_open_factories.size() - next_anytime_open + 1
+             << " and bound " << bound << endl;
+    }
+
     SearchStatus LazySearch::step() {
         pair<GlobalState, bool> n = fetch_next_node();
         if (!n.second) {
+            if (found_solution()) {
+                // anytime search exhausted the bounded state space
+                closed_list->clear();
+                return SOLVED;
+            }
             return FAILED;
         }
 
         GlobalState s = n.first;
         
         if (check_goal_and_set_plan(s)) {
+            if (is_anytime() &&
+                next_anytime_open < anytime_open_factories.size()) {
+                tighten_weight();
+                return IN_PROGRESS;
+            }
             open_list->clear();
             closed_list->clear();
             return SOLVED;
@@ -124,15 +202,21 @@ namespace lazy_search {
             collect_preferred_operators(eval_context, preferred_operator_heuristics);
 
         statistics.inc_expanded();
+        vector<GlobalState> successors;
+        successors.reserve(applicable_ops.size());
         for (OperatorID op_id : applicable_ops) {
             const GlobalOperator *op = &g_operators[op_id.get_index()];
-
-            GlobalState succ_state = state_registry.get_successor_state(s, op);
+            successors.push_back(state_registry.get_successor_state(s, op));
             statistics.inc_generated();
-            bool is_preferred = preferred_operators.contains(op_id);
+        }
+        evaluation_batch->evaluate(successors, &statistics);
+
+        for (size_t i = 0; i < successors.size(); ++i) {
+            const GlobalState &succ_state = successors[i];
+            bool is_preferred = preferred_operators.contains(applicable_ops[i]);
             
             EvaluationContext eval_context(
-                                           succ_state, is_preferred, &statistics);
+                *evaluation_batch, i, succ_state, is_preferred, &statistics);
             statistics.inc_evaluated_states();
 
             if (open_list->is_dead_end(eval_context)) {
@@ -140,6 +224,8 @@ namespace lazy_search {
                 continue;
             }
 
+            if (exceeds_bound(eval_context)) continue;
+
             open_list->insert(eval_context, succ_state);
             
         }
@@ -151,7 +237,11 @@ namespace lazy_search {
     pair<GlobalState, bool> LazySearch::fetch_next_node() {
         while (true) {
             if (open_list->empty()) {
-                cout << "Completely explored state space -- no solution!" << endl;
+                if (found_solution())
+                    cout << "Completely explored state space -- "
+                         << "last plan found is optimal" << endl;
+                else
+                    cout << "Completely explored state space -- no solution!" << endl;
                 return make_pair(GlobalState(), false);
             }
 
@@ -166,6 +256,10 @@ namespace lazy_search {
         if (test_goal(state)) {
             cout << "Solution found!" << endl;
             set_plan(closed_list->trace_path(state));
+            if (is_anytime()) {
+                save_plan(get_plan(), true);
+                bound = calculate_plan_cost(get_plan());
+            }
             return true;
         }
             return false;
@@ -6,11 +6,14 @@
 #include "../../search_engine.h"
 
 #include <memory>
+#include <set>
 #include <vector>
 
+class EvaluationBatch;
 class Evaluator;
 class GlobalOperator;
 class Heuristic;
+class OpenListFactory;
 class PruningMethod;
 
 namespace options {
@@ -24,10 +27,19 @@ namespace lazy_search {
         std::unique_ptr<StateOpenList> open_list;
         std::unique_ptr<StateClosedList> closed_list;
         Evaluator *f_evaluator;
-        
+        Evaluator *h_evaluator;
+
+        // Anytime mode: open lists for the remaining, decreasing weights.
+        // After each solution, search continues on the next one.
+        std::vector<std::shared_ptr<OpenListFactory> > anytime_open_factories;
+        std::size_t next_anytime_open = 0;
+
         std::vector<Heuristic *> heuristics;
         std::vector<Heuristic *> preferred_operator_heuristics;
         std::shared_ptr<PruningMethod> pruning_method;
+        // evaluates the heuristics of the open list, f_evaluator and
+        // h_evaluator for all successors of a node at once
+        std::unique_ptr<EvaluationBatch> evaluation_batch;
 
         std::pair<GlobalState, bool> fetch_next_node();
         bool check_goal_and_set_plan(const GlobalState &state);
@@ -36,14 +48,19 @@ namespace lazy_search {
         void update_f_value_statistics(const GlobalState &node);
         void print_checkpoint_line(int g) const;
 
+        bool is_anytime() const;
+        bool exceeds_bound(EvaluationContext &eval_context);
+        void tighten_weight();
+
     protected:
         virtual void initialize() override;
         virtual SearchStatus step() override;
     public:
         explicit LazySearch(const options::Options &opts);
-        virtual ~LazySearch() = default;
+        virtual ~LazySearch() override;
 
         virtual void print_statistics() const override;
+        virtual void save_plan_if_necessary() const override;
     };
 }
 
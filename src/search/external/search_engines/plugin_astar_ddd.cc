@@ -12,10 +12,11 @@ namespace plugin_astar_ddd {
 static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "A*-DDD (Korf, Hatem)  search with hashed-based delayed duplicate detection",
-        "A* is a best first search that uses g+h "
-        "as f-function.");
+        "A* is a best first search that uses g+w*h "
+        "as f-function. For w > 1, plan cost is at most w times optimal.");
 
     parser.add_option<Evaluator *>("eval", "evaluator for h-value");
+    parser.add_option<int>("w", "evaluator weight, f = g + w * h", "1");
 
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
@@ -12,11 +12,18 @@ namespace plugin_astar_idd {
 static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "External A* search (lazy) with SSD using compress closed list",
-        "A* is a best first search that uses g+h "
-        "as f-function. "
+        "A* is a best first search that uses g+w*h "
+        "as f-function. For w > 1, plan cost is at most w times optimal. "
         "We break ties using the evaluator. Closed nodes are re-opened.");
 
     parser.add_option<Evaluator *>("eval", "evaluator for h-value");
+    parser.add_option<int>("w", "evaluator weight, f = g + w * h", "1");
+    parser.add_option<bool>(
+        "anytime",
+        "after each solution, continue with weight w - 1 (down to 1) on the "
+        "same closed list, pruning nodes with g + h not below the best plan "
+        "cost found so far",
+        "false");
 
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
@@ -31,6 +38,8 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         opts.set("open", get<0>(temp));
         opts.set("closed", get<1>(temp));
         opts.set("f_eval", get<2>(temp));
+        opts.set("anytime_open",
+                 search_common::create_anytime_open_list_factories(opts));
         vector<Heuristic *> preferred_list;
         opts.set("preferred", preferred_list);
         engine = make_shared<lazy_search::LazySearch>(opts);
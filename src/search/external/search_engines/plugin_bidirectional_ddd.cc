@@ -0,0 +1,47 @@
+#include "bidirectional_ddd_search.h"
+
+#include "../../option_parser.h"
+#include "../../plugin.h"
+
+using namespace std;
+
+namespace plugin_bidirectional_ddd {
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Bidirectional breadth-first search with hash-based delayed "
+        "duplicate detection",
+        "Runs breadth-first layers forward from the initial state and "
+        "backward from all goal states, keeping both frontiers in hash "
+        "bucket files. Plans are optimal for unit-cost tasks without axioms "
+        "and conditional effects, the only tasks supported. Layers are "
+        "expanded in breadth-first order, not ordered by f as in A*-DDD. "
+        "The backward search starts from every complete goal state, so "
+        "tasks whose goal leaves many variables free are rejected (see "
+        "max_goal_states).");
+
+    parser.add_option<Evaluator *>(
+        "eval",
+        "evaluator used only to prune forward dead ends; it does not order "
+        "the layers (Optional; if no evaluator is used, nothing is pruned.)",
+        OptionParser::NONE);
+    parser.add_option<int>(
+        "buckets", "number of hash buckets per direction", "20",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "max_goal_states",
+        "reject the task if the variables the goal leaves free allow more "
+        "complete goal states than this",
+        "1000000", Bounds("1", "infinity"));
+
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    shared_ptr<bidirectional_ddd_search::BidirectionalDDDSearch> engine;
+    if (!parser.dry_run())
+        engine = make_shared<bidirectional_ddd_search::BidirectionalDDDSearch>(opts);
+
+    return engine;
+}
+
+static PluginShared<SearchEngine> _plugin("bidirectional_ddd", _parse);
+}
@@ -1,9 +1,13 @@
 #include "external_astar_search.h"
 #include "../../search_engines/search_common.h"
 
+#include "../../evaluator.h"
+#include "../../globals.h"
 #include "../../option_parser.h"
 #include "../../plugin.h"
 
+#include "../../utils/parallel.h"
+
 #include <tuple>
 
 using namespace std;
@@ -12,10 +16,25 @@ namespace plugin_external_astar {
 static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Edelkamp's External A* search with delayed duplicate detection",
-        "A* is a best first search that uses g+h "
-        "as f-function.");
+        "A* is a best first search that uses g+w*h "
+        "as f-function. For w > 1, plan cost is at most w times optimal.");
 
     parser.add_option<Evaluator *>("eval", "evaluator for h-value");
+    parser.add_option<int>("w", "evaluator weight, f = g + w * h", "1");
+    parser.add_option<int>(
+        "threads",
+        "number of threads for sorting, merging and expanding buckets "
+        "(0 uses all hardware threads). With more than one thread, the "
+        "heuristic is evaluated concurrently. Heuristics that do not "
+        "support this (all but blind, PDB, CPDB and M&S heuristics) fall "
+        "back to 1 thread.",
+        "1",
+        Bounds("0", "infinity"));
+    parser.add_option<bool>(
+        "compress",
+        "delta code the records of sorted buckets, which reduces disk space "
+        "and I/O at some CPU cost",
+        "false");
 
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
@@ -24,6 +43,19 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     shared_ptr<external_astar_search::ExternalAStarSearch> engine;
     if (!parser.dry_run()) {
         opts.set("reopen_closed", true); // engine, open & closed depends on this
+        if (opts.get<int>("threads") == 0)
+            opts.set("threads", utils::get_hardware_threads());
+        if (opts.get<int>("threads") > 1 && has_axioms()) {
+            // the axiom evaluator keeps its queue in a member variable
+            cout << "Axioms are evaluated serially, using 1 thread." << endl;
+            opts.set("threads", 1);
+        }
+        if (opts.get<int>("threads") > 1 &&
+            !opts.get<Evaluator *>("eval")->supports_concurrent_evaluation()) {
+            cout << "The heuristic does not support concurrent evaluation, "
+                 << "using 1 thread." << endl;
+            opts.set("threads", 1);
+        }
         auto temp =
             search_common::
             create_external_astar_open_list_factory_and_f_eval(opts);
@@ -0,0 +1,48 @@
+#include "lazy_search.h"
+#include "../../search_engines/search_common.h"
+
+#include "../../option_parser.h"
+#include "../../plugin.h"
+
+#include <tuple>
+
+using namespace std;
+
+namespace plugin_external_greedy {
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "External greedy best-first search (lazy) using compress closed list",
+        "Expands nodes in order of their h-value, most recently generated "
+        "first. Nodes are kept in bucket files on disk, duplicates are "
+        "detected immediately by the compress closed list. Closed nodes "
+        "are not re-opened.");
+
+    parser.add_option<Evaluator *>("eval", "evaluator for h-value");
+    parser.add_list_option<Heuristic *>(
+        "preferred",
+        "use preferred operators of these heuristics", "[]");
+    parser.add_option<int>(
+        "boost",
+        "boost value for the preferred successor queue, applied "
+        "whenever a new best h-value is found",
+        "1000");
+
+    SearchEngine::add_pruning_option(parser);
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    shared_ptr<lazy_search::LazySearch> engine;
+    if (!parser.dry_run()) {
+        opts.set("reopen_closed", false); // engine & closed depend on this
+        auto temp = search_common::create_greedy_factories(opts);
+        opts.set("open", get<0>(temp));
+        opts.set("closed", get<1>(temp));
+        opts.set("anytime_open", vector<shared_ptr<OpenListFactory> >());
+        engine = make_shared<lazy_search::LazySearch>(opts);
+    }
+
+    return engine;
+}
+
+static PluginShared<SearchEngine> _plugin("external_greedy", _parse);
+}
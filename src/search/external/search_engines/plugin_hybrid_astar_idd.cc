@@ -0,0 +1,54 @@
+#include "hybrid_search.h"
+#include "../../search_engines/search_common.h"
+
+#include "../../option_parser.h"
+#include "../../plugin.h"
+
+#include <tuple>
+
+using namespace std;
+
+namespace plugin_hybrid_astar_idd {
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Hybrid A* search that switches to A*-IDD when memory runs low",
+        "A* is a best first search that uses g+w*h "
+        "as f-function. For w > 1, plan cost is at most w times optimal. "
+        "Open and closed lists are kept in memory until peak memory reaches "
+        "memory_threshold, after which all nodes are moved to the external "
+        "tie-breaking open list and the compress closed list. Note that the "
+        "compress closed list allocates its pointer table on the switch, so "
+        "the threshold should leave room for it. Closed nodes are re-opened.");
+
+    parser.add_option<Evaluator *>("eval", "evaluator for h-value");
+    parser.add_option<int>("w", "evaluator weight, f = g + w * h", "1");
+    parser.add_option<int>(
+        "memory_threshold",
+        "peak memory in MiB above which the search switches to external memory",
+        "2048");
+
+    SearchEngine::add_pruning_option(parser);
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    shared_ptr<hybrid_search::HybridSearch> engine;
+    if (!parser.dry_run()) {
+        opts.set("reopen_closed", true); // engine, open & closed depends on this
+        auto temp =
+            search_common::
+            create_hybrid_factories_and_f_eval(opts);
+        opts.set("open", get<0>(temp));
+        opts.set("closed", get<1>(temp));
+        opts.set("external_open", get<2>(temp));
+        opts.set("external_closed", get<3>(temp));
+        opts.set("f_eval", get<4>(temp));
+        vector<Heuristic *> preferred_list;
+        opts.set("preferred", preferred_list);
+        engine = make_shared<hybrid_search::HybridSearch>(opts);
+    }
+
+    return engine;
+}
+
+static PluginShared<SearchEngine> _plugin("hybrid_astar_idd", _parse);
+}
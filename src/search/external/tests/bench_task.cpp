@@ -0,0 +1,155 @@
+#include "bench_task.h"
+
+#include "cstdlib"
+#include "fstream"
+#include "iostream"
+#include "random"
+
+using namespace std;
+
+static void expect(istream &in, const string &word) {
+    string token;
+    in >> token;
+    if (token != word) {
+        cerr << "expected " << word << ", got " << token << endl;
+        exit(1);
+    }
+}
+
+static void skip_section(istream &in, const string &end) {
+    string token;
+    while (in >> token && token != end) {
+    }
+}
+
+// Reads the translator's output format, see the planner's globals.cc.
+BenchTask::BenchTask(istream &in) {
+    expect(in, "begin_version");
+    skip_section(in, "end_version");
+    expect(in, "begin_metric");
+    bool use_metric;
+    in >> use_metric;
+    expect(in, "end_metric");
+    int num_variables;
+    in >> num_variables;
+    for (int var = 0; var < num_variables; ++var) {
+        expect(in, "begin_variable");
+        string name;
+        int axiom_layer, range;
+        in >> name >> axiom_layer >> range;
+        domains.push_back(range);
+        skip_section(in, "end_variable");
+    }
+    int num_mutex_groups;
+    in >> num_mutex_groups;
+    for (int i = 0; i < num_mutex_groups; ++i)
+        skip_section(in, "end_mutex_group");
+    expect(in, "begin_state");
+    initial_state.resize(num_variables);
+    for (int var = 0; var < num_variables; ++var)
+        in >> initial_state[var];
+    expect(in, "end_state");
+    expect(in, "begin_goal");
+    int num_goals;
+    in >> num_goals;
+    for (int i = 0; i < num_goals; ++i) {
+        int var, value;
+        in >> var >> value;
+        goals.emplace_back(var, value);
+    }
+    expect(in, "end_goal");
+    int num_operators;
+    in >> num_operators;
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        BenchOperator op;
+        expect(in, "begin_operator");
+        in >> ws;
+        string name;
+        getline(in, name);
+        int num_prevails;
+        in >> num_prevails;
+        for (int i = 0; i < num_prevails; ++i) {
+            int var, value;
+            in >> var >> value;
+            op.preconditions.emplace_back(var, value);
+        }
+        int num_effects;
+        in >> num_effects;
+        for (int i = 0; i < num_effects; ++i) {
+            BenchEffect effect {vector<FactPair>(), FactPair(-1, -1)};
+            int num_conditions;
+            in >> num_conditions;
+            for (int j = 0; j < num_conditions; ++j) {
+                int var, value;
+                in >> var >> value;
+                effect.conditions.emplace_back(var, value);
+            }
+            int var, pre, post;
+            in >> var >> pre >> post;
+            if (pre != -1)
+                op.preconditions.emplace_back(var, pre);
+            effect.fact = FactPair(var, post);
+            op.effects.push_back(effect);
+        }
+        in >> op.cost;
+        if (!use_metric)
+            op.cost = 1;
+        expect(in, "end_operator");
+        operators.push_back(op);
+    }
+}
+
+bool BenchTask::has_conditional_effects() const {
+    for (const BenchOperator &op : operators) {
+        for (const BenchEffect &effect : op.effects) {
+            if (!effect.conditions.empty())
+                return true;
+        }
+    }
+    return false;
+}
+
+BenchTask read_bench_task(const string &file_name) {
+    ifstream in(file_name);
+    if (!in) {
+        cerr << "could not open " << file_name << endl;
+        exit(1);
+    }
+    return BenchTask(in);
+}
+
+bool holds(const vector<FactPair> &facts, const vector<int> &values) {
+    for (const FactPair &fact : facts)
+        if (values[fact.var] != fact.value)
+            return false;
+    return true;
+}
+
+void sample_states(
+    const BenchTask &task, int num_states, int walk_length,
+    const function<void(const vector<int> &)> &visit) {
+    mt19937 rng(42);
+    vector<int> values = task.initial_state;
+    vector<int> successor;
+    vector<int> applicable;
+    for (int sample = 0; sample < num_states; ++sample) {
+        if (sample % walk_length == 0)
+            values = task.initial_state;
+        visit(values);
+        applicable.clear();
+        for (size_t op_id = 0; op_id < task.operators.size(); ++op_id)
+            if (holds(task.operators[op_id].preconditions, values))
+                applicable.push_back(op_id);
+        if (applicable.empty()) {
+            values = task.initial_state;
+            continue;
+        }
+        const BenchOperator &op =
+            task.operators[applicable[rng() % applicable.size()]];
+        successor = values;
+        for (const BenchEffect &effect : op.effects)
+            if (holds(effect.conditions, values))
+                successor[effect.fact.var] = effect.fact.value;
+        values.swap(successor);
+    }
+}
@@ -0,0 +1,123 @@
+// Translated tasks for the benchmarks: reads output.sas files into an
+// AbstractTask without the planner's globals and samples states by
+// random walks from the initial state.
+#ifndef EXTERNAL_TESTS_BENCH_TASK_H
+#define EXTERNAL_TESTS_BENCH_TASK_H
+
+#include "../../abstract_task.h"
+#include "functional"
+#include "istream"
+#include "string"
+#include "vector"
+
+struct BenchEffect {
+    std::vector<FactPair> conditions;
+    FactPair fact;
+};
+
+struct BenchOperator {
+    std::vector<FactPair> preconditions;
+    std::vector<BenchEffect> effects;
+    int cost;
+};
+
+// Variables, initial state, goals and operators; axioms are not supported
+class BenchTask : public AbstractTask {
+public:
+    std::vector<int> domains;
+    std::vector<int> initial_state;
+    std::vector<FactPair> goals;
+    std::vector<BenchOperator> operators;
+
+    explicit BenchTask(std::istream &in);
+
+    bool has_conditional_effects() const;
+
+    virtual int get_num_variables() const override {
+        return domains.size();
+    }
+    virtual std::string get_variable_name(int) const override {
+        return "";
+    }
+    virtual int get_variable_domain_size(int var) const override {
+        return domains[var];
+    }
+    virtual int get_variable_axiom_layer(int) const override {
+        return -1;
+    }
+    virtual int get_variable_default_axiom_value(int) const override {
+        return 0;
+    }
+    virtual std::string get_fact_name(const FactPair &) const override {
+        return "";
+    }
+    virtual bool are_facts_mutex(const FactPair &, const FactPair &) const override {
+        return false;
+    }
+    virtual int get_operator_cost(int index, bool) const override {
+        return operators[index].cost;
+    }
+    virtual std::string get_operator_name(int, bool) const override {
+        return "";
+    }
+    virtual int get_num_operators() const override {
+        return operators.size();
+    }
+    virtual int get_num_operator_preconditions(int index, bool) const override {
+        return operators[index].preconditions.size();
+    }
+    virtual FactPair get_operator_precondition(
+        int op_index, int fact_index, bool) const override {
+        return operators[op_index].preconditions[fact_index];
+    }
+    virtual int get_num_operator_effects(int op_index, bool) const override {
+        return operators[op_index].effects.size();
+    }
+    virtual int get_num_operator_effect_conditions(
+        int op_index, int eff_index, bool) const override {
+        return operators[op_index].effects[eff_index].conditions.size();
+    }
+    virtual FactPair get_operator_effect_condition(
+        int op_index, int eff_index, int cond_index, bool) const override {
+        return operators[op_index].effects[eff_index].conditions[cond_index];
+    }
+    virtual FactPair get_operator_effect(
+        int op_index, int eff_index, bool) const override {
+        return operators[op_index].effects[eff_index].fact;
+    }
+    virtual OperatorID get_global_operator_id(OperatorID id) const override {
+        return id;
+    }
+    virtual int get_num_axioms() const override {
+        return 0;
+    }
+    virtual int get_num_goals() const override {
+        return goals.size();
+    }
+    virtual FactPair get_goal_fact(int index) const override {
+        return goals[index];
+    }
+    virtual std::vector<int> get_initial_state_values() const override {
+        return initial_state;
+    }
+    virtual void convert_state_values(std::vector<int> &,
+                                      const AbstractTask *) const override {
+    }
+};
+
+// Reads the task from the given file and exits if it cannot be opened.
+BenchTask read_bench_task(const std::string &file_name);
+
+bool holds(const std::vector<FactPair> &facts, const std::vector<int> &values);
+
+/*
+  Calls visit with the values of num_states states sampled by random
+  walks of walk_length steps from the initial state. A walk that reaches
+  a state without applicable operators restarts from the initial state.
+  The walks use a fixed seed, so every run sees the same states.
+*/
+void sample_states(
+    const BenchTask &task, int num_states, int walk_length,
+    const std::function<void(const std::vector<int> &)> &visit);
+
+#endif
@@ -1,3 +1,7 @@
 #!/bin/bash
 
 g++ -std=c++11 -o pointer_table_test  pointer_table_test.cpp ../closed_lists/compress/pointer_table.cc ../utils/wall_timer.cc
+g++ -std=c++11 -O2 -o hash_benchmark hash_benchmark.cpp ../../algorithms/int_packer.cc
+g++ -std=c++11 -O2 -DEXTERNAL_SEARCH -o successor_generator_benchmark successor_generator_benchmark.cpp bench_task.cpp ../../task_utils/successor_generator.cc ../../global_state.cc ../../state_id.cc ../../algorithms/int_packer.cc
+g++ -std=c++11 -O2 -pthread -o pdb_lookup_benchmark pdb_lookup_benchmark.cpp bench_task.cpp ../../pdbs/pattern_database.cc ../../pdbs/match_tree.cc ../../task_utils/task_properties.cc ../../algorithms/int_packer.cc ../../utils/math.cc ../../utils/system.cc ../../utils/system_unix.cc ../../utils/timer.cc ../../utils/table_file.cc ../../utils/logging.cc
+g++ -std=c++11 -O2 -o lm_cut_benchmark lm_cut_benchmark.cpp bench_task.cpp ../../heuristics/lm_cut_landmarks.cc ../../task_utils/task_properties.cc ../../utils/system.cc ../../utils/system_unix.cc ../../utils/logging.cc ../../utils/timer.cc
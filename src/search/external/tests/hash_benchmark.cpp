@@ -0,0 +1,85 @@
+// Microbenchmark for state hash functions: Zobrist hashing over unpacked
+// variables vs. tabulation hashing over packed bytes
+#include "../hash_functions/tabulation.h"
+#include "../hash_functions/zobrist.h"
+#include "../../algorithms/int_packer.h"
+#include "iostream"
+#include "chrono"
+#include "random"
+#include "vector"
+
+using namespace std;
+using namespace statehash;
+
+// normally read from the task by globals.cc
+vector<int> g_variable_domain;
+
+using Bin = int_packer::IntPacker::Bin;
+
+// Minimal node offering what the hash functions need from GlobalState
+class BenchEntry {
+    vector<Bin> bins;
+public:
+    static int_packer::IntPacker *packer;
+
+    explicit BenchEntry(const vector<int> &values)
+        : bins(packer->get_num_bins(), 0) {
+        for (size_t var = 0; var < values.size(); ++var)
+            packer->set(bins.data(), var, values[var]);
+    }
+    int operator[](int var) const {
+        return packer->get(bins.data(), var);
+    }
+    const Bin *get_packed_buffer() const {
+        return bins.data();
+    }
+    static size_t get_packedState_bytes() {
+        return packer->get_num_bins() * sizeof(Bin);
+    }
+};
+
+int_packer::IntPacker *BenchEntry::packer = nullptr;
+
+template<class Hash>
+void run(const string &name, const Hash &hash,
+         const vector<BenchEntry> &entries, int rounds) {
+    size_t checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+        for (const BenchEntry &entry : entries)
+            checksum += hash(entry);
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+    cout << name << ": " << elapsed.count() / (entries.size() * rounds)
+         << " ns/state (checksum " << checksum << ")" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int num_vars = argc > 1 ? stoi(argv[1]) : 60;
+    const int num_states = 100000;
+    const int rounds = 20;
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> domain_dis(2, 12);
+    for (int var = 0; var < num_vars; ++var)
+        g_variable_domain.push_back(domain_dis(rng));
+    int_packer::IntPacker packer(g_variable_domain);
+    BenchEntry::packer = &packer;
+
+    vector<BenchEntry> entries;
+    entries.reserve(num_states);
+    vector<int> values(num_vars);
+    for (int i = 0; i < num_states; ++i) {
+        for (int var = 0; var < num_vars; ++var)
+            values[var] = rng() % g_variable_domain[var];
+        entries.emplace_back(values);
+    }
+
+    cout << num_vars << " variables packed into "
+         << BenchEntry::get_packedState_bytes() << " bytes" << endl;
+    ZobristHash<BenchEntry> zobrist;
+    TabulationHash<BenchEntry> tabulation;
+    run("Zobrist", zobrist, entries, rounds);
+    run("Tabulation", tabulation, entries, rounds);
+    return 0;
+}
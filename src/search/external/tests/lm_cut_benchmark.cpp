@@ -0,0 +1,76 @@
+// Benchmark for the LM-cut landmark computation on translated tasks:
+// computes the LM-cut value of states sampled by random walks and reports
+// the time per state, the average value and the average number of cuts.
+// Usage: lm_cut_benchmark output.sas [output.sas ...]
+#include "../../heuristics/lm_cut_landmarks.h"
+#include "bench_task.h"
+#include "iostream"
+#include "chrono"
+#include "string"
+#include "vector"
+
+using namespace std;
+
+static void benchmark(const string &file_name) {
+    BenchTask task = read_bench_task(file_name);
+    if (task.has_conditional_effects()) {
+        cerr << file_name << ": conditional effects are not supported"
+             << endl;
+        exit(1);
+    }
+
+    auto start = chrono::steady_clock::now();
+    lm_cut_heuristic::LandmarkCutLandmarks landmarks((TaskProxy(task)));
+    chrono::duration<double, milli> build_time =
+        chrono::steady_clock::now() - start;
+
+    // random walks from the initial state
+    const int num_states = 2000;
+    const int walk_length = 50;
+    vector<State> states;
+    states.reserve(num_states);
+    sample_states(task, num_states, walk_length,
+                  [&](const vector<int> &values) {
+                      states.emplace_back(task, vector<int>(values));
+                  });
+
+    const int rounds = 3;
+    long long total_value = 0;
+    long long num_cuts = 0;
+    int num_dead_ends = 0;
+    start = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const State &state : states) {
+            bool dead_end = landmarks.compute_landmarks(
+                state,
+                [&](int cut_cost) {
+                    total_value += cut_cost;
+                    ++num_cuts;
+                },
+                nullptr);
+            if (dead_end)
+                ++num_dead_ends;
+        }
+    }
+    chrono::duration<double, nano> compute_time =
+        chrono::steady_clock::now() - start;
+
+    size_t num_computations = states.size() * rounds;
+    cout << file_name << ": " << task.domains.size() << " variables, "
+         << task.operators.size() << " operators" << endl
+         << "  LM-cut: " << compute_time.count() / num_computations
+         << " ns/state (built in " << build_time.count() << " ms)" << endl
+         << "  average value " << static_cast<double>(total_value) / num_computations
+         << ", " << static_cast<double>(num_cuts) / num_computations
+         << " cuts, " << num_dead_ends / rounds << " dead ends" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " output.sas [output.sas ...]" << endl;
+        return 1;
+    }
+    for (int i = 1; i < argc; ++i)
+        benchmark(argv[i]);
+}
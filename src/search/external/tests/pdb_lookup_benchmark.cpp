@@ -0,0 +1,182 @@
+// Benchmark for the distance tables of pattern databases on translated
+// tasks: builds a PDB for a pattern of the goal variables (and more
+// variables while the PDB stays below a size limit) and looks up states
+// sampled by random walks, once in the PDB and once in a copy of its
+// table with 4 bytes per entry. With more than one thread, the PDB is
+// also built with the parallel regression search and compared entry by
+// entry.
+// Usage: pdb_lookup_benchmark output.sas [max_pdb_size [threads]]
+#include "../../packed_state_view.h"
+#include "../../pdbs/pattern_database.h"
+#include "../../algorithms/int_packer.h"
+#include "bench_task.h"
+#include "iostream"
+#include "algorithm"
+#include "chrono"
+#include "limits"
+#include "string"
+#include "vector"
+
+using namespace std;
+
+// goal variables first, then the others while the PDB stays small enough
+static pdbs::Pattern choose_pattern(const BenchTask &task, size_t max_size) {
+    vector<int> candidates;
+    for (const FactPair &goal : task.goals)
+        candidates.push_back(goal.var);
+    for (size_t var = 0; var < task.domains.size(); ++var)
+        candidates.push_back(var);
+    vector<bool> in_pattern(task.domains.size(), false);
+    pdbs::Pattern pattern;
+    size_t size = 1;
+    for (int var : candidates) {
+        if (in_pattern[var] || size * task.domains[var] > max_size)
+            continue;
+        in_pattern[var] = true;
+        size *= task.domains[var];
+        pattern.push_back(var);
+    }
+    sort(pattern.begin(), pattern.end());
+    return pattern;
+}
+
+static void benchmark(const string &file_name, size_t max_size,
+                      int num_threads) {
+    BenchTask task = read_bench_task(file_name);
+    if (task.has_conditional_effects()) {
+        cerr << file_name << ": conditional effects are not supported"
+             << endl;
+        exit(1);
+    }
+    int_packer::IntPacker packer(task.domains);
+    pdbs::Pattern pattern = choose_pattern(task, max_size);
+
+    auto start = chrono::steady_clock::now();
+    pdbs::PatternDatabase pdb((TaskProxy(task)), pattern);
+    chrono::duration<double, milli> build_time =
+        chrono::steady_clock::now() - start;
+
+    // copy of the table with 4 bytes per entry, read through the PDB
+    vector<size_t> multipliers;
+    size_t num_states = 1;
+    for (int var : pattern) {
+        multipliers.push_back(num_states);
+        num_states *= task.domains[var];
+    }
+    vector<int> wide_table(num_states);
+    vector<int_packer::IntPacker::Bin> abstract_state(packer.get_num_bins(), 0);
+    for (size_t index = 0; index < num_states; ++index) {
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            packer.set(abstract_state.data(), pattern[i],
+                       index / multipliers[i] % task.domains[pattern[i]]);
+        }
+        wide_table[index] = pdb.get_value(
+            PackedStateView(packer, abstract_state.data()));
+    }
+
+    chrono::duration<double, milli> parallel_build_time(0);
+    if (num_threads > 1) {
+        start = chrono::steady_clock::now();
+        pdbs::PatternDatabase parallel_pdb(
+            (TaskProxy(task)), pattern, false, vector<int>(), num_threads);
+        parallel_build_time = chrono::steady_clock::now() - start;
+        for (size_t index = 0; index < num_states; ++index) {
+            for (size_t i = 0; i < pattern.size(); ++i) {
+                packer.set(abstract_state.data(), pattern[i],
+                           index / multipliers[i] % task.domains[pattern[i]]);
+            }
+            if (parallel_pdb.get_value(PackedStateView(
+                                           packer, abstract_state.data())) !=
+                wide_table[index]) {
+                cerr << file_name << ": parallel PDB differs at abstract state "
+                     << index << endl;
+                exit(1);
+            }
+        }
+    }
+
+    // random walks from the initial state
+    const int num_samples = 1000000;
+    const int walk_length = 200;
+    vector<int_packer::IntPacker::Bin> buffers;
+    buffers.reserve(num_samples * packer.get_num_bins());
+    sample_states(task, num_samples, walk_length,
+                  [&](const vector<int> &values) {
+                      size_t offset = buffers.size();
+                      buffers.resize(offset + packer.get_num_bins());
+                      for (size_t var = 0; var < values.size(); ++var)
+                          packer.set(&buffers[offset], var, values[var]);
+                  });
+    vector<PackedStateView> states;
+    for (int sample = 0; sample < num_samples; ++sample)
+        states.emplace_back(packer, &buffers[sample * packer.get_num_bins()]);
+
+    // lookups in batches as issued by the external searches
+    const size_t batch_size = 64;
+    vector<PackedStateView> batch;
+    vector<int> batch_values;
+    long long pdb_sum = 0;
+    start = chrono::steady_clock::now();
+    for (size_t first = 0; first < states.size(); first += batch_size) {
+        batch.clear();
+        for (size_t i = first; i < min(first + batch_size, states.size()); ++i)
+            batch.push_back(states[i]);
+        pdb.get_values(batch, batch_values);
+        for (int h : batch_values)
+            pdb_sum += h;
+    }
+    chrono::duration<double, nano> pdb_time =
+        chrono::steady_clock::now() - start;
+
+    long long wide_sum = 0;
+    vector<size_t> indices;
+    start = chrono::steady_clock::now();
+    for (size_t first = 0; first < states.size(); first += batch_size) {
+        size_t last = min(first + batch_size, states.size());
+        indices.clear();
+        for (size_t i = first; i < last; ++i) {
+            size_t index = 0;
+            for (size_t j = 0; j < pattern.size(); ++j)
+                index += multipliers[j] * states[i][pattern[j]];
+            __builtin_prefetch(&wide_table[index]);
+            indices.push_back(index);
+        }
+        for (size_t index : indices)
+            wide_sum += wide_table[index];
+    }
+    chrono::duration<double, nano> wide_time =
+        chrono::steady_clock::now() - start;
+
+    if (pdb_sum != wide_sum) {
+        cerr << file_name << ": PDB lookups sum to " << pdb_sum
+             << ", wide table lookups to " << wide_sum << endl;
+        exit(1);
+    }
+    cout << file_name << ": pattern of " << pattern.size() << " variables, "
+         << num_states << " abstract states (built in "
+         << build_time.count() << " ms)" << endl;
+    if (num_threads > 1) {
+        cout << "  built with " << num_threads << " threads in "
+             << parallel_build_time.count() << " ms" << endl;
+    }
+    cout << "  PDB table:  " << pdb.get_table_bytes() << " bytes, "
+         << pdb_time.count() / states.size() << " ns/lookup" << endl
+         << "  int table:  " << num_states * sizeof(int) << " bytes, "
+         << wide_time.count() / states.size() << " ns/lookup" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 4) {
+        cerr << "usage: " << argv[0] << " output.sas [max_pdb_size [threads]]"
+             << endl;
+        return 1;
+    }
+    size_t max_size = 10000000;
+    if (argc >= 3)
+        max_size = stoul(argv[2]);
+    int num_threads = 1;
+    if (argc == 4)
+        num_threads = stoi(argv[3]);
+    benchmark(argv[1], max_size, num_threads);
+}
@@ -0,0 +1,117 @@
+// Benchmark for the successor generator on translated tasks: generates the
+// applicable operators of states sampled by random walks, once with the
+// compiled decision tree and once by testing every operator.
+// Usage: successor_generator_benchmark output.sas [output.sas ...]
+#include "../../global_operator.h"
+#include "../../global_state.h"
+#include "../../task_utils/successor_generator.h"
+#include "../../algorithms/int_packer.h"
+#include "bench_task.h"
+#include "iostream"
+#include "chrono"
+#include "memory"
+#include "string"
+#include "vector"
+
+using namespace std;
+
+// normally set up by globals.cc
+vector<int> g_variable_domain;
+vector<int> g_initial_state_data;
+vector<GlobalOperator> g_operators;
+int_packer::IntPacker *g_state_packer = nullptr;
+static shared_ptr<AbstractTask> root_task;
+
+const shared_ptr<AbstractTask> g_root_task() {
+    return root_task;
+}
+
+static void benchmark(const string &file_name) {
+    auto task_ptr = make_shared<BenchTask>(read_bench_task(file_name));
+    BenchTask &task = *task_ptr;
+    root_task = task_ptr;
+    g_variable_domain = task.domains;
+    g_initial_state_data = task.initial_state;
+    int_packer::IntPacker packer(g_variable_domain);
+    g_state_packer = &packer;
+    GlobalState::initialize_state_info();
+
+    auto start = chrono::steady_clock::now();
+    successor_generator::SuccessorGenerator generator((TaskProxy(task)));
+    chrono::duration<double, milli> build_time =
+        chrono::steady_clock::now() - start;
+
+    // random walks from the initial state
+    const int num_states = 100000;
+    const int walk_length = 50;
+    vector<GlobalState> states;
+    states.reserve(num_states);
+    vector<PackedStateBin> buffer(packer.get_num_bins());
+    sample_states(task, num_states, walk_length,
+                  [&](const vector<int> &values) {
+                      for (size_t var = 0; var < values.size(); ++var)
+                          packer.set(buffer.data(), var, values[var]);
+                      states.emplace_back(buffer.data());
+                  });
+
+    const int rounds = 10;
+    vector<OperatorID> applicable_ops;
+    size_t generated = 0;
+    start = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const GlobalState &state : states) {
+            applicable_ops.clear();
+            generator.generate_applicable_ops(state, applicable_ops);
+            generated += applicable_ops.size();
+        }
+    }
+    chrono::duration<double, nano> generator_time =
+        chrono::steady_clock::now() - start;
+
+    size_t scanned = 0;
+    start = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const GlobalState &state : states) {
+            applicable_ops.clear();
+            for (size_t op_id = 0; op_id < task.operators.size(); ++op_id) {
+                bool is_applicable = true;
+                for (const FactPair &pre : task.operators[op_id].preconditions) {
+                    if (state[pre.var] != pre.value) {
+                        is_applicable = false;
+                        break;
+                    }
+                }
+                if (is_applicable)
+                    applicable_ops.push_back(OperatorID(op_id));
+            }
+            scanned += applicable_ops.size();
+        }
+    }
+    chrono::duration<double, nano> scan_time =
+        chrono::steady_clock::now() - start;
+
+    if (generated != scanned) {
+        cerr << file_name << ": generator found " << generated
+             << " operators, scan found " << scanned << endl;
+        exit(1);
+    }
+    size_t num_lookups = states.size() * rounds;
+    cout << file_name << ": " << task.domains.size() << " variables, "
+         << task.operators.size() << " operators, "
+         << static_cast<double>(generated) / num_lookups
+         << " applicable on average" << endl
+         << "  generator: " << generator_time.count() / num_lookups
+         << " ns/state (built in " << build_time.count() << " ms)" << endl
+         << "  scan:      " << scan_time.count() / num_lookups
+         << " ns/state" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " output.sas [output.sas ...]" << endl;
+        return 1;
+    }
+    for (int i = 1; i < argc; ++i)
+        benchmark(argv[i]);
+}
@@ -0,0 +1,103 @@
+#include "block_codec.h"
+
+#include "errors.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+
+namespace block_codec {
+    static size_t get_mask_bytes(size_t record_bytes) {
+        return (record_bytes + 7) / 8;
+    }
+
+    size_t get_max_encoded_bytes(size_t num_records, size_t record_bytes) {
+        return num_records * (get_mask_bytes(record_bytes) + record_bytes);
+    }
+
+    size_t encode(const char *records, size_t num_records,
+                  size_t record_bytes, char *out) {
+        const size_t mask_bytes = get_mask_bytes(record_bytes);
+        // the first record is coded against a record of zeros
+        vector<char> zeros(record_bytes, 0);
+        const char *previous = zeros.data();
+        char *pos = out;
+        for (size_t i = 0; i < num_records; ++i) {
+            const char *record = records + i * record_bytes;
+            unsigned char *mask = reinterpret_cast<unsigned char *>(pos);
+            memset(mask, 0, mask_bytes);
+            pos += mask_bytes;
+            for (size_t byte = 0; byte < record_bytes; ++byte) {
+                if (record[byte] != previous[byte]) {
+                    mask[byte / 8] |= 1 << (byte % 8);
+                    *pos++ = record[byte];
+                }
+            }
+            previous = record;
+        }
+        return pos - out;
+    }
+
+    void decode(const char *in, size_t num_records, size_t record_bytes,
+                char *records) {
+        const size_t mask_bytes = get_mask_bytes(record_bytes);
+        const char *pos = in;
+        for (size_t i = 0; i < num_records; ++i) {
+            char *record = records + i * record_bytes;
+            if (i == 0)
+                memset(record, 0, record_bytes);
+            else
+                memcpy(record, record - record_bytes, record_bytes);
+            const unsigned char *mask =
+                reinterpret_cast<const unsigned char *>(pos);
+            pos += mask_bytes;
+            for (size_t mask_byte = 0; mask_byte < mask_bytes; ++mask_byte) {
+                // whole groups of unchanged bytes are common
+                unsigned bits = mask[mask_byte];
+                while (bits) {
+                    int bit = __builtin_ctz(bits);
+                    bits &= bits - 1;
+                    record[mask_byte * 8 + bit] = *pos++;
+                }
+            }
+        }
+    }
+
+    bool write_block(fstream &file, const char *records, size_t num_records,
+                     size_t record_bytes, vector<char> &encoded) {
+        if (num_records == 0)
+            return true;
+        encoded.resize(sizeof(BlockHeader) +
+                       get_max_encoded_bytes(num_records, record_bytes));
+        BlockHeader header;
+        header.num_records = num_records;
+        header.encoded_bytes = encode(records, num_records, record_bytes,
+                                      encoded.data() + sizeof(BlockHeader));
+        memcpy(encoded.data(), &header, sizeof(BlockHeader));
+        return static_cast<bool>(
+            file.write(encoded.data(),
+                       sizeof(BlockHeader) + header.encoded_bytes));
+    }
+
+    size_t read_block(fstream &file, size_t record_bytes,
+                      vector<char> &encoded, vector<char> &records,
+                      size_t max_records) {
+        BlockHeader header;
+        if (!file.read(reinterpret_cast<char *>(&header), sizeof(BlockHeader))) {
+            // only a file that ends at a block boundary is complete
+            if (file.gcount() == 0 && file.eof())
+                return 0;
+            throw IOException("Truncated block header in bucket file.");
+        }
+        assert(header.num_records > 0);
+        encoded.resize(header.encoded_bytes);
+        if (!file.read(encoded.data(), header.encoded_bytes))
+            throw IOException("Truncated block in bucket file.");
+        size_t num_decoded = min<size_t>(header.num_records, max_records);
+        records.resize(num_decoded * record_bytes);
+        decode(encoded.data(), num_decoded, record_bytes, records.data());
+        return header.num_records;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+/*                                                                          \
+| Lightweight compression for blocks of fixed-size records, such as sorted  |
+| bucket files. Every record is delta coded against its predecessor: a mask |
+| with one bit per record byte marks the bytes that changed, and only those |
+| bytes follow the mask. Neighbours in a sorted run share most of their     |
+| packed state and the high bytes of their state ids, so most bits are 0.   |
+|                                                                           |
+| On disk, a block is a header of two 32-bit values (number of records,     |
+| encoded bytes) followed by the encoded records. Blocks are independent of |
+| each other, so files of blocks can be concatenated.                       |
+\==========================================================================*/
+
+namespace block_codec {
+    struct BlockHeader {
+        std::uint32_t num_records;
+        std::uint32_t encoded_bytes;
+    };
+
+    std::size_t get_max_encoded_bytes(std::size_t num_records,
+                                      std::size_t record_bytes);
+
+    // Encodes num_records consecutive records into out, which must hold
+    // get_max_encoded_bytes bytes. Returns the number of bytes used.
+    std::size_t encode(const char *records, std::size_t num_records,
+                       std::size_t record_bytes, char *out);
+    // Decodes the first num_records records of an encoded block.
+    void decode(const char *in, std::size_t num_records,
+                std::size_t record_bytes, char *records);
+
+    bool write_block(std::fstream &file, const char *records,
+                     std::size_t num_records, std::size_t record_bytes,
+                     std::vector<char> &encoded);
+    // Reads the next block and decodes up to max_records of its records
+    // into records. Returns the number of records in the block, 0 at the
+    // end of the file. Throws IOException if the file ends inside a block.
+    std::size_t read_block(std::fstream &file, std::size_t record_bytes,
+                           std::vector<char> &encoded,
+                           std::vector<char> &records,
+                           std::size_t max_records);
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef BLOCK_READER_H
+#define BLOCK_READER_H
+
+#include "block_codec.h"
+#include "named_fstream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+/*                                                                      \
+| Sequential scan over the records of a bucket file. Records are read in |
+| blocks of about BUFFER_BYTES with one stream call each, instead of one |
+| call per record. The file is read ahead, so nothing else may move its  |
+| position during the scan. Files written by a compressing BlockWriter   |
+| must be read with compressed set.                                      |
+\======================================================================*/
+
+template<class Entry>
+class BlockReader {
+    std::fstream &file;
+    const bool compressed;
+    const std::size_t record_bytes;
+    const std::size_t block_entries;
+    std::vector<char> records;
+    std::vector<char> encoded;
+    std::size_t num_entries = 0;
+    std::size_t next = 0;
+
+    bool fill() {
+        next = 0;
+        if (compressed) {
+            num_entries = block_codec::read_block(
+                file, record_bytes, encoded, records, SIZE_MAX);
+        } else {
+            records.resize(block_entries * record_bytes);
+            file.read(records.data(), records.size());
+            num_entries = file.gcount() / record_bytes;
+        }
+        return num_entries > 0;
+    }
+ public:
+    explicit BlockReader(std::fstream &file, bool compressed = false)
+        : file(file),
+          compressed(compressed),
+          record_bytes(Entry::get_size_in_bytes()),
+          block_entries(std::max<std::size_t>(
+              1, BUFFER_BYTES / Entry::get_size_in_bytes())) {
+    }
+
+    // returns false once all records have been read
+    bool read(Entry &entry) {
+        if (next == num_entries && !fill())
+            return false;
+        entry.read(records.data() + next++ * record_bytes);
+        return true;
+    }
+
+    /*
+      For compressed files of sorted records, before the first read: skips
+      the blocks that end before key without decoding them, such that the
+      first record not less than key is still ahead. Plain files are
+      positioned by record offset instead.
+    */
+    void skip_blocks_below(const Entry &key) {
+        assert(compressed && next == num_entries);
+        std::vector<char> first_record;
+        std::streampos previous = file.tellg();
+        while (true) {
+            std::streampos position = file.tellg();
+            if (block_codec::read_block(file, record_bytes, encoded,
+                                        first_record, 1) == 0)
+                break;
+            Entry first;
+            first.read(first_record.data());
+            if (!(first < key))
+                break;
+            previous = position;
+        }
+        file.clear();
+        file.seekg(previous);
+    }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef BLOCK_WRITER_H
+#define BLOCK_WRITER_H
+
+#include "block_codec.h"
+#include "errors.h"
+#include "named_fstream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <vector>
+
+/*                                                                       \
+| Appends records to a bucket file in blocks of about BUFFER_BYTES, each  |
+| written with one stream call. If compressed is set, blocks are encoded  |
+| with block_codec, which pays off for sorted records. Records are only   |
+| guaranteed to be in the file after flush.                               |
+\=======================================================================*/
+
+template<class Entry>
+class BlockWriter {
+    std::fstream &file;
+    const bool compressed;
+    const std::size_t record_bytes;
+    const std::size_t block_entries;
+    std::vector<char> records;
+    std::vector<char> encoded;
+    std::size_t num_entries = 0;
+ public:
+    explicit BlockWriter(std::fstream &file, bool compressed = false)
+        : file(file),
+          compressed(compressed),
+          record_bytes(Entry::get_size_in_bytes()),
+          block_entries(std::max<std::size_t>(
+              1, BUFFER_BYTES / Entry::get_size_in_bytes())),
+          records(block_entries * record_bytes) {
+    }
+
+    void write(const Entry &entry) {
+        entry.write(records.data() + num_entries * record_bytes);
+        if (++num_entries == block_entries)
+            flush();
+    }
+
+    void flush() {
+        bool success;
+        if (compressed)
+            success = block_codec::write_block(file, records.data(),
+                                               num_entries, record_bytes,
+                                               encoded);
+        else
+            success = static_cast<bool>(
+                file.write(records.data(), num_entries * record_bytes));
+        if (!success)
+            throw IOException("Fail to write state to fstream.");
+        num_entries = 0;
+    }
+};
+
+#endif
@@ -1,43 +1,94 @@
 #ifdef EXTERNAL_SEARCH
 #include "global_state.h"
+#include "global_operator.h"
 #include "globals.h"
 #include "state_id.h"
 #include "algorithms/int_packer.h"
 #include "utils/memory.h"
 #include "external/hash_functions/state_hash.h"
 
+#include <algorithm>
 #include <vector>
 #include <fstream>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 
 std::unique_ptr<StateHash<GlobalState> > GlobalState::hasher = nullptr;
+unsigned GlobalState::hasher_generation = 0;
 
-// These will be initialized on the generation of the first node (lazily).
-// This limitation is due to the fact that information on state variables
-// is only available at runtime.
+// These are initialized once the task is loaded, as information on state
+// variables is only available at runtime.
+int GlobalState::num_bins = 0;
 std::size_t GlobalState::packedState_bytes = 0;
 std::size_t GlobalState::size_in_bytes = 0;
+std::size_t GlobalState::op_g_bytes = 0;
+bool GlobalState::parent_hash_value_stored = true;
+
+// State ids are stored with 6 bytes, enough for 2^48 generated nodes.
+static const int STATE_ID_BYTES = 6;
+// g is stored at full int width, as plan costs are not bounded in advance.
+static const int G_BITS = 31;
 
 std::size_t GlobalState::get_packedState_bytes() { return packedState_bytes; }
 std::size_t GlobalState::get_size_in_bytes() { return size_in_bytes; }
 
+std::size_t GlobalState::get_memory_in_bytes() {
+    return sizeof(GlobalState) +
+        (num_bins > INLINE_PACKED_BINS ? packedState_bytes : 0);
+}
 
-// Initialize memory information of states, as well as primary hash function used.
+
+// Initialize memory information of states.
 // Should only be called after states have been packed by int_packer.
 void GlobalState::initialize_state_info() {
-    packedState_bytes = g_state_packer->get_num_bins() * sizeof(PackedStateBin);
+    num_bins = g_state_packer->get_num_bins();
+    packedState_bytes = num_bins * sizeof(PackedStateBin);
+    // creating_operator + 1 (0 for no operator) is stored above g
+    int op_bits = 0;
+    while ((uint64_t(1) << op_bits) < g_operators.size() + 1)
+        ++op_bits;
+    op_g_bytes = (op_bits + G_BITS + 7) / 8;
     size_in_bytes =
         packedState_bytes +
-        sizeof(state_id) +
-        sizeof(parent_state_id) +
-        sizeof(creating_operator) +
-        sizeof(g) +
-        sizeof(parent_hash_value);
+        2 * STATE_ID_BYTES + // state_id, parent_state_id
+        op_g_bytes +
+        (parent_hash_value_stored ? sizeof(parent_hash_value) : 0);
+}
+
+void GlobalState::set_parent_hash_value_stored(bool stored) {
+    parent_hash_value_stored = stored;
+    initialize_state_info();
+}
+
+// Little-endian encoding of the lowest num_bytes bytes of value
+static inline char *encode_bytes(char *ptr, uint64_t value, int num_bytes) {
+    for (int i = 0; i < num_bytes; ++i)
+        ptr[i] = static_cast<char>(value >> (8 * i));
+    return ptr + num_bytes;
+}
+
+static inline const char *decode_bytes(const char *ptr, uint64_t &value,
+                                       int num_bytes) {
+    value = 0;
+    for (int i = 0; i < num_bytes; ++i)
+        value |= uint64_t(static_cast<unsigned char>(ptr[i])) << (8 * i);
+    return ptr + num_bytes;
 }
 
-GlobalState::GlobalState(const StateID state_id) : state_id(state_id) {}
+// Copies a packed state into this node, allocating only if the task does
+// not fit into the inline bins and this node has no heap buffer yet.
+void GlobalState::assign_packed_buffer(const PackedStateBin *buffer) {
+    if (num_bins > INLINE_PACKED_BINS && !heap_bins)
+        heap_bins.reset(new PackedStateBin[num_bins]);
+    PackedStateBin *bins = get_packed_buffer();
+    if (bins != buffer)
+        memcpy(bins, buffer, packedState_bytes);
+}
+
+GlobalState::GlobalState(const StateID state_id)
+    : inline_bins(), state_id(state_id) {}
 
 
 // 'Empty' states that can be used for copying.
@@ -45,27 +96,46 @@ GlobalState::GlobalState(const StateID state_id) : state_id(state_id) {}
 GlobalState::GlobalState() : GlobalState(StateID::no_state) {}
 
 
-// Assumes that this is used on the creation of initial state - i.e. is done
-// before any other GlobalState constructor is used - and therefore is in charge
-// of the initialization of static variables. Otherwise we would have to put
-// initialize_state_info() in other constructors as well.
-GlobalState::GlobalState(const std::vector<PackedStateBin> &packedState) :
-    packedState(packedState)
-{
-    if (!packedState_bytes || !size_in_bytes || !hasher) initialize_state_info();
+GlobalState::GlobalState(const PackedStateBin *buffer) {
+    assign_packed_buffer(buffer);
 }
 
-GlobalState::GlobalState(const std::vector<PackedStateBin> &packedState,
+GlobalState::GlobalState(const PackedStateBin *buffer,
                          StateID parent_state_id,
                          int creating_operator,
                          int g,
                          size_t parent_hash_value)
-    : packedState(packedState),
-      parent_state_id(parent_state_id),
+    : parent_state_id(parent_state_id),
       creating_operator(creating_operator),
       g(g),
       parent_hash_value(parent_hash_value)
-{}
+{
+    assign_packed_buffer(buffer);
+}
+
+GlobalState::GlobalState(const GlobalState &other)
+    : state_id(other.state_id),
+      parent_state_id(other.parent_state_id),
+      creating_operator(other.creating_operator),
+      g(other.g),
+      parent_hash_value(other.parent_hash_value),
+      hash_value(other.hash_value),
+      hash_generation(other.hash_generation)
+{
+    assign_packed_buffer(other.get_packed_buffer());
+}
+
+GlobalState &GlobalState::operator=(const GlobalState &other) {
+    assign_packed_buffer(other.get_packed_buffer());
+    state_id = other.state_id;
+    parent_state_id = other.parent_state_id;
+    creating_operator = other.creating_operator;
+    g = other.g;
+    parent_hash_value = other.parent_hash_value;
+    hash_value = other.hash_value;
+    hash_generation = other.hash_generation;
+    return *this;
+}
     
 std::vector<int> GlobalState::get_values() const {
     int num_variables = g_initial_state_data.size();
@@ -78,25 +148,25 @@ std::vector<int> GlobalState::get_values() const {
 int GlobalState::operator[](int var) const {
     assert(var >= 0);
     assert(var < g_initial_state_data.size());
-    return g_state_packer->get(&(packedState[0]), var);
+    return g_state_packer->get(get_packed_buffer(), var);
 }
 
 bool GlobalState::operator==(const GlobalState& other) const {
-    return packedState == other.get_packed_vec();
+    return memcmp(get_packed_buffer(), other.get_packed_buffer(),
+                  packedState_bytes) == 0;
 }
 
 bool GlobalState::operator<(const GlobalState& other) const {
-    return packedState < other.get_packed_vec();
+    const PackedStateBin *bins = get_packed_buffer();
+    const PackedStateBin *other_bins = other.get_packed_buffer();
+    return std::lexicographical_compare(bins, bins + num_bins,
+                                        other_bins, other_bins + num_bins);
 }
 
 bool GlobalState::operator>(const GlobalState& other) const {
     return other < *this;
 }
 
-const std::vector<PackedStateBin> &GlobalState::get_packed_vec() const {
-    return packedState;
-}
-
 StateID GlobalState::get_state_id() const {
     return state_id;    
 }
@@ -113,66 +183,124 @@ int GlobalState::get_g() const {
     return g;
 }
 
+// Serialization buffer for record and block I/O, one per thread since
+// parallel engines read and write buckets concurrently.
+static char *get_record_buffer(size_t bytes) {
+    static thread_local std::vector<char> buffer;
+    if (buffer.size() < bytes)
+        buffer.resize(bytes);
+    return buffer.data();
+}
+
 bool GlobalState::write(std::fstream& file) const {
-    file.write(reinterpret_cast<const char *>
-               (&packedState.front()), packedState_bytes);
-    file.write(reinterpret_cast<const char *>(&state_id), sizeof(state_id));
-    file.write(reinterpret_cast<const char *>(&parent_state_id), sizeof(parent_state_id));
-    file.write(reinterpret_cast<const char *>(&creating_operator), sizeof(creating_operator));
-    file.write(reinterpret_cast<const char *>(&g), sizeof(g));
-    file.write(reinterpret_cast<const char *>(&parent_hash_value), sizeof(parent_hash_value));
+    char *record = get_record_buffer(size_in_bytes);
+    write(record);
+    file.write(record, size_in_bytes);
     return !file.fail();
 }
 
 void GlobalState::write(char* ptr) const {
-    memcpy(ptr, &packedState.front(), packedState_bytes);
+    assert(state_id.value >> (8 * STATE_ID_BYTES) == 0);
+    assert(g >= 0);
+    memcpy(ptr, get_packed_buffer(), packedState_bytes);
     ptr += packedState_bytes;
-    memcpy(ptr, &state_id, sizeof(state_id));
-    ptr += sizeof(state_id);
-    memcpy(ptr, &parent_state_id, sizeof(parent_state_id));
-    ptr += sizeof(parent_state_id);
-    memcpy(ptr, &creating_operator, sizeof(creating_operator));
-    ptr += sizeof(creating_operator);
-    memcpy(ptr, &g, sizeof(g));
-    ptr += sizeof(g);
-    memcpy(ptr, &parent_hash_value, sizeof(parent_hash_value));
-    
+    ptr = encode_bytes(ptr, state_id.value, STATE_ID_BYTES);
+    ptr = encode_bytes(ptr, parent_state_id.value, STATE_ID_BYTES);
+    uint64_t op_g = (uint64_t(creating_operator + 1) << G_BITS) | uint64_t(g);
+    ptr = encode_bytes(ptr, op_g, op_g_bytes);
+    if (parent_hash_value_stored)
+        memcpy(ptr, &parent_hash_value, sizeof(parent_hash_value));
 }
 
 bool GlobalState::read(std::fstream& file) {
-    packedState.resize(packedState_bytes / sizeof(PackedStateBin));
-    file.read(reinterpret_cast<char *>
-              (&packedState.front()), packedState_bytes);
-    file.read(reinterpret_cast<char *>(&state_id), sizeof(state_id));
-    file.read(reinterpret_cast<char *>(&parent_state_id), sizeof(parent_state_id));
-    file.read(reinterpret_cast<char *>(&creating_operator), sizeof(creating_operator));
-    file.read(reinterpret_cast<char *>(&g), sizeof(g));
-    file.read(reinterpret_cast<char *>(&parent_hash_value), sizeof(parent_hash_value));
-    return !file.fail();
+    char *record = get_record_buffer(size_in_bytes);
+    if (!file.read(record, size_in_bytes))
+        return false;
+    read(record);
+    return true;
 }
 
 void GlobalState::read(char* ptr) {
-    packedState.resize(packedState_bytes / sizeof(PackedStateBin));
-    memcpy(&packedState.front(), ptr, packedState_bytes);
-    ptr += packedState_bytes;
-    memcpy(&state_id, ptr, sizeof(state_id));
-    ptr += sizeof(state_id);
-    memcpy(&parent_state_id, ptr, sizeof(parent_state_id));
-    ptr += sizeof(parent_state_id);
-    memcpy(&creating_operator, ptr, sizeof(creating_operator));
-    ptr += sizeof(creating_operator);
-    memcpy(&g, ptr, sizeof(g));
-    ptr+= sizeof(g);
-    memcpy(&parent_hash_value, ptr, sizeof(parent_hash_value));
+    assign_packed_buffer(reinterpret_cast<const PackedStateBin *>(ptr));
+    const char *record = ptr + packedState_bytes;
+    uint64_t value;
+    record = decode_bytes(record, value, STATE_ID_BYTES);
+    state_id = StateID(value);
+    record = decode_bytes(record, value, STATE_ID_BYTES);
+    parent_state_id = StateID(value);
+    record = decode_bytes(record, value, op_g_bytes);
+    creating_operator = static_cast<int>(value >> G_BITS) - 1;
+    g = static_cast<int>(value & ((uint64_t(1) << G_BITS) - 1));
+    if (parent_hash_value_stored)
+        memcpy(&parent_hash_value, record, sizeof(parent_hash_value));
+    else
+        parent_hash_value = 0;
+    hash_generation = 0;
+}
+
+// Blocks are transferred in chunks of at most this size, which bounds the
+// serialization buffer.
+static const size_t MAX_CHUNK_BYTES = 1 << 20;
+
+bool GlobalState::write_block(std::fstream &file, const GlobalState *entries,
+                              size_t num_entries) {
+    size_t chunk_entries = std::max<size_t>(1, MAX_CHUNK_BYTES / size_in_bytes);
+    char *chunk = get_record_buffer(
+        std::min(num_entries, chunk_entries) * size_in_bytes);
+    for (size_t begin = 0; begin < num_entries; begin += chunk_entries) {
+        size_t end = std::min(num_entries, begin + chunk_entries);
+        for (size_t i = begin; i < end; ++i)
+            entries[i].write(chunk + (i - begin) * size_in_bytes);
+        if (!file.write(chunk, (end - begin) * size_in_bytes))
+            return false;
+    }
+    return true;
+}
+
+size_t GlobalState::read_block(std::fstream &file,
+                               std::vector<GlobalState> &entries,
+                               size_t max_entries) {
+    size_t chunk_entries = std::max<size_t>(1, MAX_CHUNK_BYTES / size_in_bytes);
+    char *chunk = get_record_buffer(
+        std::min(max_entries, chunk_entries) * size_in_bytes);
+    size_t num_read = 0;
+    while (num_read < max_entries) {
+        size_t request = std::min(max_entries - num_read, chunk_entries);
+        file.read(chunk, request * size_in_bytes);
+        size_t num_entries = file.gcount() / size_in_bytes;
+        size_t first = entries.size();
+        entries.resize(first + num_entries);
+        for (size_t i = 0; i < num_entries; ++i)
+            entries[first + i].read(chunk + i * size_in_bytes);
+        num_read += num_entries;
+        if (num_entries < request)
+            break; // end of file
+    }
+    return num_read;
 }
 
 size_t GlobalState::get_hash_value() const {
     if (hasher != nullptr) {
-        return (*hasher)(*this);
+        if (hash_generation != hasher_generation) {
+            hash_value = (*hasher)(*this);
+            hash_generation = hasher_generation;
+        }
+        return hash_value;
     }
     return 0;
 }
 
+void GlobalState::set_hash_value(size_t value) {
+    assert(hasher != nullptr);
+    assert((*hasher)(*this) == value);
+    hash_value = value;
+    hash_generation = hasher_generation;
+}
+
+bool GlobalState::has_incremental_hash_function() {
+    return hasher != nullptr && hasher->is_incremental();
+}
+
 size_t GlobalState::get_parent_hash_value() const {
     return parent_hash_value;
 }
@@ -180,6 +308,11 @@ size_t GlobalState::get_parent_hash_value() const {
 void GlobalState::
 initialize_hash_function(std::unique_ptr<StateHash<GlobalState> > hash_function) {
     hasher = std::move(hash_function);
+    ++hasher_generation;
+}
+
+bool GlobalState::has_hash_function() {
+    return hasher != nullptr;
 }
 
 #else // ifndef EXTERNAL_SEARCH
@@ -13,10 +13,18 @@
 using PackedStateBin = int_packer::IntPacker::Bin;
 using namespace statehash;
 
+// Packed states of up to INLINE_PACKED_BINS bins are stored inside the node,
+// so that generating, copying and reading nodes does not allocate. Tasks
+// with larger states fall back to one heap buffer per node.
+#ifndef INLINE_PACKED_BINS
+#define INLINE_PACKED_BINS 8
+#endif
+
 // GlobalState IS a node for external search purposes
 
 class GlobalState {
-    std::vector<PackedStateBin> packedState;
+    PackedStateBin inline_bins[INLINE_PACKED_BINS];
+    std::unique_ptr<PackedStateBin[]> heap_bins;
     StateID state_id;
     StateID parent_state_id = StateID::no_state;
     int creating_operator = -1;
@@ -24,49 +32,105 @@ class GlobalState {
     // For path reconstruction, 
     // unfortunate overhead for search engines that have no use for this
     size_t parent_hash_value = 0;
+    // Cached value of the primary hash function, valid if hash_generation
+    // matches the generation of the current hash function
+    mutable size_t hash_value = 0;
+    mutable unsigned hash_generation = 0;
 
+    static int num_bins;
     static size_t packedState_bytes;
     static size_t size_in_bytes;
+    // Compact record layout, see initialize_state_info
+    static size_t op_g_bytes;
+    static bool parent_hash_value_stored;
     // Primary hash function to prevent unnecessary creation of hash function
     // resources (bitstrings in the case of zobrist hash)
     // Initialization delegated to class that needs it, e.g. closed list
     static std::unique_ptr<StateHash<GlobalState> > hasher;
+    static unsigned hasher_generation; // incremented on every new hasher
 
-    void initialize_state_info();
+    void assign_packed_buffer(const PackedStateBin *buffer);
     GlobalState(StateID state_id);
  public:
     GlobalState();
-    GlobalState(const std::vector<PackedStateBin> &packedState);
-    GlobalState(const std::vector<PackedStateBin> &packedState,
+    explicit GlobalState(const PackedStateBin *buffer);
+    GlobalState(const PackedStateBin *buffer,
                 StateID parent_state_id,
                 int creating_operator,
                 int g,
                 size_t parent_hash_value = 0);
+    GlobalState(const GlobalState &other);
+    GlobalState(GlobalState &&other) = default;
+    GlobalState &operator=(const GlobalState &other);
+    GlobalState &operator=(GlobalState &&other) = default;
+
     std::vector<int> get_values() const;
     int operator[](int var) const;
     bool operator==(const GlobalState &other) const;
     bool operator<(const GlobalState& other) const;
     bool operator>(const GlobalState& other) const;
-    const std::vector<PackedStateBin> &get_packed_vec() const;
+    const PackedStateBin *get_packed_buffer() const {
+        return heap_bins ? heap_bins.get() : inline_bins;
+    }
+    // Writable packed state, e.g. for applying effects to a new successor.
+    // Invalidates the cached hash value.
+    PackedStateBin *get_packed_buffer() {
+        hash_generation = 0;
+        return heap_bins ? heap_bins.get() : inline_bins;
+    }
 
     StateID get_state_id() const;
     StateID get_parent_state_id() const;
     int get_creating_operator() const;
     int get_g() const;
 
+    // A node is serialized as one record of get_size_in_bytes() bytes,
+    // transferred to and from streams with a single call. Records are
+    // compact: state ids take 6 bytes, the creating operator and g share a
+    // bit field sized to the number of operators, and the parent hash value
+    // is only stored for engines that trace paths through it.
     bool write(std::fstream& file) const; // serialize Globalstate
     void write(char* ptr) const;
     bool read(std::fstream& file); // deserialize Globalstate
     void read(char* ptr); 
 
+    // Bulk versions for consecutive records. read_block appends at most
+    // max_entries nodes to entries and returns how many were read; reading
+    // fewer means the end of the file was reached.
+    static bool write_block(std::fstream &file, const GlobalState *entries,
+                            size_t num_entries);
+    static size_t read_block(std::fstream &file,
+                             std::vector<GlobalState> &entries,
+                             size_t max_entries);
+
     // if hash function not initialized, returns 0
     size_t get_hash_value() const;
     size_t get_parent_hash_value() const;
+    /*
+      Incremental hashing for successor generation: start from the parent's
+      hash value and update it for every changed variable, then store the
+      result with set_hash_value. The value must match what the current
+      hash function would compute for this state.
+    */
+    void set_hash_value(size_t value);
+    static bool has_incremental_hash_function();
+    static size_t update_hash_value(size_t value, int var,
+                                    int old_value, int new_value) {
+        return hasher->update(value, var, old_value, new_value);
+    }
 
     static size_t get_packedState_bytes();
     static size_t get_size_in_bytes();
-
+    // RAM used by one node, including a packed state stored out of line
+    static size_t get_memory_in_bytes();
+
+    // Must be called once the state packer is known, before creating nodes.
+    static void initialize_state_info();
+    // Engines that find parents without their hash value may drop it from
+    // records. Must be called before the first node is written.
+    static void set_parent_hash_value_stored(bool stored);
     static void initialize_hash_function(std::unique_ptr<StateHash<GlobalState> > hash_function);
+    static bool has_hash_function();
 };
 
 
@@ -252,6 +252,9 @@ void read_everything(istream &in) {
     cout << "packing state variables..." << flush;
     assert(!g_variable_domain.empty());
     g_state_packer = new int_packer::IntPacker(g_variable_domain);
+#ifdef EXTERNAL_SEARCH
+    GlobalState::initialize_state_info();
+#endif
     cout << "done! [t=" << utils::g_timer << "]" << endl;
 
     int num_vars = g_variable_domain.size();
@@ -4,6 +4,7 @@
 #include "evaluation_result.h"
 
 #include "global_operator.h"
+#include "global_state.h"
 #include "globals.h"
 #include "option_parser.h"
 #include "plugin.h"
@@ -22,6 +23,10 @@ Heuristic::Heuristic(const Options &opts)
 #ifndef EXTERNAL_SEARCH
       heuristic_cache(HEntry(NO_VALUE, true)), //TODO: is true really a good idea here?
       cache_h_values(opts.get<bool>("cache_estimates")),
+#endif
+#ifdef EXTERNAL_SEARCH
+      packed_state_viewable(
+          opts.get<shared_ptr<AbstractTask>>("transform") == g_root_task()),
 #endif
       task(opts.get<shared_ptr<AbstractTask>>("transform")),
       task_proxy(*task) {
@@ -46,6 +51,23 @@ State Heuristic::convert_global_state(const GlobalState &global_state) const {
     return task_proxy.convert_ancestor_state(state);
 }
 
+#ifdef EXTERNAL_SEARCH
+PackedStateView Heuristic::view_packed_state(
+    const GlobalState &global_state) const {
+    assert(packed_state_viewable);
+    return PackedStateView(*g_state_packer, global_state.get_packed_buffer());
+}
+
+vector<PackedStateView> Heuristic::view_packed_states(
+    const vector<GlobalState> &global_states) const {
+    vector<PackedStateView> views;
+    views.reserve(global_states.size());
+    for (const GlobalState &global_state : global_states)
+        views.push_back(view_packed_state(global_state));
+    return views;
+}
+#endif
+
 void Heuristic::add_options_to_parser(OptionParser &parser) {
     parser.add_option<shared_ptr<AbstractTask>>(
         "transform",
@@ -104,6 +126,9 @@ result.set_count_evaluation(true);
           have a dead end, we don't want to actually report any
           preferred operators.
         */
+#ifdef EXTERNAL_SEARCH
+        if (!preferred_operators.empty())
+#endif
         preferred_operators.clear();
         heuristic = EvaluationResult::INFTY;
     }
@@ -119,12 +144,43 @@ result.set_count_evaluation(true);
 #endif
 
     result.set_h_value(heuristic);
+#ifdef EXTERNAL_SEARCH
+    /*
+      Only touch preferred_operators if the heuristic marked some, such that
+      heuristics without mutable state (e.g. blind, PDBs, M&S) can be
+      evaluated by several threads at once.
+    */
+    if (!preferred_operators.empty())
+        result.set_preferred_operators(preferred_operators.pop_as_vector());
+#else
     result.set_preferred_operators(preferred_operators.pop_as_vector());
+#endif
     assert(preferred_operators.empty());
 
     return result;
 }
 
+void Heuristic::compute_heuristic_batch(const vector<GlobalState> &states,
+                                        vector<int> &h_values) {
+    h_values.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        h_values[i] = compute_heuristic(states[i]);
+        // see compute_result
+        if (!preferred_operators.empty())
+            preferred_operators.clear();
+    }
+}
+
+void Heuristic::compute_values(const vector<GlobalState> &states,
+                               vector<int> &values) {
+    compute_heuristic_batch(states, values);
+    for (int &value : values) {
+        assert(value == DEAD_END || value >= 0);
+        if (value == DEAD_END)
+            value = EvaluationResult::INFTY;
+    }
+}
+
 string Heuristic::get_description() const {
     return description;
 }
@@ -3,6 +3,7 @@
 
 #include "evaluator.h"
 #include "operator_id.h"
+#include "packed_state_view.h"
 #ifndef EXTERNAL_SEARCH
 #include "per_state_information.h"
 #endif
@@ -50,6 +51,10 @@ class Heuristic : public Evaluator {
     */
     ordered_set::OrderedSet<OperatorID> preferred_operators;
 
+#ifdef EXTERNAL_SEARCH
+    bool packed_state_viewable;
+#endif
+
 protected:
     /*
       Cache for saving h values
@@ -71,6 +76,14 @@ protected:
 
     // TODO: Call with State directly once all heuristics support it.
     virtual int compute_heuristic(const GlobalState &state) = 0;
+    /*
+      Computes the estimates for a batch of states, with DEAD_END for dead
+      ends. The default implementation calls compute_heuristic for each
+      state. Like compute_heuristic, overrides must not mark preferred
+      operators if they are evaluated concurrently.
+    */
+    virtual void compute_heuristic_batch(
+        const std::vector<GlobalState> &states, std::vector<int> &h_values);
 
     /*
       Usage note: Marking the same operator as preferred multiple times
@@ -83,6 +96,21 @@ protected:
        heuristics use the TaskProxy class. */
     State convert_global_state(const GlobalState &global_state) const;
 
+#ifdef EXTERNAL_SEARCH
+    /*
+      Fast path for heuristics that only read a few variables: instead of
+      converting the whole state, they can read values from a view of its
+      packed bins. This is only possible if the heuristic works on the
+      root task itself, such that no state conversion is needed.
+    */
+    bool can_view_packed_state() const {
+        return packed_state_viewable;
+    }
+    PackedStateView view_packed_state(const GlobalState &global_state) const;
+    std::vector<PackedStateView> view_packed_states(
+        const std::vector<GlobalState> &global_states) const;
+#endif
+
 public:
     explicit Heuristic(const options::Options &options);
     virtual ~Heuristic() override;
@@ -103,6 +131,8 @@ public:
 
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_values(const std::vector<GlobalState> &states,
+                                std::vector<int> &values) override;
 
     std::string get_description() const;
 };
@@ -15,7 +15,9 @@ namespace additive_heuristic {
 // construction and destruction
 AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
-      did_write_overflow_warning(false) {
+      did_write_overflow_warning(false),
+      reached_by(num_propositions, -1),
+      marked(num_propositions, false) {
     cout << "Initializing additive heuristic..." << endl;
 }
 
@@ -38,69 +40,57 @@ void AdditiveHeuristic::write_overflow_warning() {
 void AdditiveHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (size_t var = 0; var < propositions.size(); ++var) {
-        for (size_t value = 0; value < propositions[var].size(); ++value) {
-            Proposition &prop = propositions[var][value];
-            prop.cost = -1;
-            prop.marked = false;
-        }
-    }
+    proposition_costs.assign(num_propositions, -1);
+    marked.assign(num_propositions, false);
 
-    // Deal with operators and axioms without preconditions.
-    for (size_t i = 0; i < unary_operators.size(); ++i) {
-        UnaryOperator &op = unary_operators[i];
-        op.unsatisfied_preconditions = op.precondition.size();
-        op.cost = op.base_cost; // will be increased by precondition costs
+    unsatisfied_preconditions = num_preconditions;
+    costs = base_costs; // will be increased by precondition costs
 
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, &op);
-    }
+    // Deal with operators and axioms without preconditions.
+    for (int op : operators_without_preconditions)
+        enqueue_if_necessary(effects[op], base_costs[op], op);
 }
 
 void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
-    for (FactProxy fact : state) {
-        Proposition *init_prop = get_proposition(fact);
-        enqueue_if_necessary(init_prop, 0, 0);
+    const vector<int> &values = state.get_values();
+    for (size_t var = 0; var < values.size(); ++var) {
+        enqueue_if_necessary(variable_offsets[var] + values[var], 0, -1);
     }
 }
 
 void AdditiveHeuristic::relaxed_exploration() {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
-        pair<int, Proposition *> top_pair = queue.pop();
+        pair<int, int> top_pair = queue.pop();
         int distance = top_pair.first;
-        Proposition *prop = top_pair.second;
-        int prop_cost = prop->cost;
+        int prop = top_pair.second;
+        int prop_cost = proposition_costs[prop];
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        if (is_goal[prop] && --unsolved_goals == 0)
             return;
-        const vector<UnaryOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (size_t i = 0; i < triggered_operators.size(); ++i) {
-            UnaryOperator *unary_op = triggered_operators[i];
-            increase_cost(unary_op->cost, prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
-                                     unary_op->cost, unary_op);
+        for (int op : get_precondition_of(prop)) {
+            increase_cost(costs[op], prop_cost);
+            --unsatisfied_preconditions[op];
+            assert(unsatisfied_preconditions[op] >= 0);
+            if (unsatisfied_preconditions[op] == 0)
+                enqueue_if_necessary(effects[op], costs[op], op);
         }
     }
 }
 
 void AdditiveHeuristic::mark_preferred_operators(
-    const State &state, Proposition *goal) {
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        UnaryOperator *unary_op = goal->reached_by;
-        if (unary_op) { // We have not yet chained back to a start node.
-            for (size_t i = 0; i < unary_op->precondition.size(); ++i)
-                mark_preferred_operators(state, unary_op->precondition[i]);
-            int operator_no = unary_op->operator_no;
-            if (unary_op->cost == unary_op->base_cost && operator_no != -1) {
+    const State &state, int goal) {
+    if (!marked[goal]) { // Only consider each subgoal once.
+        marked[goal] = true;
+        int unary_op = reached_by[goal];
+        if (unary_op != -1) { // We have not yet chained back to a start node.
+            for (int pre : get_preconditions(unary_op))
+                mark_preferred_operators(state, pre);
+            int operator_no = operator_nos[unary_op];
+            if (costs[unary_op] == base_costs[unary_op] && operator_no != -1) {
                 // Necessary condition for this being a preferred
                 // operator, which we use as a quick test before the
                 // more expensive applicability test.
@@ -120,8 +110,8 @@ int AdditiveHeuristic::compute_add_and_ff(const State &state) {
     relaxed_exploration();
 
     int total_cost = 0;
-    for (size_t i = 0; i < goal_propositions.size(); ++i) {
-        int prop_cost = goal_propositions[i]->cost;
+    for (int goal : goal_propositions) {
+        int prop_cost = proposition_costs[goal];
         if (prop_cost == -1)
             return DEAD_END;
         increase_cost(total_cost, prop_cost);
@@ -132,8 +122,8 @@ int AdditiveHeuristic::compute_add_and_ff(const State &state) {
 int AdditiveHeuristic::compute_heuristic(const State &state) {
     int h = compute_add_and_ff(state);
     if (h != DEAD_END) {
-        for (size_t i = 0; i < goal_propositions.size(); ++i)
-            mark_preferred_operators(state, goal_propositions[i]);
+        for (int goal : goal_propositions)
+            mark_preferred_operators(state, goal);
     }
     return h;
 }
@@ -7,13 +7,11 @@
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <vector>
 
 class State;
 
 namespace additive_heuristic {
-using relaxation_heuristic::Proposition;
-using relaxation_heuristic::UnaryOperator;
-
 class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     /* Costs larger than MAX_COST_VALUE are clamped to max_value. The
        precise value (100M) is a bit of a hack, since other parts of
@@ -24,22 +22,23 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
      */
     static const int MAX_COST_VALUE = 100000000;
 
-    priority_queues::AdaptiveQueue<Proposition *> queue;
+    priority_queues::AdaptiveQueue<int> queue;
     bool did_write_overflow_warning;
 
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
-    void mark_preferred_operators(const State &state, Proposition *goal);
+    void mark_preferred_operators(const State &state, int goal);
 
-    void enqueue_if_necessary(Proposition *prop, int cost, UnaryOperator *op) {
+    void enqueue_if_necessary(int prop, int cost, int op) {
         assert(cost >= 0);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            prop->reached_by = op;
+        if (proposition_costs[prop] == -1 || proposition_costs[prop] > cost) {
+            proposition_costs[prop] = cost;
+            reached_by[prop] = op;
             queue.push(cost, prop);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(proposition_costs[prop] != -1 &&
+               proposition_costs[prop] <= cost);
     }
 
     void increase_cost(int &cost, int amount) {
@@ -56,6 +55,11 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
 
     int compute_heuristic(const State &state);
 protected:
+    // Unary operator that reached each proposition; -1 for none.
+    std::vector<int> reached_by;
+    // Used when computing preferred operators for h^add and h^FF.
+    std::vector<bool> marked;
+
     virtual int compute_heuristic(const GlobalState &global_state);
 
     // Common part of h^add and h^ff computation.
@@ -73,9 +77,10 @@ public:
     void compute_heuristic_for_cegar(const State &state);
 
     int get_cost_for_cegar(int var, int value) const {
-        assert(utils::in_bounds(var, propositions));
-        assert(utils::in_bounds(value, propositions[var]));
-        return propositions[var][value].cost;
+        assert(utils::in_bounds(var, variable_offsets));
+        assert(utils::in_bounds(variable_offsets[var] + value,
+                                proposition_costs));
+        return proposition_costs[variable_offsets[var] + value];
     }
 };
 }
@@ -22,6 +22,10 @@ BlindSearchHeuristic::BlindSearchHeuristic(const Options &opts)
 BlindSearchHeuristic::~BlindSearchHeuristic() {
 }
 
+bool BlindSearchHeuristic::supports_concurrent_evaluation() const {
+    return true;
+}
+
 int BlindSearchHeuristic::compute_heuristic(const GlobalState &global_state) {
     State state = convert_global_state(global_state);
     if (task_properties::is_goal_state(task_proxy, state))
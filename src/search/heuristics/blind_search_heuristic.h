@@ -11,6 +11,7 @@ protected:
 public:
     BlindSearchHeuristic(const options::Options &options);
     ~BlindSearchHeuristic();
+    virtual bool supports_concurrent_evaluation() const override;
 };
 }
 
@@ -22,20 +22,19 @@ FFHeuristic::~FFHeuristic() {
 }
 
 void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
-    const State &state, Proposition *goal) {
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        UnaryOperator *unary_op = goal->reached_by;
-        if (unary_op) { // We have not yet chained back to a start node.
-            for (size_t i = 0; i < unary_op->precondition.size(); ++i)
-                mark_preferred_operators_and_relaxed_plan(
-                    state, unary_op->precondition[i]);
-            int operator_no = unary_op->operator_no;
+    const State &state, int goal) {
+    if (!marked[goal]) { // Only consider each subgoal once.
+        marked[goal] = true;
+        int unary_op = reached_by[goal];
+        if (unary_op != -1) { // We have not yet chained back to a start node.
+            for (int pre : get_preconditions(unary_op))
+                mark_preferred_operators_and_relaxed_plan(state, pre);
+            int operator_no = operator_nos[unary_op];
             if (operator_no != -1) {
                 // This is not an axiom.
                 relaxed_plan[operator_no] = true;
 
-                if (unary_op->cost == unary_op->base_cost) {
+                if (costs[unary_op] == base_costs[unary_op]) {
                     // This test is implied by the next but cheaper,
                     // so we perform it to save work.
                     // If we had no 0-cost operators and axioms to worry
@@ -56,8 +55,8 @@ int FFHeuristic::compute_heuristic(const GlobalState &global_state) {
         return h_add;
 
     // Collecting the relaxed plan also sets the preferred operators.
-    for (size_t i = 0; i < goal_propositions.size(); ++i)
-        mark_preferred_operators_and_relaxed_plan(state, goal_propositions[i]);
+    for (int goal : goal_propositions)
+        mark_preferred_operators_and_relaxed_plan(state, goal);
 
     int h_ff = 0;
     for (size_t op_no = 0; op_no < relaxed_plan.size(); ++op_no) {
@@ -6,9 +6,6 @@
 #include <vector>
 
 namespace ff_heuristic {
-using Proposition = relaxation_heuristic::Proposition;
-using UnaryOperator = relaxation_heuristic::UnaryOperator;
-
 /*
   TODO: In a better world, this should not derive from
         AdditiveHeuristic. Rather, the common parts should be
@@ -23,7 +20,7 @@ class FFHeuristic : public additive_heuristic::AdditiveHeuristic {
     typedef std::vector<bool> RelaxedPlan;
     RelaxedPlan relaxed_plan;
     void mark_preferred_operators_and_relaxed_plan(
-        const State &state, Proposition *goal);
+        const State &state, int goal);
 protected:
     virtual int compute_heuristic(const GlobalState &global_state);
 public:
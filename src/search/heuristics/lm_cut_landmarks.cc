@@ -3,6 +3,7 @@
 #include "../task_utils/task_properties.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <utility>
 
@@ -15,18 +16,32 @@ LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
     task_properties::verify_no_conditional_effects(task_proxy);
 
     // Build propositions.
-    num_propositions = 2; // artificial goal and artificial precondition
     VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        int var_id = fact.get_variable().get_id();
-        propositions[var_id].push_back(RelaxedProposition());
-        ++num_propositions;
+    int num_facts = 0;
+    for (VariableProxy var : variables) {
+        variable_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
     }
+    artificial_precondition = num_facts;
+    artificial_goal = num_facts + 1;
+    num_propositions = num_facts + 2;
+    statuses.resize(num_propositions, UNREACHED);
+    h_max_costs.resize(num_propositions, 0);
 
     // Build relaxed operators for operators and axioms.
-    for (OperatorProxy op : task_proxy.get_operators())
-        build_relaxed_operator(op);
+    precondition_starts.push_back(0);
+    effect_starts.push_back(0);
+    vector<int> preconditions;
+    vector<int> effects;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        preconditions.clear();
+        effects.clear();
+        for (FactProxy pre : op.get_preconditions())
+            preconditions.push_back(get_proposition(pre));
+        for (EffectProxy eff : op.get_effects())
+            effects.push_back(get_proposition(eff.get_fact()));
+        add_relaxed_operator(preconditions, effects, op.get_id(), op.get_cost());
+    }
 
     // Simplify relaxed operators.
     // simplify();
@@ -35,195 +50,177 @@ LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
        unary operators hurts. */
 
     // Build artificial goal proposition and operator.
-    vector<RelaxedProposition *> goal_op_pre, goal_op_eff;
-    for (FactProxy goal : task_proxy.get_goals()) {
-        goal_op_pre.push_back(get_proposition(goal));
-    }
-    goal_op_eff.push_back(&artificial_goal);
+    preconditions.clear();
+    for (FactProxy goal : task_proxy.get_goals())
+        preconditions.push_back(get_proposition(goal));
+    effects.assign(1, artificial_goal);
     /* Use the invalid operator ID -1 so accessing
        the artificial operator will generate an error. */
-    add_relaxed_operator(move(goal_op_pre), move(goal_op_eff), -1, 0);
+    add_relaxed_operator(preconditions, effects, -1, 0);
 
-    // Cross-reference relaxed operators.
-    for (RelaxedOperator &op : relaxed_operators) {
-        for (RelaxedProposition *pre : op.preconditions)
-            pre->precondition_of.push_back(&op);
-        for (RelaxedProposition *eff : op.effects)
-            eff->effect_of.push_back(&op);
+    int num_operators = original_op_ids.size();
+    for (int op = 0; op < num_operators; ++op) {
+        num_preconditions.push_back(
+            precondition_starts[op + 1] - precondition_starts[op]);
     }
-}
+    costs.resize(num_operators);
+    unsatisfied_preconditions.resize(num_operators);
+    h_max_supporters.resize(num_operators);
+    h_max_supporter_costs.resize(num_operators);
+    next_supported.resize(num_operators);
+    previous_supported.resize(num_operators);
+    first_supported.resize(num_propositions);
 
-LandmarkCutLandmarks::~LandmarkCutLandmarks() {
+    // Cross-reference relaxed operators.
+    utils::invert_id_ranges(precondition_starts, operator_preconditions,
+                            num_propositions, precondition_of_starts,
+                            precondition_of);
+    utils::invert_id_ranges(effect_starts, operator_effects,
+                            num_propositions, effect_of_starts, effect_of);
+
+    /*
+      No h^max value exceeds the largest operator cost times the number
+      of propositions, since every proposition is reached at most once
+      on the way to another one. If that is small, the buckets pay off.
+    */
+    int max_cost = 0;
+    for (int cost : base_costs)
+        max_cost = max(max_cost, cost);
+    use_buckets = static_cast<int64_t>(max_cost) * num_propositions <=
+        HMaxBucketQueue::MAX_KEY;
 }
 
-void LandmarkCutLandmarks::build_relaxed_operator(const OperatorProxy &op) {
-    vector<RelaxedProposition *> precondition;
-    vector<RelaxedProposition *> effects;
-    for (FactProxy pre : op.get_preconditions()) {
-        precondition.push_back(get_proposition(pre));
-    }
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(get_proposition(eff.get_fact()));
-    }
-    add_relaxed_operator(
-        move(precondition), move(effects), op.get_id(), op.get_cost());
+LandmarkCutLandmarks::~LandmarkCutLandmarks() {
 }
 
 void LandmarkCutLandmarks::add_relaxed_operator(
-    vector<RelaxedProposition *> &&precondition,
-    vector<RelaxedProposition *> &&effects,
+    const vector<int> &preconditions, const vector<int> &effects,
     int op_id, int base_cost) {
-    RelaxedOperator relaxed_op(
-        move(precondition), move(effects), op_id, base_cost);
-    if (relaxed_op.preconditions.empty())
-        relaxed_op.preconditions.push_back(&artificial_precondition);
-    relaxed_operators.push_back(relaxed_op);
-}
-
-RelaxedProposition *LandmarkCutLandmarks::get_proposition(
-    const FactProxy &fact) {
-    int var_id = fact.get_variable().get_id();
-    int val = fact.get_value();
-    return &propositions[var_id][val];
+    if (preconditions.empty())
+        operator_preconditions.push_back(artificial_precondition);
+    else
+        operator_preconditions.insert(operator_preconditions.end(),
+                                      preconditions.begin(),
+                                      preconditions.end());
+    precondition_starts.push_back(operator_preconditions.size());
+    operator_effects.insert(operator_effects.end(),
+                            effects.begin(), effects.end());
+    effect_starts.push_back(operator_effects.size());
+    original_op_ids.push_back(op_id);
+    base_costs.push_back(base_cost);
 }
 
 // heuristic computation
 void LandmarkCutLandmarks::setup_exploration_queue() {
-    priority_queue.clear();
+    if (use_buckets)
+        bucket_queue.clear();
+    else
+        heap_queue.clear();
 
-    for (auto &var_props : propositions) {
-        for (RelaxedProposition &prop : var_props) {
-            prop.status = UNREACHED;
-        }
-    }
+    fill(statuses.begin(), statuses.end(), UNREACHED);
 
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
-
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.unsatisfied_preconditions = op.preconditions.size();
-        op.h_max_supporter = 0;
-        op.h_max_supporter_cost = numeric_limits<int>::max();
-    }
+    unsatisfied_preconditions = num_preconditions;
+    fill(h_max_supporters.begin(), h_max_supporters.end(), -1);
+    fill(first_supported.begin(), first_supported.end(), -1);
+    fill(h_max_supporter_costs.begin(), h_max_supporter_costs.end(),
+         numeric_limits<int>::max());
 }
 
 void LandmarkCutLandmarks::setup_exploration_queue_state(const State &state) {
-    for (FactProxy init_fact : state) {
-        enqueue_if_necessary(get_proposition(init_fact), 0);
+    const vector<int> &values = state.get_values();
+    for (size_t var = 0; var < values.size(); ++var) {
+        enqueue_if_necessary(variable_offsets[var] + values[var], 0);
     }
-    enqueue_if_necessary(&artificial_precondition, 0);
+    enqueue_if_necessary(artificial_precondition, 0);
 }
 
 void LandmarkCutLandmarks::first_exploration(const State &state) {
-    assert(priority_queue.empty());
+    assert(queue_empty());
     setup_exploration_queue();
     setup_exploration_queue_state(state);
-    while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+    while (!queue_empty()) {
+        pair<int, int> top_pair = pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop = top_pair.second;
+        int prop_cost = h_max_costs[prop];
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            --relaxed_op->unsatisfied_preconditions;
-            assert(relaxed_op->unsatisfied_preconditions >= 0);
-            if (relaxed_op->unsatisfied_preconditions == 0) {
-                relaxed_op->h_max_supporter = prop;
-                relaxed_op->h_max_supporter_cost = prop_cost;
-                int target_cost = prop_cost + relaxed_op->cost;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    enqueue_if_necessary(effect, target_cost);
-                }
+        for (int op : get_precondition_of(prop)) {
+            --unsatisfied_preconditions[op];
+            assert(unsatisfied_preconditions[op] >= 0);
+            if (unsatisfied_preconditions[op] == 0) {
+                set_h_max_supporter(op, prop);
+                h_max_supporter_costs[op] = prop_cost;
+                enqueue_effects(op, prop_cost + costs[op]);
             }
         }
     }
 }
 
-void LandmarkCutLandmarks::first_exploration_incremental(
-    vector<RelaxedOperator *> &cut) {
-    assert(priority_queue.empty());
-    /* We pretend that this queue has had as many pushes already as we
-       have propositions to avoid switching from bucket-based to
-       heap-based too aggressively. This should prevent ever switching
-       to heap-based in problems where action costs are at most 1.
-    */
-    priority_queue.add_virtual_pushes(num_propositions);
-    for (RelaxedOperator *relaxed_op : cut) {
-        int cost = relaxed_op->h_max_supporter_cost + relaxed_op->cost;
-        for (RelaxedProposition *effect : relaxed_op->effects)
-            enqueue_if_necessary(effect, cost);
-    }
-    while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+void LandmarkCutLandmarks::first_exploration_incremental() {
+    assert(queue_empty());
+    for (int op : cut)
+        enqueue_effects(op, h_max_supporter_costs[op] + costs[op]);
+    while (!queue_empty()) {
+        pair<int, int> top_pair = pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop = top_pair.second;
+        int prop_cost = h_max_costs[prop];
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
-                int old_supp_cost = relaxed_op->h_max_supporter_cost;
-                if (old_supp_cost > prop_cost) {
-                    relaxed_op->update_h_max_supporter();
-                    int new_supp_cost = relaxed_op->h_max_supporter_cost;
-                    if (new_supp_cost != old_supp_cost) {
-                        // This operator has become cheaper.
-                        assert(new_supp_cost < old_supp_cost);
-                        int target_cost = new_supp_cost + relaxed_op->cost;
-                        for (RelaxedProposition *effect : relaxed_op->effects)
-                            enqueue_if_necessary(effect, target_cost);
-                    }
+        // update_h_max_supporter may move op to another list
+        int next_op;
+        for (int op = first_supported[prop]; op != -1; op = next_op) {
+            next_op = next_supported[op];
+            int old_supp_cost = h_max_supporter_costs[op];
+            if (old_supp_cost > prop_cost) {
+                update_h_max_supporter(op);
+                int new_supp_cost = h_max_supporter_costs[op];
+                if (new_supp_cost != old_supp_cost) {
+                    // This operator has become cheaper.
+                    assert(new_supp_cost < old_supp_cost);
+                    enqueue_effects(op, new_supp_cost + costs[op]);
                 }
             }
         }
     }
 }
 
-void LandmarkCutLandmarks::second_exploration(
-    const State &state, vector<RelaxedProposition *> &second_exploration_queue,
-    vector<RelaxedOperator *> &cut) {
+void LandmarkCutLandmarks::second_exploration(const State &state) {
     assert(second_exploration_queue.empty());
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
+    statuses[artificial_precondition] = BEFORE_GOAL_ZONE;
+    second_exploration_queue.push_back(artificial_precondition);
 
-    for (FactProxy init_fact : state) {
-        RelaxedProposition *init_prop = get_proposition(init_fact);
-        init_prop->status = BEFORE_GOAL_ZONE;
+    const vector<int> &values = state.get_values();
+    for (size_t var = 0; var < values.size(); ++var) {
+        int init_prop = variable_offsets[var] + values[var];
+        statuses[init_prop] = BEFORE_GOAL_ZONE;
         second_exploration_queue.push_back(init_prop);
     }
 
     while (!second_exploration_queue.empty()) {
-        RelaxedProposition *prop = second_exploration_queue.back();
+        int prop = second_exploration_queue.back();
         second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
-                bool reached_goal_zone = false;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    if (effect->status == GOAL_ZONE) {
-                        assert(relaxed_op->cost > 0);
-                        reached_goal_zone = true;
-                        cut.push_back(relaxed_op);
-                        break;
-                    }
+        for (int op = first_supported[prop]; op != -1; op = next_supported[op]) {
+            bool reached_goal_zone = false;
+            for (int effect : get_effects(op)) {
+                if (statuses[effect] == GOAL_ZONE) {
+                    assert(costs[op] > 0);
+                    reached_goal_zone = true;
+                    cut.push_back(op);
+                    break;
                 }
-                if (!reached_goal_zone) {
-                    for (RelaxedProposition *effect : relaxed_op->effects) {
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
-                            second_exploration_queue.push_back(effect);
-                        }
+            }
+            if (!reached_goal_zone) {
+                for (int effect : get_effects(op)) {
+                    if (statuses[effect] != BEFORE_GOAL_ZONE) {
+                        assert(statuses[effect] == REACHED);
+                        statuses[effect] = BEFORE_GOAL_ZONE;
+                        second_exploration_queue.push_back(effect);
                     }
                 }
             }
@@ -231,16 +228,16 @@ void LandmarkCutLandmarks::second_exploration(
     }
 }
 
-void LandmarkCutLandmarks::mark_goal_plateau(RelaxedProposition *subgoal) {
-    // NOTE: subgoal can be null if we got here via recursion through
+void LandmarkCutLandmarks::mark_goal_plateau(int subgoal) {
+    // NOTE: subgoal can be -1 if we got here via recursion through
     // a zero-cost action that is relaxed unreachable. (This can only
     // happen in domains which have zero-cost actions to start with.)
     // For example, this happens in pegsol-strips #01.
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        for (RelaxedOperator *achiever : subgoal->effect_of)
-            if (achiever->cost == 0)
-                mark_goal_plateau(achiever->h_max_supporter);
+    if (subgoal != -1 && statuses[subgoal] != GOAL_ZONE) {
+        statuses[subgoal] = GOAL_ZONE;
+        for (int achiever : get_effect_of(subgoal))
+            if (costs[achiever] == 0)
+                mark_goal_plateau(h_max_supporters[achiever]);
     }
 }
 
@@ -249,24 +246,30 @@ void LandmarkCutLandmarks::validate_h_max() const {
     // Using conditional compilation to avoid complaints about unused
     // variables when using NDEBUG. This whole code does nothing useful
     // when assertions are switched off anyway.
-    for (const RelaxedOperator &op : relaxed_operators) {
-        if (op.unsatisfied_preconditions) {
+    int num_operators = original_op_ids.size();
+    for (int op = 0; op < num_operators; ++op) {
+        if (unsatisfied_preconditions[op]) {
             bool reachable = true;
-            for (RelaxedProposition *pre : op.preconditions) {
-                if (pre->status == UNREACHED) {
+            for (int pre : get_preconditions(op)) {
+                if (statuses[pre] == UNREACHED) {
                     reachable = false;
                     break;
                 }
             }
             assert(!reachable);
-            assert(!op.h_max_supporter);
+            assert(h_max_supporters[op] == -1);
         } else {
-            assert(op.h_max_supporter);
-            int h_max_cost = op.h_max_supporter_cost;
-            assert(h_max_cost == op.h_max_supporter->h_max_cost);
-            for (RelaxedProposition *pre : op.preconditions) {
-                assert(pre->status != UNREACHED);
-                assert(pre->h_max_cost <= h_max_cost);
+            assert(h_max_supporters[op] != -1);
+            int previous = previous_supported[op];
+            if (previous == -1)
+                assert(first_supported[h_max_supporters[op]] == op);
+            else
+                assert(next_supported[previous] == op);
+            int h_max_cost = h_max_supporter_costs[op];
+            assert(h_max_cost == h_max_costs[h_max_supporters[op]]);
+            for (int pre : get_preconditions(op)) {
+                assert(statuses[pre] != UNREACHED);
+                assert(h_max_costs[pre] <= h_max_cost);
             }
         }
     }
@@ -274,48 +277,40 @@ void LandmarkCutLandmarks::validate_h_max() const {
 }
 
 bool LandmarkCutLandmarks::compute_landmarks(
-    State state, CostCallback cost_callback,
+    const State &state, CostCallback cost_callback,
     LandmarkCallback landmark_callback) {
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.cost = op.base_cost;
-    }
-    // The following three variables could be declared inside the loop
-    // ("second_exploration_queue" even inside second_exploration),
-    // but having them here saves reallocations and hence provides a
-    // measurable speed boost.
-    vector<RelaxedOperator *> cut;
+    costs = base_costs;
     Landmark landmark;
-    vector<RelaxedProposition *> second_exploration_queue;
     first_exploration(state);
     // validate_h_max();  // too expensive to use even in regular debug mode
-    if (artificial_goal.status == UNREACHED)
+    if (statuses[artificial_goal] == UNREACHED)
         return true;
 
     int num_iterations = 0;
-    while (artificial_goal.h_max_cost != 0) {
+    while (h_max_costs[artificial_goal] != 0) {
         ++num_iterations;
-        mark_goal_plateau(&artificial_goal);
+        mark_goal_plateau(artificial_goal);
         assert(cut.empty());
-        second_exploration(state, second_exploration_queue, cut);
+        second_exploration(state);
         assert(!cut.empty());
         int cut_cost = numeric_limits<int>::max();
-        for (RelaxedOperator *op : cut)
-            cut_cost = min(cut_cost, op->cost);
-        for (RelaxedOperator *op : cut)
-            op->cost -= cut_cost;
+        for (int op : cut)
+            cut_cost = min(cut_cost, costs[op]);
+        for (int op : cut)
+            costs[op] -= cut_cost;
 
         if (cost_callback) {
             cost_callback(cut_cost);
         }
         if (landmark_callback) {
             landmark.clear();
-            for (RelaxedOperator *op : cut) {
-                landmark.push_back(op->original_op_id);
+            for (int op : cut) {
+                landmark.push_back(original_op_ids[op]);
             }
             landmark_callback(landmark, cut_cost);
         }
 
-        first_exploration_incremental(cut);
+        first_exploration_incremental();
         // validate_h_max();  // too expensive to use even in regular debug mode
         cut.clear();
 
@@ -325,14 +320,10 @@ bool LandmarkCutLandmarks::compute_landmarks(
           or something based on total_cost, so that we don't need a per-round
           reinitialization.
         */
-        for (auto &var_props : propositions) {
-            for (RelaxedProposition &prop : var_props) {
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
+        for (PropositionStatus &status : statuses) {
+            if (status == GOAL_ZONE || status == BEFORE_GOAL_ZONE)
+                status = REACHED;
         }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
     }
     return false;
 }
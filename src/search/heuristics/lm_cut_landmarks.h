@@ -4,82 +4,225 @@
 #include "../task_proxy.h"
 
 #include "../algorithms/priority_queues.h"
+#include "../utils/collections.h"
 
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
 
 namespace lm_cut_heuristic {
 // TODO: Fix duplication with the other relaxation heuristics.
-struct RelaxedProposition;
-
-enum PropositionStatus {
+enum PropositionStatus : std::uint8_t {
     UNREACHED = 0,
     REACHED = 1,
     GOAL_ZONE = 2,
     BEFORE_GOAL_ZONE = 3
 };
 
-struct RelaxedOperator {
-    int original_op_id;
-    std::vector<RelaxedProposition *> preconditions;
-    std::vector<RelaxedProposition *> effects;
-    int base_cost; // 0 for axioms, 1 for regular operators
+/*
+  Priority queue of proposition ids for the h^max explorations. Keys are
+  h^max values, so there is one bucket per key; the entries of a bucket
+  are chained through arrays and popped last in, first out. Only used
+  if no h^max value can exceed MAX_KEY, see LandmarkCutLandmarks.
+*/
+class HMaxBucketQueue {
+    // first entry of each bucket, -1 if empty
+    std::vector<int> bucket_heads;
+    std::vector<int> next_entries;
+    std::vector<int> entry_values;
+    int current_key;
+    int num_entries;
+public:
+    static const int MAX_KEY = 1 << 22;
 
-    int cost;
-    int unsatisfied_preconditions;
-    int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(std::vector<RelaxedProposition *> &&pre,
-                    std::vector<RelaxedProposition *> &&eff,
-                    int op_id, int base)
-        : original_op_id(op_id), preconditions(pre), effects(eff), base_cost(base) {
+    HMaxBucketQueue()
+        : current_key(0),
+          num_entries(0) {
     }
 
-    inline void update_h_max_supporter();
-};
+    void push(int key, int value) {
+        assert(key >= 0 && key <= MAX_KEY);
+        if (key >= static_cast<int>(bucket_heads.size()))
+            bucket_heads.resize(key + 1, -1);
+        if (key < current_key)
+            current_key = key;
+        int entry = next_entries.size();
+        next_entries.push_back(bucket_heads[key]);
+        entry_values.push_back(value);
+        bucket_heads[key] = entry;
+        ++num_entries;
+    }
 
-struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
+    std::pair<int, int> pop() {
+        assert(num_entries > 0);
+        while (bucket_heads[current_key] == -1)
+            ++current_key;
+        int entry = bucket_heads[current_key];
+        bucket_heads[current_key] = next_entries[entry];
+        int value = entry_values[entry];
+        if (--num_entries == 0) {
+            // all buckets are empty, so the entries can be reused
+            next_entries.clear();
+            entry_values.clear();
+        }
+        return std::make_pair(current_key, value);
+    }
+
+    bool empty() const {
+        return num_entries == 0;
+    }
 
-    PropositionStatus status;
-    int h_max_cost;
+    void clear() {
+        if (num_entries != 0) {
+            for (int &head : bucket_heads)
+                head = -1;
+        }
+        next_entries.clear();
+        entry_values.clear();
+        current_key = 0;
+        num_entries = 0;
+    }
 };
 
+/*
+  The relaxed task is stored as arrays indexed by proposition and
+  operator ids. Propositions are numbered by variable and value, followed
+  by the artificial precondition and the artificial goal. Relations
+  between them are kept in contiguous arrays: the preconditions of
+  operator op are
+  operator_preconditions[precondition_starts[op]..precondition_starts[op + 1]),
+  and analogously for effects and for the operators of a proposition.
+
+  The explorations keep their state in these arrays, so one object must
+  not compute landmarks for several states at once. LandmarkCutHeuristic
+  therefore does not support concurrent evaluation, and External A* uses
+  one thread with it.
+*/
 class LandmarkCutLandmarks {
-    std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition>> propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
+    std::vector<int> variable_offsets;
+    int artificial_precondition;
+    int artificial_goal;
     int num_propositions;
-    priority_queues::AdaptiveQueue<RelaxedProposition *> priority_queue;
 
-    void initialize();
-    void build_relaxed_operator(const OperatorProxy &op);
-    void add_relaxed_operator(std::vector<RelaxedProposition *> &&precondition,
-                              std::vector<RelaxedProposition *> &&effects,
+    // propositions
+    std::vector<PropositionStatus> statuses;
+    std::vector<int> h_max_costs;
+    std::vector<int> precondition_of_starts;
+    std::vector<int> precondition_of;
+    std::vector<int> effect_of_starts;
+    std::vector<int> effect_of;
+    // first operator of each proposition's list of supported operators
+    std::vector<int> first_supported;
+
+    // operators; the artificial goal operator has the last id
+    std::vector<int> original_op_ids;
+    std::vector<int> base_costs;
+    std::vector<int> precondition_starts;
+    std::vector<int> operator_preconditions;
+    std::vector<int> effect_starts;
+    std::vector<int> operator_effects;
+    std::vector<int> num_preconditions;
+    std::vector<int> costs;
+    std::vector<int> unsatisfied_preconditions;
+    // -1 if the operator is not reached
+    std::vector<int> h_max_supporters;
+    // h_max_cost of h_max_supporter
+    std::vector<int> h_max_supporter_costs;
+    // doubly-linked lists of the operators with the same h_max_supporter
+    std::vector<int> next_supported;
+    std::vector<int> previous_supported;
+
+    bool use_buckets;
+    HMaxBucketQueue bucket_queue;
+    priority_queues::HeapQueue<int> heap_queue;
+
+    // reused by compute_landmarks
+    std::vector<int> cut;
+    std::vector<int> second_exploration_queue;
+
+    utils::IdRange get_preconditions(int op) const {
+        return utils::get_id_range(
+            precondition_starts, operator_preconditions, op);
+    }
+    utils::IdRange get_effects(int op) const {
+        return utils::get_id_range(effect_starts, operator_effects, op);
+    }
+    utils::IdRange get_precondition_of(int prop) const {
+        return utils::get_id_range(
+            precondition_of_starts, precondition_of, prop);
+    }
+    utils::IdRange get_effect_of(int prop) const {
+        return utils::get_id_range(effect_of_starts, effect_of, prop);
+    }
+
+    int get_proposition(const FactProxy &fact) const {
+        return variable_offsets[fact.get_variable().get_id()] +
+               fact.get_value();
+    }
+    void add_relaxed_operator(const std::vector<int> &preconditions,
+                              const std::vector<int> &effects,
                               int op_id, int base_cost);
-    RelaxedProposition *get_proposition(const FactProxy &fact);
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void first_exploration(const State &state);
-    void first_exploration_incremental(std::vector<RelaxedOperator *> &cut);
-    void second_exploration(const State &state,
-                            std::vector<RelaxedProposition *> &queue,
-                            std::vector<RelaxedOperator *> &cut);
+    void first_exploration_incremental();
+    void second_exploration(const State &state);
+
+    void push(int cost, int prop) {
+        if (use_buckets)
+            bucket_queue.push(cost, prop);
+        else
+            heap_queue.push(cost, prop);
+    }
+
+    std::pair<int, int> pop() {
+        if (use_buckets)
+            return bucket_queue.pop();
+        return heap_queue.pop();
+    }
+
+    bool queue_empty() const {
+        return use_buckets ? bucket_queue.empty() : heap_queue.empty();
+    }
 
-    void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
+    void enqueue_if_necessary(int prop, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
-            priority_queue.push(cost, prop);
+        if (statuses[prop] == UNREACHED || h_max_costs[prop] > cost) {
+            statuses[prop] = REACHED;
+            h_max_costs[prop] = cost;
+            push(cost, prop);
         }
     }
 
-    void mark_goal_plateau(RelaxedProposition *subgoal);
+    void enqueue_effects(int op, int cost) {
+        for (int effect : get_effects(op))
+            enqueue_if_necessary(effect, cost);
+    }
+
+    void set_h_max_supporter(int op, int prop) {
+        h_max_supporters[op] = prop;
+        previous_supported[op] = -1;
+        next_supported[op] = first_supported[prop];
+        if (next_supported[op] != -1)
+            previous_supported[next_supported[op]] = op;
+        first_supported[prop] = op;
+    }
+
+    void unset_h_max_supporter(int op) {
+        int previous = previous_supported[op];
+        int next = next_supported[op];
+        if (previous == -1)
+            first_supported[h_max_supporters[op]] = next;
+        else
+            next_supported[previous] = next;
+        if (next != -1)
+            previous_supported[next] = previous;
+    }
+
+    inline void update_h_max_supporter(int op);
+    void mark_goal_plateau(int subgoal);
     void validate_h_max() const;
 public:
     using Landmark = std::vector<int>;
@@ -102,16 +245,22 @@ public:
 
       Returns true iff state is detected as a dead end.
     */
-    bool compute_landmarks(State state, CostCallback cost_callback,
+    bool compute_landmarks(const State &state, CostCallback cost_callback,
                            LandmarkCallback landmark_callback);
 };
 
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (size_t i = 0; i < preconditions.size(); ++i)
-        if (preconditions[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = preconditions[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+inline void LandmarkCutLandmarks::update_h_max_supporter(int op) {
+    assert(!unsatisfied_preconditions[op]);
+    int supporter = h_max_supporters[op];
+    for (int pre : get_preconditions(op)) {
+        if (h_max_costs[pre] > h_max_costs[supporter])
+            supporter = pre;
+    }
+    if (supporter != h_max_supporters[op]) {
+        unset_h_max_supporter(op);
+        set_h_max_supporter(op, supporter);
+    }
+    h_max_supporter_costs[op] = h_max_costs[supporter];
 }
 }
 
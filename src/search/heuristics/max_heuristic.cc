@@ -34,50 +34,41 @@ HSPMaxHeuristic::~HSPMaxHeuristic() {
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (vector<Proposition> &props_of_var : propositions) {
-        for (Proposition &prop : props_of_var) {
-            prop.cost = -1;
-        }
-    }
+    proposition_costs.assign(num_propositions, -1);
 
-    // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.precondition.size();
-        op.cost = op.base_cost; // will be increased by precondition costs
+    unsatisfied_preconditions = num_preconditions;
+    costs = base_costs; // will be increased by precondition costs
 
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
-    }
+    // Deal with operators and axioms without preconditions.
+    for (int op : operators_without_preconditions)
+        enqueue_if_necessary(effects[op], base_costs[op]);
 }
 
 void HSPMaxHeuristic::setup_exploration_queue_state(const State &state) {
-    for (FactProxy fact : state) {
-        Proposition *init_prop = get_proposition(fact);
-        enqueue_if_necessary(init_prop, 0);
+    const vector<int> &values = state.get_values();
+    for (size_t var = 0; var < values.size(); ++var) {
+        enqueue_if_necessary(variable_offsets[var] + values[var], 0);
     }
 }
 
 void HSPMaxHeuristic::relaxed_exploration() {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
-        pair<int, Proposition *> top_pair = queue.pop();
+        pair<int, int> top_pair = queue.pop();
         int distance = top_pair.first;
-        Proposition *prop = top_pair.second;
-        int prop_cost = prop->cost;
+        int prop = top_pair.second;
+        int prop_cost = proposition_costs[prop];
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        if (is_goal[prop] && --unsolved_goals == 0)
             return;
-        const vector<UnaryOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (UnaryOperator *unary_op : triggered_operators) {
-            --unary_op->unsatisfied_preconditions;
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+        for (int op : get_precondition_of(prop)) {
+            --unsatisfied_preconditions[op];
+            costs[op] = max(costs[op], base_costs[op] + prop_cost);
+            assert(unsatisfied_preconditions[op] >= 0);
+            if (unsatisfied_preconditions[op] == 0)
+                enqueue_if_necessary(effects[op], costs[op]);
         }
     }
 }
@@ -90,8 +81,8 @@ int HSPMaxHeuristic::compute_heuristic(const GlobalState &global_state) {
     relaxed_exploration();
 
     int total_cost = 0;
-    for (Proposition *prop : goal_propositions) {
-        int prop_cost = prop->cost;
+    for (int goal : goal_propositions) {
+        int prop_cost = proposition_costs[goal];
         if (prop_cost == -1) {
             return DEAD_END;
         }
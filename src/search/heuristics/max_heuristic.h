@@ -8,23 +8,21 @@
 #include <cassert>
 
 namespace max_heuristic {
-using relaxation_heuristic::Proposition;
-using relaxation_heuristic::UnaryOperator;
-
 class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
-    priority_queues::AdaptiveQueue<Proposition *> queue;
+    priority_queues::AdaptiveQueue<int> queue;
 
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
 
-    void enqueue_if_necessary(Proposition *prop, int cost) {
+    void enqueue_if_necessary(int prop, int cost) {
         assert(cost >= 0);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
+        if (proposition_costs[prop] == -1 || proposition_costs[prop] > cost) {
+            proposition_costs[prop] = cost;
             queue.push(cost, prop);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(proposition_costs[prop] != -1 &&
+               proposition_costs[prop] <= cost);
     }
 protected:
     virtual int compute_heuristic(const GlobalState &global_state);
@@ -16,65 +16,28 @@
 using namespace std;
 
 namespace relaxation_heuristic {
-// construction and destruction
-RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
-    : Heuristic(opts) {
-    // Build propositions.
-    int prop_id = 0;
-    VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        propositions[fact.get_variable().get_id()].push_back(Proposition(prop_id++));
-    }
-
-    // Build goal propositions.
-    for (FactProxy goal : task_proxy.get_goals()) {
-        Proposition *prop = get_proposition(goal);
-        prop->is_goal = true;
-        goal_propositions.push_back(prop);
-    }
-
-    // Build unary operators for operators and axioms.
-    int op_no = 0;
-    for (OperatorProxy op : task_proxy.get_operators())
-        build_unary_operators(op, op_no++);
-    for (OperatorProxy axiom : task_proxy.get_axioms())
-        build_unary_operators(axiom, -1);
-
-    // Simplify unary operators.
-    simplify();
-
-    // Cross-reference unary operators.
-    for (size_t i = 0; i < unary_operators.size(); ++i) {
-        UnaryOperator *op = &unary_operators[i];
-        for (size_t j = 0; j < op->precondition.size(); ++j)
-            op->precondition[j]->precondition_of.push_back(op);
-    }
-}
-
-RelaxationHeuristic::~RelaxationHeuristic() {
-}
-
-bool RelaxationHeuristic::dead_ends_are_reliable() const {
-    return !has_axioms();
-}
-
-Proposition *RelaxationHeuristic::get_proposition(const FactProxy &fact) {
-    int var = fact.get_variable().get_id();
-    int value = fact.get_value();
-    assert(utils::in_bounds(var, propositions));
-    assert(utils::in_bounds(value, propositions[var]));
-    return &propositions[var][value];
-}
-
-void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op, int op_no) {
+// Unary operators are collected in this form before they are flattened.
+struct UnaryOperator {
+    int operator_no;
+    vector<int> preconditions;
+    int effect;
+    int base_cost;
+
+    UnaryOperator(const vector<int> &pre, int eff, int operator_no_, int base)
+        : operator_no(operator_no_), preconditions(pre), effect(eff),
+          base_cost(base) {}
+};
+
+void RelaxationHeuristic::build_unary_operators(
+    const OperatorProxy &op, int op_no,
+    vector<UnaryOperator> &unary_operators) const {
     int base_cost = op.get_cost();
-    vector<Proposition *> precondition_props;
+    vector<int> precondition_props;
     for (FactProxy precondition : op.get_preconditions()) {
         precondition_props.push_back(get_proposition(precondition));
     }
     for (EffectProxy effect : op.get_effects()) {
-        Proposition *effect_prop = get_proposition(effect.get_fact());
+        int effect_prop = get_proposition(effect.get_fact());
         EffectConditionsProxy eff_conds = effect.get_conditions();
         for (FactProxy eff_cond : eff_conds) {
             precondition_props.push_back(get_proposition(eff_cond));
@@ -84,7 +47,7 @@ void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op, int op_
     }
 }
 
-void RelaxationHeuristic::simplify() {
+static void simplify(vector<UnaryOperator> &unary_operators) {
     // Remove duplicate or dominated unary operators.
 
     /*
@@ -100,13 +63,13 @@ void RelaxationHeuristic::simplify() {
       never dominates a lower-cost operator.
 
       In the end, the vector of unary operators is sorted by operator_no,
-      effect->id, base_cost and precondition.
+      effect, base_cost and preconditions.
     */
 
 
     cout << "Simplifying " << unary_operators.size() << " unary operators..." << flush;
 
-    typedef pair<vector<Proposition *>, Proposition *> Key;
+    typedef pair<vector<int>, int> Key;
     typedef unordered_map<Key, int> Map;
     Map unary_operator_index;
     unary_operator_index.reserve(unary_operators.size());
@@ -114,11 +77,8 @@ void RelaxationHeuristic::simplify() {
 
     for (size_t i = 0; i < unary_operators.size(); ++i) {
         UnaryOperator &op = unary_operators[i];
-        sort(op.precondition.begin(), op.precondition.end(),
-             [] (const Proposition *p1, const Proposition *p2) {
-                return p1->id < p2->id;
-            });
-        Key key(op.precondition, op.effect);
+        sort(op.preconditions.begin(), op.preconditions.end());
+        Key key(op.preconditions, op.effect);
         pair<Map::iterator, bool> inserted = unary_operator_index.insert(
             make_pair(key, i));
         if (!inserted.second) {
@@ -145,7 +105,7 @@ void RelaxationHeuristic::simplify() {
         if (key.first.size() <= 5) { // HACK! Don't spend too much time here...
             int powerset_size = (1 << key.first.size()) - 1; // -1: only consider proper subsets
             for (int mask = 0; mask < powerset_size; ++mask) {
-                Key dominating_key = make_pair(vector<Proposition *>(), key.second);
+                Key dominating_key = make_pair(vector<int>(), key.second);
                 for (size_t i = 0; i < key.first.size(); ++i)
                     if (mask & (1 << i))
                         dominating_key.first.push_back(key.first[i]);
@@ -171,16 +131,75 @@ void RelaxationHeuristic::simplify() {
             if (o1.operator_no != o2.operator_no)
                 return o1.operator_no < o2.operator_no;
             if (o1.effect != o2.effect)
-                return o1.effect->id < o2.effect->id;
+                return o1.effect < o2.effect;
             if (o1.base_cost != o2.base_cost)
                 return o1.base_cost < o2.base_cost;
-            return lexicographical_compare(o1.precondition.begin(), o1.precondition.end(),
-                                           o2.precondition.begin(), o2.precondition.end(),
-                                           [] (const Proposition *p1, const Proposition *p2) {
-                return p1->id < p2->id;
-            });
+            return o1.preconditions < o2.preconditions;
         });
 
     cout << " done! [" << unary_operators.size() << " unary operators]" << endl;
 }
+
+// construction and destruction
+RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
+    : Heuristic(opts) {
+    // Build propositions.
+    VariablesProxy variables = task_proxy.get_variables();
+    num_propositions = 0;
+    for (VariableProxy var : variables) {
+        variable_offsets.push_back(num_propositions);
+        num_propositions += var.get_domain_size();
+    }
+    proposition_costs.assign(num_propositions, -1);
+
+    // Build goal propositions.
+    is_goal.assign(num_propositions, false);
+    for (FactProxy goal : task_proxy.get_goals()) {
+        int prop = get_proposition(goal);
+        is_goal[prop] = true;
+        goal_propositions.push_back(prop);
+    }
+
+    // Build unary operators for operators and axioms.
+    vector<UnaryOperator> unary_operators;
+    int op_no = 0;
+    for (OperatorProxy op : task_proxy.get_operators())
+        build_unary_operators(op, op_no++, unary_operators);
+    for (OperatorProxy axiom : task_proxy.get_axioms())
+        build_unary_operators(axiom, -1, unary_operators);
+
+    // Simplify unary operators.
+    simplify(unary_operators);
+
+    // Store unary operators in contiguous arrays.
+    int num_unary_operators = unary_operators.size();
+    precondition_starts.push_back(0);
+    for (int op = 0; op < num_unary_operators; ++op) {
+        const UnaryOperator &unary_op = unary_operators[op];
+        operator_nos.push_back(unary_op.operator_no);
+        effects.push_back(unary_op.effect);
+        base_costs.push_back(unary_op.base_cost);
+        operator_preconditions.insert(operator_preconditions.end(),
+                                      unary_op.preconditions.begin(),
+                                      unary_op.preconditions.end());
+        precondition_starts.push_back(operator_preconditions.size());
+        num_preconditions.push_back(unary_op.preconditions.size());
+        if (unary_op.preconditions.empty())
+            operators_without_preconditions.push_back(op);
+    }
+    costs.resize(num_unary_operators);
+    unsatisfied_preconditions.resize(num_unary_operators);
+
+    // Cross-reference unary operators.
+    utils::invert_id_ranges(precondition_starts, operator_preconditions,
+                            num_propositions, precondition_of_starts,
+                            precondition_of);
+}
+
+RelaxationHeuristic::~RelaxationHeuristic() {
+}
+
+bool RelaxationHeuristic::dead_ends_are_reliable() const {
+    return !has_axioms();
+}
 }
@@ -3,58 +3,67 @@
 
 #include "../heuristic.h"
 
+#include "../utils/collections.h"
+
+#include <cassert>
 #include <vector>
 
-class FactProxy;
 class GlobalState;
-class OperatorProxy;
 
 namespace relaxation_heuristic {
-struct Proposition;
 struct UnaryOperator;
 
-struct UnaryOperator {
-    int operator_no; // -1 for axioms; index into g_operators otherwise
-    std::vector<Proposition *> precondition;
-    Proposition *effect;
-    int base_cost;
-
-    int unsatisfied_preconditions;
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
-    UnaryOperator(const std::vector<Proposition *> &pre, Proposition *eff,
-                  int operator_no_, int base)
-        : operator_no(operator_no_), precondition(pre), effect(eff),
-          base_cost(base) {}
-};
+/*
+  The relaxed task is stored as arrays indexed by proposition and unary
+  operator ids. Propositions are numbered by variable and value, i.e.,
+  fact var=value has the id variable_offsets[var] + value. Relations
+  between them are kept in contiguous arrays: the preconditions of unary
+  operator op are
+  operator_preconditions[precondition_starts[op]..precondition_starts[op + 1]),
+  and analogously for the unary operators of a proposition.
+*/
+class RelaxationHeuristic : public Heuristic {
+    void build_unary_operators(
+        const OperatorProxy &op, int op_no,
+        std::vector<UnaryOperator> &unary_operators) const;
+protected:
+    std::vector<int> variable_offsets;
+    int num_propositions;
 
-struct Proposition {
-    bool is_goal;
-    int id;
-    std::vector<UnaryOperator *> precondition_of;
+    // propositions
+    std::vector<bool> is_goal;
+    std::vector<int> goal_propositions;
+    std::vector<int> precondition_of_starts;
+    std::vector<int> precondition_of;
+    // Used for h^max cost or h^add cost; -1 if the proposition is not reached.
+    std::vector<int> proposition_costs;
 
-    int cost; // Used for h^max cost or h^add cost
-    UnaryOperator *reached_by;
-    bool marked; // used when computing preferred operators for h^add and h^FF
+    // unary operators
+    // -1 for axioms; index into the operators of the task otherwise
+    std::vector<int> operator_nos;
+    std::vector<int> effects;
+    std::vector<int> base_costs;
+    std::vector<int> precondition_starts;
+    std::vector<int> operator_preconditions;
+    std::vector<int> num_preconditions;
+    std::vector<int> operators_without_preconditions;
+    // Used for h^max cost or h^add cost; includes operator cost (base_cost).
+    std::vector<int> costs;
+    std::vector<int> unsatisfied_preconditions;
 
-    Proposition(int id_) {
-        id = id_;
-        is_goal = false;
-        cost = -1;
-        reached_by = 0;
-        marked = false;
+    int get_proposition(const FactProxy &fact) const {
+        int var = fact.get_variable().get_id();
+        assert(utils::in_bounds(var, variable_offsets));
+        return variable_offsets[var] + fact.get_value();
+    }
+    utils::IdRange get_preconditions(int op) const {
+        return utils::get_id_range(
+            precondition_starts, operator_preconditions, op);
+    }
+    utils::IdRange get_precondition_of(int prop) const {
+        return utils::get_id_range(
+            precondition_of_starts, precondition_of, prop);
     }
-};
-
-class RelaxationHeuristic : public Heuristic {
-    void build_unary_operators(const OperatorProxy &op, int operator_no);
-    void simplify();
-protected:
-    std::vector<UnaryOperator> unary_operators;
-    std::vector<std::vector<Proposition>> propositions;
-    std::vector<Proposition *> goal_propositions;
-
-    Proposition *get_proposition(const FactProxy &fact);
     virtual int compute_heuristic(const GlobalState &state) = 0;
 public:
     RelaxationHeuristic(const options::Options &options);
@@ -2,8 +2,10 @@
 
 #include "label_equivalence_relation.h"
 #include "transition_system.h"
+#include "types.h"
 
 #include "../algorithms/priority_queues.h"
+#include "../utils/parallel.h"
 
 #include <cassert>
 #include <deque>
@@ -190,7 +192,8 @@ bool Distances::are_distances_computed() const {
     return true;
 }
 
-vector<bool> Distances::compute_distances(Verbosity verbosity) {
+vector<bool> Distances::compute_distances(
+    Verbosity verbosity, int num_threads) {
     /*
       This method does the following:
       - Computes the distances of abstract states from the abstract
@@ -220,19 +223,31 @@ vector<bool> Distances::compute_distances(Verbosity verbosity) {
 
     init_distances.resize(num_states, INF);
     goal_distances.resize(num_states, INF);
-    if (is_unit_cost()) {
-        if (verbosity >= Verbosity::VERBOSE) {
+    bool unit_cost = is_unit_cost();
+    if (verbosity >= Verbosity::VERBOSE) {
+        if (unit_cost) {
             cout << "computing distances using unit-cost algorithm" << endl;
-        }
-        compute_init_distances_unit_cost();
-        compute_goal_distances_unit_cost();
-    } else {
-        if (verbosity >= Verbosity::VERBOSE) {
+        } else {
             cout << "computing distances using general-cost algorithm" << endl;
         }
-        compute_init_distances_general_cost();
-        compute_goal_distances_general_cost();
     }
+    // The two searches only share the (read-only) transition system.
+    int num_searches =
+        (num_threads > 1 && num_states >= MIN_STATES_FOR_THREADS) ? 2 : 1;
+    utils::run_in_parallel(num_searches, [&](int search) {
+            if (search == 0 || num_searches == 1) {
+                if (unit_cost)
+                    compute_init_distances_unit_cost();
+                else
+                    compute_init_distances_general_cost();
+            }
+            if (search == 1 || num_searches == 1) {
+                if (unit_cost)
+                    compute_goal_distances_unit_cost();
+                else
+                    compute_goal_distances_general_cost();
+            }
+        });
 
     max_f = 0;
     max_g = 0;
@@ -270,7 +285,8 @@ vector<bool> Distances::compute_distances(Verbosity verbosity) {
 
 void Distances::apply_abstraction(
     const StateEquivalenceRelation &state_equivalence_relation,
-    Verbosity verbosity) {
+    Verbosity verbosity,
+    int num_threads) {
     assert(are_distances_computed());
     assert(state_equivalence_relation.size() < init_distances.size());
     assert(state_equivalence_relation.size() < goal_distances.size());
@@ -314,7 +330,7 @@ void Distances::apply_abstraction(
                  << "simplification was not f-preserving!" << endl;
         }
         clear_distances();
-        compute_distances(verbosity);
+        compute_distances(verbosity, num_threads);
     } else {
         init_distances = move(new_init_distances);
         goal_distances = move(new_goal_distances);
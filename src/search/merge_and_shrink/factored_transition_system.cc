@@ -42,13 +42,15 @@ FactoredTransitionSystem::FactoredTransitionSystem(
     vector<unique_ptr<MergeAndShrinkRepresentation>> &&mas_representations,
     vector<unique_ptr<Distances>> &&distances,
     Verbosity verbosity,
-    bool finalize_if_unsolvable)
+    bool finalize_if_unsolvable,
+    int num_threads)
     : labels(move(labels)),
       transition_systems(move(transition_systems)),
       mas_representations(move(mas_representations)),
       distances(move(distances)),
       unsolvable_index(-1),
-      num_active_entries(this->transition_systems.size()) {
+      num_active_entries(this->transition_systems.size()),
+      num_threads(num_threads) {
     for (size_t i = 0; i < this->transition_systems.size(); ++i) {
         compute_distances_and_prune(i, verbosity);
         if (finalize_if_unsolvable && !this->transition_systems[i]->is_solvable()) {
@@ -64,7 +66,8 @@ FactoredTransitionSystem::FactoredTransitionSystem(FactoredTransitionSystem &&ot
       mas_representations(move(other.mas_representations)),
       distances(move(other.distances)),
       unsolvable_index(move(other.unsolvable_index)),
-      num_active_entries(move(other.num_active_entries)) {
+      num_active_entries(move(other.num_active_entries)),
+      num_threads(move(other.num_threads)) {
     /*
       This is just a default move constructor. Unfortunately Visual
       Studio does not support "= default" for move construction or
@@ -85,7 +88,7 @@ void FactoredTransitionSystem::compute_distances_and_prune(
     assert(is_active(index));
     discard_states(
         index,
-        distances[index]->compute_distances(verbosity),
+        distances[index]->compute_distances(verbosity, num_threads),
         verbosity);
     assert(is_component_valid(index));
 }
@@ -132,7 +135,7 @@ bool FactoredTransitionSystem::apply_abstraction(
         state_equivalence_relation, abstraction_mapping, verbosity);
     if (shrunk) {
         distances[index]->apply_abstraction(
-            state_equivalence_relation, verbosity);
+            state_equivalence_relation, verbosity, num_threads);
         mas_representations[index]->apply_abstraction_to_lookup_table(
             abstraction_mapping);
     }
@@ -191,6 +194,14 @@ bool FactoredTransitionSystem::shrink(
         shrink_strategy.compute_equivalence_relation(ts, dist, target_size);
     // TODO: We currently violate this; see issue250
     //assert(equivalence_relation.size() <= target_size);
+    return shrink(index, equivalence_relation, verbosity);
+}
+
+bool FactoredTransitionSystem::shrink(
+    int index,
+    const StateEquivalenceRelation &equivalence_relation,
+    Verbosity verbosity) {
+    assert(transition_systems[index]->is_solvable());
     return apply_abstraction(index, equivalence_relation, verbosity);
 }
 
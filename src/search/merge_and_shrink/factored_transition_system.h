@@ -50,6 +50,8 @@ class FactoredTransitionSystem {
     std::vector<std::unique_ptr<Distances>> distances;
     int unsolvable_index; // -1 if solvable, index of an unsolvable entry otw.
     int num_active_entries;
+    // Threads for computing the distances of a factor.
+    int num_threads;
 
     void compute_distances_and_prune(
         int index,
@@ -77,7 +79,8 @@ public:
         std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> &&mas_representations,
         std::vector<std::unique_ptr<Distances>> &&distances,
         Verbosity verbosity,
-        bool finalize_if_unsolvable);
+        bool finalize_if_unsolvable,
+        int num_threads = 1);
     FactoredTransitionSystem(FactoredTransitionSystem &&other);
     ~FactoredTransitionSystem();
 
@@ -114,6 +117,14 @@ public:
         int target_size,
         const ShrinkStrategy &shrink_strategy,
         Verbosity verbosity);
+    /*
+      Same, with an equivalence relation that has already been computed by
+      the shrink strategy for the factor at index.
+    */
+    bool shrink(
+        int index,
+        const StateEquivalenceRelation &equivalence_relation,
+        Verbosity verbosity);
 
     /*
       Merge the two factors at index1 and index2. If finalize_if_unsolvable is
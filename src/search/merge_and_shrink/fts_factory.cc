@@ -83,7 +83,8 @@ public:
       Note: create() may only be called once. We don't worry about
       misuse because the class is only used internally in this file.
     */
-    FactoredTransitionSystem create(Verbosity verbosity, bool finalize_if_unsolvable);
+    FactoredTransitionSystem create(
+        Verbosity verbosity, bool finalize_if_unsolvable, int num_threads);
 };
 
 
@@ -392,7 +393,7 @@ vector<unique_ptr<Distances>> FTSFactory::create_distances(
 }
 
 FactoredTransitionSystem FTSFactory::create(
-    Verbosity verbosity, bool finalize_if_unsolvable) {
+    Verbosity verbosity, bool finalize_if_unsolvable, int num_threads) {
     if (verbosity >= Verbosity::NORMAL) {
         cout << "Building atomic transition systems... " << endl;
     }
@@ -414,13 +415,16 @@ FactoredTransitionSystem FTSFactory::create(
         move(mas_representations),
         move(distances),
         verbosity,
-        finalize_if_unsolvable);
+        finalize_if_unsolvable,
+        num_threads);
 }
 
 FactoredTransitionSystem create_factored_transition_system(
     const TaskProxy &task_proxy,
     Verbosity verbosity,
-    bool finalize_if_unsolvable) {
-    return FTSFactory(task_proxy).create(verbosity, finalize_if_unsolvable);
+    bool finalize_if_unsolvable,
+    int num_threads) {
+    return FTSFactory(task_proxy).create(
+        verbosity, finalize_if_unsolvable, num_threads);
 }
 }
@@ -20,7 +20,8 @@ enum class Verbosity;
 extern FactoredTransitionSystem create_factored_transition_system(
     const TaskProxy &task_proxy,
     Verbosity verbosity,
-    bool finalize_if_unsolvable = true);
+    bool finalize_if_unsolvable = true,
+    int num_threads = 1);
 }
 
 #endif
@@ -20,7 +20,9 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
+#include "../utils/table_file.h"
 #include "../utils/timer.h"
 
 #include <cassert>
@@ -46,6 +48,8 @@ MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const Options &opts)
       max_states_before_merge(opts.get<int>("max_states_before_merge")),
       shrink_threshold_before_merge(opts.get<int>("threshold_before_merge")),
       verbosity(static_cast<Verbosity>(opts.get_enum("verbosity"))),
+      num_threads(opts.get<int>("threads") == 0 ?
+                  utils::get_hardware_threads() : opts.get<int>("threads")),
       starting_peak_memory(-1),
       mas_representation(nullptr) {
     assert(max_states_before_merge > 0);
@@ -61,11 +65,42 @@ MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const Options &opts)
     cout << "Initializing merge-and-shrink heuristic..." << endl;
     starting_peak_memory = utils::get_peak_memory_in_kb();
     task_properties::verify_no_axioms(task_proxy);
-    dump_options();
-    warn_on_unusual_options();
-    cout << endl;
 
-    build(timer);
+    bool cache_tables = opts.get<bool>("cache_tables");
+    uint64_t key = 0;
+    string file_name;
+    if (cache_tables) {
+        key = utils::compute_table_key(
+            task_properties::compute_fingerprint(task_proxy),
+            opts.get_unparsed_config());
+        file_name = utils::get_table_file_name("mas", key);
+        utils::TableReader reader(file_name, "mas", key);
+        if (reader.is_valid()) {
+            auto loaded = utils::make_unique_ptr<FlatMergeAndShrinkRepresentation>(
+                reader);
+            if (reader.is_valid()) {
+                cout << "Loaded merge-and-shrink representation from "
+                     << file_name << endl;
+                mas_representation = move(loaded);
+            }
+        }
+    }
+
+    if (!mas_representation) {
+        dump_options();
+        warn_on_unusual_options();
+        cout << endl;
+
+        build(timer);
+        if (cache_tables) {
+            utils::TableWriter writer(file_name, "mas", key);
+            mas_representation->save(writer);
+            if (writer.commit()) {
+                cout << "Saved merge-and-shrink representation to "
+                     << file_name << endl;
+            }
+        }
+    }
     const bool final = true;
     report_peak_memory_delta(final);
     cout << "Done initializing merge-and-shrink heuristic [" << timer << "]"
@@ -169,6 +204,27 @@ bool MergeAndShrinkHeuristic::shrink_before_merge(
         max_states_before_merge,
         max_states);
 
+    /*
+      The two factors are independent, so their equivalence relations can
+      be computed concurrently if the shrink strategy allows it. They are
+      applied one after the other below, which keeps the output in order.
+    */
+    vector<StateEquivalenceRelation> equivalence_relations;
+    if (num_threads > 1 && shrink_strategy->allows_concurrent_calls() &&
+        needs_shrinking(fts.get_ts(index1), new_sizes.first,
+                        shrink_threshold_before_merge) &&
+        needs_shrinking(fts.get_ts(index2), new_sizes.second,
+                        shrink_threshold_before_merge)) {
+        equivalence_relations.resize(2);
+        utils::run_in_parallel(2, [&](int i) {
+                int index = (i == 0) ? index1 : index2;
+                int new_size = (i == 0) ? new_sizes.first : new_sizes.second;
+                equivalence_relations[i] =
+                    shrink_strategy->compute_equivalence_relation(
+                        fts.get_ts(index), fts.get_dist(index), new_size);
+            });
+    }
+
     /*
       For both transition systems, possibly compute and apply an
       abstraction.
@@ -182,7 +238,8 @@ bool MergeAndShrinkHeuristic::shrink_before_merge(
         new_sizes.first,
         shrink_threshold_before_merge,
         *shrink_strategy,
-        verbosity);
+        verbosity,
+        equivalence_relations.empty() ? nullptr : &equivalence_relations[0]);
     if (verbosity >= Verbosity::VERBOSE && shrunk1) {
         fts.statistics(index1);
     }
@@ -192,7 +249,8 @@ bool MergeAndShrinkHeuristic::shrink_before_merge(
         new_sizes.second,
         shrink_threshold_before_merge,
         *shrink_strategy,
-        verbosity);
+        verbosity,
+        equivalence_relations.empty() ? nullptr : &equivalence_relations[1]);
     if (verbosity >= Verbosity::VERBOSE && shrunk2) {
         fts.statistics(index2);
     }
@@ -205,7 +263,8 @@ void MergeAndShrinkHeuristic::build(const utils::Timer &timer) {
         create_factored_transition_system(
             task_proxy,
             verbosity,
-            finalize_if_unsolvable);
+            finalize_if_unsolvable,
+            num_threads);
     print_time(timer, "after computation of atomic transition systems");
     cout << endl;
 
@@ -280,13 +339,25 @@ void MergeAndShrinkHeuristic::build(const utils::Timer &timer) {
 
     pair<unique_ptr<MergeAndShrinkRepresentation>, unique_ptr<Distances>>
     final_entry = fts.get_final_entry();
-    mas_representation = move(final_entry.first);
-    mas_representation->set_distances(*final_entry.second);
+    final_entry.first->set_distances(*final_entry.second);
+    mas_representation = utils::make_unique_ptr<FlatMergeAndShrinkRepresentation>(
+        *final_entry.first);
+    if (verbosity >= Verbosity::NORMAL)
+        mas_representation->dump_statistics();
     shrink_strategy = nullptr;
     label_reduction = nullptr;
 }
 
 int MergeAndShrinkHeuristic::compute_heuristic(const GlobalState &global_state) {
+#ifdef EXTERNAL_SEARCH
+    if (can_view_packed_state()) {
+        int cost = mas_representation->get_value(
+            view_packed_state(global_state));
+        if (cost == PRUNED_STATE)
+            return DEAD_END;
+        return cost;
+    }
+#endif
     State state = convert_global_state(global_state);
     int cost = mas_representation->get_value(state);
     if (cost == PRUNED_STATE)
@@ -294,6 +365,21 @@ int MergeAndShrinkHeuristic::compute_heuristic(const GlobalState &global_state)
     return cost;
 }
 
+void MergeAndShrinkHeuristic::compute_heuristic_batch(
+    const vector<GlobalState> &states, vector<int> &h_values) {
+#ifdef EXTERNAL_SEARCH
+    if (can_view_packed_state()) {
+        mas_representation->get_values(view_packed_states(states), h_values);
+        for (int &h : h_values) {
+            if (h == PRUNED_STATE)
+                h = DEAD_END;
+        }
+        return;
+    }
+#endif
+    Heuristic::compute_heuristic_batch(states, h_values);
+}
+
 void MergeAndShrinkHeuristic::add_shrink_limit_options_to_parser(OptionParser &parser) {
     parser.add_option<int>(
         "max_states",
@@ -464,6 +550,22 @@ static Heuristic *_parse(OptionParser &parser) {
         OptionParser::NONE);
 
     MergeAndShrinkHeuristic::add_shrink_limit_options_to_parser(parser);
+    parser.add_option<bool>(
+        "cache_tables",
+        "Store the final representation in a file below the directory "
+        "heuristic_tables and load it from there when the heuristic is "
+        "used again for the same task with the same options. Loading "
+        "skips the whole merge-and-shrink computation.",
+        "false");
+    parser.add_option<int>(
+        "threads",
+        "number of threads for computing distances of large transition "
+        "systems and for shrinking the two transition systems of a merge "
+        "concurrently (0 uses all hardware threads). The heuristic does not "
+        "depend on the number of threads. See also the threads option of "
+        "shrink_bisimulation.",
+        "1",
+        Bounds("0", "infinity"));
     Heuristic::add_options_to_parser(parser);
 
     vector<string> verbosity_levels;
@@ -11,6 +11,7 @@ class Timer;
 
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
+class FlatMergeAndShrinkRepresentation;
 class LabelReduction;
 class MergeAndShrinkRepresentation;
 class MergeStrategyFactory;
@@ -35,9 +36,12 @@ class MergeAndShrinkHeuristic : public Heuristic {
     const int shrink_threshold_before_merge;
 
     const Verbosity verbosity;
+    /* Threads for the distance computations and for shrinking the two
+       factors of a merge. */
+    const int num_threads;
     long starting_peak_memory;
     // The final merge-and-shrink representation, storing goal distances.
-    std::unique_ptr<MergeAndShrinkRepresentation> mas_representation;
+    std::unique_ptr<FlatMergeAndShrinkRepresentation> mas_representation;
 
     /*
       Shrink the factors at indices index1 and index2, if necessary according
@@ -53,9 +57,16 @@ class MergeAndShrinkHeuristic : public Heuristic {
     void warn_on_unusual_options() const;
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
+    virtual void compute_heuristic_batch(
+        const std::vector<GlobalState> &states,
+        std::vector<int> &h_values) override;
 public:
     explicit MergeAndShrinkHeuristic(const options::Options &opts);
     virtual ~MergeAndShrinkHeuristic() override = default;
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
     static void add_shrink_limit_options_to_parser(options::OptionParser &parser);
     static void handle_shrink_limit_options_defaults(options::Options &opts);
 };
@@ -3,10 +3,15 @@
 #include "distances.h"
 #include "types.h"
 
+#include "../packed_state_view.h"
 #include "../task_proxy.h"
 
+#include "../utils/table_file.h"
+
 #include <algorithm>
+#include <cassert>
 #include <iostream>
+#include <limits>
 #include <numeric>
 
 using namespace std;
@@ -58,6 +63,13 @@ int MergeAndShrinkRepresentationLeaf::get_value(const State &state) const {
     return lookup_table[value];
 }
 
+int MergeAndShrinkRepresentationLeaf::flatten(
+    vector<LookupInstruction> &program, vector<int> &table) const {
+    program.push_back({var_id, table.size(), 0, false});
+    table.insert(table.end(), lookup_table.begin(), lookup_table.end());
+    return 1;
+}
+
 void MergeAndShrinkRepresentationLeaf::dump() const {
     for (const auto &value : lookup_table) {
         cout << value << ", ";
@@ -119,6 +131,29 @@ int MergeAndShrinkRepresentationMerge::get_value(
     return lookup_table[state1][state2];
 }
 
+int MergeAndShrinkRepresentationMerge::flatten(
+    vector<LookupInstruction> &program, vector<int> &table) const {
+    vector<LookupInstruction> left_program;
+    vector<LookupInstruction> right_program;
+    int left_stack_size = left_child->flatten(left_program, table);
+    int right_stack_size = right_child->flatten(right_program, table);
+    bool right_first = right_stack_size > left_stack_size;
+    if (right_first) {
+        program.insert(program.end(), right_program.begin(), right_program.end());
+        program.insert(program.end(), left_program.begin(), left_program.end());
+    } else {
+        program.insert(program.end(), left_program.begin(), left_program.end());
+        program.insert(program.end(), right_program.begin(), right_program.end());
+    }
+    program.push_back({-1, table.size(), right_child->get_domain_size(),
+                       right_first});
+    for (const vector<int> &row : lookup_table)
+        table.insert(table.end(), row.begin(), row.end());
+    if (left_stack_size == right_stack_size)
+        return left_stack_size + 1;
+    return max(left_stack_size, right_stack_size);
+}
+
 void MergeAndShrinkRepresentationMerge::dump() const {
     for (const auto &row : lookup_table) {
         for (const auto &value : row) {
@@ -131,4 +166,234 @@ void MergeAndShrinkRepresentationMerge::dump() const {
     cout << "dump right child:" << endl;
     right_child->dump();
 }
+
+
+static int get_variable_value(const State &state, int var) {
+    return state[var].get_value();
+}
+
+static int get_variable_value(const PackedStateView &state, int var) {
+    return state[var];
+}
+
+template<typename Entry>
+static void copy_table(const vector<int> &table, vector<Entry> &narrow_table) {
+    narrow_table.assign(table.begin(), table.end());
+}
+
+FlatMergeAndShrinkRepresentation::FlatMergeAndShrinkRepresentation(
+    const MergeAndShrinkRepresentation &representation)
+    : mapped_table(nullptr),
+      num_mapped_entries(0) {
+    vector<int> table;
+    stack_size = representation.flatten(program, table);
+    assert(stack_size <= MAX_STACK_SIZE);
+
+    /*
+      Only the table of the root holds goal distances. Infinite distances
+      mark dead ends just like pruned states, and pruned states fit into
+      narrow entries.
+    */
+    const LookupInstruction &root = program.back();
+    for (size_t i = root.table_offset; i < table.size(); ++i) {
+        if (table[i] == INF)
+            table[i] = PRUNED_STATE;
+    }
+
+    int max_entry = *max_element(table.begin(), table.end());
+    if (max_entry <= numeric_limits<int8_t>::max()) {
+        entry_bytes = 1;
+        copy_table(table, table8);
+    } else if (max_entry <= numeric_limits<int16_t>::max()) {
+        entry_bytes = 2;
+        copy_table(table, table16);
+    } else {
+        entry_bytes = 4;
+        copy_table(table, table32);
+    }
+}
+
+FlatMergeAndShrinkRepresentation::FlatMergeAndShrinkRepresentation(
+    utils::TableReader &reader)
+    : mapped_table(nullptr),
+      num_mapped_entries(0),
+      mapped_file(reader.get_file()) {
+    vector<int> vars = reader.read_vector<int>();
+    vector<uint64_t> table_offsets = reader.read_vector<uint64_t>();
+    vector<int> right_sizes = reader.read_vector<int>();
+    vector<int> right_first = reader.read_vector<int>();
+    stack_size = reader.read_value();
+    entry_bytes = reader.read_value();
+    switch (entry_bytes) {
+    case 1:
+        mapped_table = reader.read_array<int8_t>(num_mapped_entries);
+        break;
+    case 2:
+        mapped_table = reader.read_array<int16_t>(num_mapped_entries);
+        break;
+    case 4:
+        mapped_table = reader.read_array<int32_t>(num_mapped_entries);
+        break;
+    default:
+        reader.mark_invalid();
+    }
+    size_t num_instructions = vars.size();
+    if (num_instructions == 0 || table_offsets.size() != num_instructions ||
+        right_sizes.size() != num_instructions ||
+        right_first.size() != num_instructions ||
+        stack_size < 1 || stack_size > MAX_STACK_SIZE) {
+        reader.mark_invalid();
+    }
+    if (!reader.is_valid()) {
+        mapped_table = nullptr;
+        return;
+    }
+    for (size_t i = 0; i < num_instructions; ++i) {
+        if (table_offsets[i] >= num_mapped_entries)
+            reader.mark_invalid();
+        program.push_back(
+            {vars[i], table_offsets[i], right_sizes[i], right_first[i] != 0});
+    }
+}
+
+void FlatMergeAndShrinkRepresentation::save(utils::TableWriter &writer) const {
+    vector<int> vars;
+    vector<uint64_t> table_offsets;
+    vector<int> right_sizes;
+    vector<int> right_first;
+    for (const LookupInstruction &instruction : program) {
+        vars.push_back(instruction.var);
+        table_offsets.push_back(instruction.table_offset);
+        right_sizes.push_back(instruction.right_size);
+        right_first.push_back(instruction.right_first);
+    }
+    writer.write_vector(vars);
+    writer.write_vector(table_offsets);
+    writer.write_vector(right_sizes);
+    writer.write_vector(right_first);
+    writer.write_value(stack_size);
+    writer.write_value(entry_bytes);
+    switch (entry_bytes) {
+    case 1:
+        writer.write_array(get_table(table8), get_num_entries());
+        break;
+    case 2:
+        writer.write_array(get_table(table16), get_num_entries());
+        break;
+    default:
+        writer.write_array(get_table(table32), get_num_entries());
+        break;
+    }
+}
+
+template<typename Entry, typename StateType>
+int FlatMergeAndShrinkRepresentation::compute_value(
+    const Entry *table, const StateType &state) const {
+    int stack[MAX_STACK_SIZE];
+    int top = 0;
+    for (const LookupInstruction &instruction : program) {
+        if (instruction.var != -1) {
+            int value = get_variable_value(state, instruction.var);
+            stack[top++] = table[instruction.table_offset + value];
+        } else {
+            --top;
+            int left = instruction.right_first ? stack[top] : stack[top - 1];
+            int right = instruction.right_first ? stack[top - 1] : stack[top];
+            if (left == PRUNED_STATE || right == PRUNED_STATE) {
+                stack[top - 1] = PRUNED_STATE;
+            } else {
+                stack[top - 1] = table[instruction.table_offset +
+                                       left * instruction.right_size + right];
+            }
+        }
+    }
+    assert(top == 1);
+    return stack[0];
+}
+
+template<typename Entry>
+void FlatMergeAndShrinkRepresentation::compute_values(
+    const Entry *table, const vector<PackedStateView> &states,
+    vector<int> &values) const {
+    // stack slot i of all states is stored in stack[i * n, (i + 1) * n)
+    const size_t n = states.size();
+    vector<int> stack(stack_size * n);
+    int top = 0;
+    for (const LookupInstruction &instruction : program) {
+        if (instruction.var != -1) {
+            int *pushed = &stack[top * n];
+            for (size_t i = 0; i < n; ++i) {
+                pushed[i] = table[instruction.table_offset +
+                                  states[i][instruction.var]];
+            }
+            ++top;
+        } else {
+            --top;
+            int *lower = &stack[(top - 1) * n];
+            const int *upper = &stack[top * n];
+            for (size_t i = 0; i < n; ++i) {
+                int left = instruction.right_first ? upper[i] : lower[i];
+                int right = instruction.right_first ? lower[i] : upper[i];
+                if (left == PRUNED_STATE || right == PRUNED_STATE) {
+                    lower[i] = PRUNED_STATE;
+                } else {
+                    lower[i] = table[instruction.table_offset +
+                                     left * instruction.right_size + right];
+                }
+            }
+        }
+    }
+    assert(top == 1);
+    values.assign(stack.begin(), stack.begin() + n);
+}
+
+int FlatMergeAndShrinkRepresentation::get_value(const State &state) const {
+    switch (entry_bytes) {
+    case 1:
+        return compute_value(get_table(table8), state);
+    case 2:
+        return compute_value(get_table(table16), state);
+    default:
+        return compute_value(get_table(table32), state);
+    }
+}
+
+int FlatMergeAndShrinkRepresentation::get_value(
+    const PackedStateView &state) const {
+    switch (entry_bytes) {
+    case 1:
+        return compute_value(get_table(table8), state);
+    case 2:
+        return compute_value(get_table(table16), state);
+    default:
+        return compute_value(get_table(table32), state);
+    }
+}
+
+void FlatMergeAndShrinkRepresentation::get_values(
+    const vector<PackedStateView> &states, vector<int> &values) const {
+    switch (entry_bytes) {
+    case 1:
+        compute_values(get_table(table8), states, values);
+        break;
+    case 2:
+        compute_values(get_table(table16), states, values);
+        break;
+    default:
+        compute_values(get_table(table32), states, values);
+        break;
+    }
+}
+
+size_t FlatMergeAndShrinkRepresentation::get_num_entries() const {
+    if (mapped_table)
+        return num_mapped_entries;
+    return table8.size() + table16.size() + table32.size();
+}
+
+void FlatMergeAndShrinkRepresentation::dump_statistics() const {
+    cout << "Flat representation: " << program.size() << " nodes, "
+         << get_num_entries() << " table entries of " << entry_bytes
+         << " bytes, stack size " << stack_size << endl;
+}
 }
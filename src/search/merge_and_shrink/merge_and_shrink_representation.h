@@ -1,13 +1,38 @@
 #ifndef MERGE_AND_SHRINK_MERGE_AND_SHRINK_REPRESENTATION_H
 #define MERGE_AND_SHRINK_MERGE_AND_SHRINK_REPRESENTATION_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+class PackedStateView;
 class State;
 
+namespace utils {
+class MappedFile;
+class TableReader;
+class TableWriter;
+}
+
 namespace merge_and_shrink {
 class Distances;
+
+/*
+  One node of a flattened representation (see
+  FlatMergeAndShrinkRepresentation). A leaf pushes the entry of its table
+  for the value of var. A merge node (var == -1) pops the values of its
+  children and pushes the entry of its table for the pair.
+*/
+struct LookupInstruction {
+    int var;
+    std::size_t table_offset;
+    // merge nodes: domain size of the right child, i.e., the row length
+    int right_size;
+    // merge nodes: the right child is evaluated first, so its value is
+    // below the value of the left child on the stack
+    bool right_first;
+};
 class MergeAndShrinkRepresentation {
 protected:
     int domain_size;
@@ -23,6 +48,14 @@ public:
     // Return the abstract state or the goal distance, depending on whether
     // set_distances has been used or not.
     virtual int get_value(const State &state) const = 0;
+    /*
+      Appends the instructions of this subtree in post-order to program
+      and its lookup tables to table. Of the two children of a merge
+      node, the one that needs more stack space is evaluated first.
+      Returns the stack size needed to evaluate the subtree.
+    */
+    virtual int flatten(std::vector<LookupInstruction> &program,
+                        std::vector<int> &table) const = 0;
     virtual void apply_abstraction_to_lookup_table(
         const std::vector<int> &abstraction_mapping) = 0;
     virtual void dump() const = 0;
@@ -41,6 +74,8 @@ public:
     virtual void apply_abstraction_to_lookup_table(
         const std::vector<int> &abstraction_mapping) override;
     virtual int get_value(const State &state) const override;
+    virtual int flatten(std::vector<LookupInstruction> &program,
+                        std::vector<int> &table) const override;
     virtual void dump() const override;
 };
 
@@ -59,8 +94,66 @@ public:
     virtual void apply_abstraction_to_lookup_table(
         const std::vector<int> &abstraction_mapping) override;
     virtual int get_value(const State &state) const override;
+    virtual int flatten(std::vector<LookupInstruction> &program,
+                        std::vector<int> &table) const override;
     virtual void dump() const override;
 };
+
+
+/*
+  The final representation compiled into a flat post-order program over
+  one contiguous array of lookup tables, evaluated with a small value
+  stack instead of virtual calls through the tree. Table entries are
+  stored in the smallest of 8, 16 and 32 bits that holds all of them.
+*/
+class FlatMergeAndShrinkRepresentation {
+    // Enough for any tree: evaluating the child that needs more stack
+    // first bounds the stack size by log2(number of leaves) + 1.
+    static const int MAX_STACK_SIZE = 64;
+
+    std::vector<LookupInstruction> program;
+    int stack_size;
+    int entry_bytes;
+    std::vector<std::int8_t> table8;
+    std::vector<std::int16_t> table16;
+    std::vector<std::int32_t> table32;
+    // A representation loaded from a file reads its table from the mapping.
+    const void *mapped_table;
+    std::size_t num_mapped_entries;
+    std::shared_ptr<utils::MappedFile> mapped_file;
+
+    template<typename Entry>
+    const Entry *get_table(const std::vector<Entry> &owned_table) const {
+        if (mapped_table)
+            return static_cast<const Entry *>(mapped_table);
+        return owned_table.data();
+    }
+    std::size_t get_num_entries() const;
+    template<typename Entry, typename StateType>
+    int compute_value(const Entry *table, const StateType &state) const;
+    template<typename Entry>
+    void compute_values(const Entry *table,
+                        const std::vector<PackedStateView> &states,
+                        std::vector<int> &values) const;
+public:
+    // The representation must store goal distances (see set_distances).
+    explicit FlatMergeAndShrinkRepresentation(
+        const MergeAndShrinkRepresentation &representation);
+    /*
+      Loads a representation written by save(). The caller has to check
+      that the reader is still valid afterwards.
+    */
+    explicit FlatMergeAndShrinkRepresentation(utils::TableReader &reader);
+
+    void save(utils::TableWriter &writer) const;
+
+    int get_value(const State &state) const;
+    int get_value(const PackedStateView &state) const;
+    // Evaluates the program for all states at once, one node at a time.
+    void get_values(const std::vector<PackedStateView> &states,
+                    std::vector<int> &values) const;
+    void dump_statistics() const;
+};
 }
 
 #endif
@@ -4,12 +4,14 @@
 #include "factored_transition_system.h"
 #include "label_equivalence_relation.h"
 #include "transition_system.h"
+#include "types.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 
 #include "../utils/collections.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 #include <algorithm>
@@ -83,10 +85,47 @@ struct Signature {
 };
 
 
+/*
+  Sorts with num_threads threads by sorting one part per thread and merging
+  neighbouring parts in rounds. Signature::operator< is a total order, so
+  the result is the same as for a sequential sort.
+*/
+static void sort_signatures(vector<Signature> &signatures, int num_threads) {
+    int num_parts = min<size_t>(num_threads, signatures.size());
+    if (num_parts <= 1) {
+        ::sort(signatures.begin(), signatures.end());
+        return;
+    }
+    vector<size_t> bounds;
+    for (int part = 0; part <= num_parts; ++part)
+        bounds.push_back(signatures.size() * part / num_parts);
+    utils::run_in_parallel(num_parts, [&](int part) {
+            ::sort(signatures.begin() + bounds[part],
+                   signatures.begin() + bounds[part + 1]);
+        });
+    while (bounds.size() > 2) {
+        int num_merges = (bounds.size() - 1) / 2;
+        utils::run_in_parallel(num_merges, [&](int merge) {
+                inplace_merge(signatures.begin() + bounds[2 * merge],
+                              signatures.begin() + bounds[2 * merge + 1],
+                              signatures.begin() + bounds[2 * merge + 2]);
+            });
+        vector<size_t> merged_bounds;
+        for (size_t i = 0; i < bounds.size(); i += 2)
+            merged_bounds.push_back(bounds[i]);
+        if (merged_bounds.back() != bounds.back())
+            merged_bounds.push_back(bounds.back());
+        bounds.swap(merged_bounds);
+    }
+}
+
+
 ShrinkBisimulation::ShrinkBisimulation(const Options &opts)
     : ShrinkStrategy(),
       greedy(opts.get<bool>("greedy")),
-      at_limit(AtLimit(opts.get_enum("at_limit"))) {
+      at_limit(AtLimit(opts.get_enum("at_limit"))),
+      num_threads(opts.get<int>("threads") == 0 ?
+                  utils::get_hardware_threads() : opts.get<int>("threads")) {
 }
 
 int ShrinkBisimulation::initialize_groups(
@@ -126,27 +165,13 @@ int ShrinkBisimulation::initialize_groups(
     return num_groups;
 }
 
-void ShrinkBisimulation::compute_signatures(
+void ShrinkBisimulation::compute_outgoing_transitions(
     const TransitionSystem &ts,
     const Distances &distances,
-    vector<Signature> &signatures,
-    const vector<int> &state_to_group) const {
-    assert(signatures.empty());
-
-    // Step 1: Compute bare state signatures (without transition information).
-    signatures.push_back(Signature(-2, false, -1, SuccessorSignature(), -1));
-    for (int state = 0; state < ts.get_size(); ++state) {
-        int h = distances.get_goal_distance(state);
-        assert(h >= 0 && h <= distances.get_max_h());
-        Signature signature(h, ts.is_goal_state(state),
-                            state_to_group[state], SuccessorSignature(),
-                            state);
-        signatures.push_back(signature);
-    }
-    signatures.push_back(Signature(INF, false, -1, SuccessorSignature(), -1));
-
-    // Step 2: Add transition information.
-    int label_group_counter = 0;
+    vector<int> &outgoing_start,
+    vector<pair<int, int>> &outgoing) const {
+    int num_states = ts.get_size();
+    outgoing_start.assign(num_states + 1, 0);
     /*
       Note that the final result of the bisimulation may depend on the
       order in which transitions are considered below.
@@ -171,29 +196,83 @@ void ShrinkBisimulation::compute_signatures(
                                                 threshold=1),
             label_reduction=exact(before_shrinking=true,before_merging=false)))
     */
+    auto is_skipped = [&](const LabelGroup &label_group,
+                          const Transition &transition) {
+            if (!greedy)
+                return false;
+            int src_h = distances.get_goal_distance(transition.src);
+            int target_h = distances.get_goal_distance(transition.target);
+            int cost = label_group.get_cost();
+            assert(target_h + cost >= src_h);
+            return target_h + cost != src_h;
+        };
+
+    // Count the transitions of each state, then fill in the pairs.
     for (const GroupAndTransitions &gat : ts) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            assert(signatures[transition.src + 1].state == transition.src);
-            bool skip_transition = false;
-            if (greedy) {
-                int src_h = distances.get_goal_distance(transition.src);
-                int target_h = distances.get_goal_distance(transition.target);
-                int cost = label_group.get_cost();
-                assert(target_h + cost >= src_h);
-                skip_transition = (target_h + cost != src_h);
-            }
-            if (!skip_transition) {
-                int target_group = state_to_group[transition.target];
-                signatures[transition.src + 1].succ_signature.push_back(
-                    make_pair(label_group_counter, target_group));
+        for (const Transition &transition : gat.transitions) {
+            if (!is_skipped(gat.label_group, transition))
+                ++outgoing_start[transition.src + 1];
+        }
+    }
+    for (int state = 0; state < num_states; ++state)
+        outgoing_start[state + 1] += outgoing_start[state];
+    outgoing.resize(outgoing_start[num_states]);
+    vector<int> next_position(outgoing_start.begin(), outgoing_start.end() - 1);
+    int label_group_counter = 0;
+    for (const GroupAndTransitions &gat : ts) {
+        for (const Transition &transition : gat.transitions) {
+            if (!is_skipped(gat.label_group, transition)) {
+                outgoing[next_position[transition.src]++] =
+                    make_pair(label_group_counter, transition.target);
             }
         }
         ++label_group_counter;
     }
+}
+
+void ShrinkBisimulation::compute_signatures(
+    const TransitionSystem &ts,
+    const Distances &distances,
+    const vector<int> &outgoing_start,
+    const vector<pair<int, int>> &outgoing,
+    vector<Signature> &signatures,
+    const vector<int> &state_to_group) const {
+    assert(signatures.empty());
+    int num_states = ts.get_size();
+
+    /* Step 1: Compute the state signatures with their transition
+       information. The sentinels are at positions 0 and num_states + 1,
+       the signature of state s at position s + 1. Each signature only
+       depends on its own state, so threads fill in disjoint ranges. */
+    signatures.resize(
+        num_states + 2, Signature(-2, false, -1, SuccessorSignature(), -1));
+    signatures.back() = Signature(INF, false, -1, SuccessorSignature(), -1);
+    int num_tasks = num_states < MIN_STATES_FOR_THREADS ? 1 : num_threads;
+    utils::run_in_parallel(num_tasks, [&](int task) {
+            int begin = static_cast<long long>(num_states) * task / num_tasks;
+            int end = static_cast<long long>(num_states) * (task + 1) / num_tasks;
+            for (int state = begin; state < end; ++state) {
+                int h = distances.get_goal_distance(state);
+                assert(h >= 0 && h <= distances.get_max_h());
+                Signature &signature = signatures[state + 1];
+                signature = Signature(h, ts.is_goal_state(state),
+                                      state_to_group[state],
+                                      SuccessorSignature(), state);
+                SuccessorSignature &succ_sig = signature.succ_signature;
+                succ_sig.reserve(outgoing_start[state + 1] - outgoing_start[state]);
+                for (int i = outgoing_start[state]; i < outgoing_start[state + 1]; ++i) {
+                    const pair<int, int> &label_group_and_target = outgoing[i];
+                    succ_sig.push_back(
+                        make_pair(label_group_and_target.first,
+                                  state_to_group[label_group_and_target.second]));
+                }
+                ::sort(succ_sig.begin(), succ_sig.end());
+                succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
+                               succ_sig.end());
+            }
+        });
 
-    /* Step 3: Canonicalize the representation. The resulting
+    /* Step 2: Canonicalize the representation. The resulting
        signatures must satisfy the following properties:
 
        1. Signature::operator< defines a total order with the correct
@@ -206,16 +285,10 @@ void ShrinkBisimulation::compute_signatures(
        4. Two signatures compare equal according to Signature::operator<
           iff we don't want to distinguish their states in the current
           bisimulation round.
-     */
-
-    for (size_t i = 0; i < signatures.size(); ++i) {
-        SuccessorSignature &succ_sig = signatures[i].succ_signature;
-        ::sort(succ_sig.begin(), succ_sig.end());
-        succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
-                       succ_sig.end());
-    }
 
-    ::sort(signatures.begin(), signatures.end());
+       The successor signatures were already sorted and uniquified above.
+     */
+    sort_signatures(signatures, num_tasks);
 }
 
 StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
@@ -237,13 +310,18 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
     int max_h = distances.get_max_h();
     assert(max_h >= 0 && max_h != INF);
 
+    vector<int> outgoing_start;
+    vector<pair<int, int>> outgoing;
+    compute_outgoing_transitions(ts, distances, outgoing_start, outgoing);
+
     bool stable = false;
     bool stop_requested = false;
     while (!stable && !stop_requested && num_groups < target_size) {
         stable = true;
 
         signatures.clear();
-        compute_signatures(ts, distances, signatures, state_to_group);
+        compute_signatures(ts, distances, outgoing_start, outgoing,
+                           signatures, state_to_group);
 
         // Verify size of signatures and presence of sentinels.
         assert(static_cast<int>(signatures.size()) == num_states + 2);
@@ -325,6 +403,7 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
        relation since this is one of the code parts relevant to peak
        memory. */
     utils::release_vector_memory(signatures);
+    utils::release_vector_memory(outgoing);
 
     // Generate final result.
     StateEquivalenceRelation equivalence_relation;
@@ -400,6 +479,13 @@ static shared_ptr<ShrinkStrategy>_parse(OptionParser &parser) {
     parser.add_enum_option(
         "at_limit", at_limit,
         "what to do when the size limit is hit", "RETURN");
+    parser.add_option<int>(
+        "threads",
+        "number of threads for computing and sorting the state signatures "
+        "of large transition systems (0 uses all hardware threads). The "
+        "result does not depend on the number of threads.",
+        "1",
+        Bounds("0", "infinity"));
 
     Options opts = parser.parse();
 
@@ -3,6 +3,9 @@
 
 #include "shrink_strategy.h"
 
+#include <utility>
+#include <vector>
+
 namespace options {
 class Options;
 }
@@ -18,6 +21,7 @@ class ShrinkBisimulation : public ShrinkStrategy {
 
     const bool greedy;
     const AtLimit at_limit;
+    const int num_threads;
 
     void compute_abstraction(
         const TransitionSystem &ts,
@@ -30,9 +34,24 @@ class ShrinkBisimulation : public ShrinkStrategy {
         const Distances &distances,
         std::vector<int> &state_to_group) const;
 
+    /*
+      Collect the (label group number, target) pairs of the transitions
+      that the signature of each state depends on, grouped by source state:
+      the pairs of state s are outgoing[outgoing_start[s]] up to
+      outgoing[outgoing_start[s + 1]]. They do not change between the
+      refinement rounds.
+    */
+    void compute_outgoing_transitions(
+        const TransitionSystem &ts,
+        const Distances &distances,
+        std::vector<int> &outgoing_start,
+        std::vector<std::pair<int, int>> &outgoing) const;
+
     void compute_signatures(
         const TransitionSystem &ts,
         const Distances &distances,
+        const std::vector<int> &outgoing_start,
+        const std::vector<std::pair<int, int>> &outgoing,
         std::vector<Signature> &signatures,
         const std::vector<int> &state_to_group) const;
 protected:
@@ -45,6 +64,10 @@ public:
         const TransitionSystem &ts,
         const Distances &distances,
         int target_size) const override;
+    // Deterministic and keeps no state between calls.
+    virtual bool allows_concurrent_calls() const override {
+        return true;
+    }
 };
 }
 
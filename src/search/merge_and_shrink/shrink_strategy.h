@@ -37,6 +37,18 @@ public:
         const Distances &distances,
         int target_size) const = 0;
 
+    /*
+      Return true if compute_equivalence_relation may be called for several
+      transition systems at the same time without changing its results.
+      Strategies that draw from a shared random number generator must not
+      be called concurrently.
+
+      The default implementation returns false.
+    */
+    virtual bool allows_concurrent_calls() const {
+        return false;
+    }
+
     void dump_options() const;
     std::string get_name() const;
 };
@@ -8,4 +8,5 @@ namespace merge_and_shrink {
 const int INF = numeric_limits<int>::max();
 const int MINUSINF = numeric_limits<int>::min();
 const int PRUNED_STATE = -1;
+const int MIN_STATES_FOR_THREADS = 10000;
 }
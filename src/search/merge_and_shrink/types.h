@@ -15,6 +15,12 @@ extern const int INF;
 extern const int MINUSINF;
 extern const int PRUNED_STATE;
 
+/*
+  Transition systems with fewer states are handled on one thread because
+  starting threads costs more than the work they would share.
+*/
+extern const int MIN_STATES_FOR_THREADS;
+
 /*
   An equivalence class is a set of abstract states that shall be
   mapped (shrunk) to the same abstract state.
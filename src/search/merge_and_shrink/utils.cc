@@ -52,17 +52,25 @@ pair<int, int> compute_shrink_sizes(
     return make_pair(new_size1, new_size2);
 }
 
+bool needs_shrinking(
+    const TransitionSystem &ts,
+    int new_size,
+    int shrink_threshold_before_merge) {
+    return ts.get_size() > min(new_size, shrink_threshold_before_merge);
+}
+
 bool shrink_factor(
     FactoredTransitionSystem &fts,
     int index,
     int new_size,
     int shrink_threshold_before_merge,
     const ShrinkStrategy &shrink_strategy,
-    Verbosity verbosity) {
+    Verbosity verbosity,
+    const StateEquivalenceRelation *equivalence_relation) {
     const TransitionSystem &ts = fts.get_ts(index);
     assert(ts.is_solvable());
     int num_states = ts.get_size();
-    if (num_states > min(new_size, shrink_threshold_before_merge)) {
+    if (needs_shrinking(ts, new_size, shrink_threshold_before_merge)) {
         if (verbosity >= Verbosity::VERBOSE) {
             cout << ts.tag() << "current size: " << num_states;
             if (new_size < num_states)
@@ -71,6 +79,8 @@ bool shrink_factor(
                 cout << " (shrink threshold: " << shrink_threshold_before_merge;
             cout << ")" << endl;
         }
+        if (equivalence_relation)
+            return fts.shrink(index, *equivalence_relation, verbosity);
         return fts.shrink(index, new_size, shrink_strategy, verbosity);
     }
     return false;
@@ -1,13 +1,14 @@
 #ifndef MERGE_AND_SHRINK_UTILS_H
 #define MERGE_AND_SHRINK_UTILS_H
 
+#include "types.h"
+
 #include <vector>
 
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
 class ShrinkStrategy;
 class TransitionSystem;
-enum class Verbosity;
 
 /*
   Compute target sizes for shrinking two transition systems with sizes size1
@@ -28,11 +29,24 @@ extern std::pair<int, int> compute_shrink_sizes(
     int max_states_after_merge);
 
 /*
-  This method checks if the transition system of the factor at index violates
-  the size limit given via new_size (e.g. as computed by compute_shrink_sizes)
-  or the threshold shrink_threshold_before_merge that triggers shrinking even
-  if the size limit is not violated. If so, call fts.shrink() to shrink the
-  factor. Return true iff the factor was actually shrunk.
+  Return true iff the transition system violates the size limit given via
+  new_size (e.g. as computed by compute_shrink_sizes) or the threshold
+  shrink_threshold_before_merge that triggers shrinking even if the size
+  limit is not violated.
+*/
+extern bool needs_shrinking(
+    const TransitionSystem &ts,
+    int new_size,
+    int shrink_threshold_before_merge);
+
+/*
+  This method checks if the transition system of the factor at index needs
+  shrinking (see above). If so, call fts.shrink() to shrink the factor.
+  Return true iff the factor was actually shrunk.
+
+  If equivalence_relation is given, it must have been computed by
+  shrink_strategy for the factor and is applied instead of computing it
+  again.
 */
 extern bool shrink_factor(
     FactoredTransitionSystem &fts,
@@ -40,7 +54,8 @@ extern bool shrink_factor(
     int new_size,
     int shrink_threshold_before_merge,
     const ShrinkStrategy &shrink_strategy,
-    Verbosity verbosity);
+    Verbosity verbosity,
+    const StateEquivalenceRelation *equivalence_relation = nullptr);
 
 extern bool is_goal_relevant(const TransitionSystem &ts);
 }
@@ -68,6 +68,25 @@ public:
 
     // certain external search methods reconstruct paths using open lists
     virtual std::vector<const GlobalOperator*> trace_path(const Entry&);
+
+    /*
+      Used by engines that expand several nodes in parallel.
+
+      remove_min_batch replaces the contents of batch with up to max_entries
+      nodes that may be expanded independently of each other. The default
+      implementation removes a single node.
+
+      insert_concurrently may be called by several threads at once, each
+      passing its own thread_index, for states that are not dead ends.
+      Open lists that support this override it; the default
+      implementation simply calls insert and must only be used from a
+      single thread.
+    */
+    virtual void remove_min_batch(std::vector<Entry> &batch,
+                                  std::size_t max_entries);
+    virtual void insert_concurrently(int thread_index,
+                                     EvaluationContext &eval_context,
+                                     const Entry &entry);
 #else
     virtual Entry remove_min(std::vector<int> *key = 0) = 0;
 #endif
@@ -186,6 +205,20 @@ std::vector<const GlobalOperator *>
 OpenList<Entry>::trace_path(const Entry&) {
     return std::vector<const GlobalOperator*>();
 }
+
+template<class Entry>
+void OpenList<Entry>::remove_min_batch(std::vector<Entry> &batch,
+                                       std::size_t) {
+    batch.clear();
+    batch.push_back(remove_min());
+}
+
+template<class Entry>
+void OpenList<Entry>::insert_concurrently(int,
+                                          EvaluationContext &eval_context,
+                                          const Entry &entry) {
+    insert(eval_context, entry);
+}
 #endif
 
 #endif
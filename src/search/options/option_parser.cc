@@ -5,6 +5,7 @@
 #include "plugin.h"
 #include "synergy.h"
 
+#include "../axioms.h"
 #include "../globals.h"
 
 #include "../ext/tree_util.hh"
@@ -243,6 +244,15 @@ shared_ptr<SearchEngine> OptionParser::parse_cmd_line_aux(
             g_num_previously_generated_plans = parse_int_arg(arg, args[i]);
             if (g_num_previously_generated_plans < 0)
                 throw ArgError("argument for --internal-previous-portfolio-plans must be positive");
+        } else if (arg == "--validate-axioms") {
+            if (is_last)
+                throw ArgError("missing argument after --validate-axioms");
+            ++i;
+            int interval = parse_int_arg(arg, args[i]);
+            if (interval < 1)
+                throw ArgError("argument for --validate-axioms must be positive");
+            if (!dry_run)
+                g_axiom_evaluator->set_validation_interval(interval);
         } else {
             throw ArgError("unknown option " + arg);
         }
@@ -265,6 +275,10 @@ string OptionParser::usage(const string &progname) {
            "--heuristic HEURISTIC_PREDEFINITION\n"
            "    Predefines a heuristic that can afterwards be referenced\n"
            "    by the name that is specified in the definition.\n"
+           "--validate-axioms INTERVAL\n"
+           "    Compares every INTERVAL-th incremental evaluation of axioms\n"
+           "    in successor states to a full evaluation and aborts if they\n"
+           "    differ.\n"
            "--internal-plan-file FILENAME\n"
            "    Plan will be output to a file called FILENAME\n\n"
            "--internal-previous-portfolio-plans COUNTER\n"
@@ -0,0 +1,26 @@
+#ifndef PACKED_STATE_VIEW_H
+#define PACKED_STATE_VIEW_H
+
+#include "algorithms/int_packer.h"
+
+/*
+  Read-only view of the variable values of a packed state. Lookup
+  heuristics such as PDBs and M&S only read a few variables per state,
+  so they take them directly from the packed bins instead of unpacking
+  all of them into a State. Values are those of the root task.
+*/
+class PackedStateView {
+    const int_packer::IntPacker &packer;
+    const int_packer::IntPacker::Bin *buffer;
+public:
+    PackedStateView(const int_packer::IntPacker &packer,
+                    const int_packer::IntPacker::Bin *buffer)
+        : packer(packer), buffer(buffer) {
+    }
+
+    int operator[](int var) const {
+        return packer.get(buffer, var);
+    }
+};
+
+#endif
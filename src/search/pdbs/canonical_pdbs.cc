@@ -3,6 +3,8 @@
 #include "dominance_pruning.h"
 #include "pattern_database.h"
 
+#include "../packed_state_view.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -23,7 +25,8 @@ CanonicalPDBs::CanonicalPDBs(
     }
 }
 
-int CanonicalPDBs::get_value(const State &state) const {
+template<typename StateType>
+int CanonicalPDBs::compute_value(const StateType &state) const {
     // If we have an empty collection, then max_additive_subsets = { \emptyset }.
     assert(!max_additive_subsets->empty());
     int max_h = 0;
@@ -41,4 +44,36 @@ int CanonicalPDBs::get_value(const State &state) const {
     }
     return max_h;
 }
+
+int CanonicalPDBs::get_value(const State &state) const {
+    return compute_value(state);
+}
+
+int CanonicalPDBs::get_value(const PackedStateView &state) const {
+    return compute_value(state);
+}
+
+// Same as compute_value, but each PDB looks up all states at once.
+void CanonicalPDBs::get_values(const vector<PackedStateView> &states,
+                               vector<int> &values) const {
+    assert(!max_additive_subsets->empty());
+    const int infinity = numeric_limits<int>::max();
+    values.assign(states.size(), 0);
+    vector<int> subset_values(states.size());
+    vector<int> pdb_values;
+    for (const auto &subset : *max_additive_subsets) {
+        fill(subset_values.begin(), subset_values.end(), 0);
+        for (const shared_ptr<PatternDatabase> &pdb : subset) {
+            pdb->get_values(states, pdb_values);
+            for (size_t i = 0; i < states.size(); ++i) {
+                if (pdb_values[i] == infinity)
+                    subset_values[i] = infinity;
+                else if (subset_values[i] != infinity)
+                    subset_values[i] += pdb_values[i];
+            }
+        }
+        for (size_t i = 0; i < states.size(); ++i)
+            values[i] = max(values[i], subset_values[i]);
+    }
+}
 }
@@ -4,13 +4,17 @@
 #include "types.h"
 
 #include <memory>
+#include <vector>
 
+class PackedStateView;
 class State;
 
 namespace pdbs {
 class CanonicalPDBs {
     std::shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets;
 
+    template<typename StateType>
+    int compute_value(const StateType &state) const;
 public:
     CanonicalPDBs(const std::shared_ptr<PDBCollection> &pattern_databases,
                   const std::shared_ptr<MaxAdditivePDBSubsets> &max_additive_subsets,
@@ -18,6 +22,9 @@ public:
     ~CanonicalPDBs() = default;
 
     int get_value(const State &state) const;
+    int get_value(const PackedStateView &state) const;
+    void get_values(const std::vector<PackedStateView> &states,
+                    std::vector<int> &values) const;
 };
 }
 
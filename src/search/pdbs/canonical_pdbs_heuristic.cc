@@ -1,21 +1,100 @@
 #include "canonical_pdbs_heuristic.h"
 
+#include "pattern_database.h"
 #include "pattern_generator.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/task_properties.h"
+#include "../utils/table_file.h"
 #include "../utils/timer.h"
 
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <unordered_map>
 
 using namespace std;
 
 namespace pdbs {
+/*
+  The PDBs are followed by the additive subsets, each given by the
+  positions of its PDBs in the collection.
+*/
+static void save_collection(utils::TableWriter &writer,
+                            const PDBCollection &pdbs,
+                            const MaxAdditivePDBSubsets &max_additive_subsets) {
+    writer.write_value(pdbs.size());
+    unordered_map<const PatternDatabase *, int> pdb_ids;
+    for (size_t i = 0; i < pdbs.size(); ++i) {
+        pdb_ids[pdbs[i].get()] = i;
+        pdbs[i]->save(writer);
+    }
+    writer.write_value(max_additive_subsets.size());
+    for (const PDBCollection &subset : max_additive_subsets) {
+        vector<int> subset_ids;
+        for (const shared_ptr<PatternDatabase> &pdb : subset)
+            subset_ids.push_back(pdb_ids.at(pdb.get()));
+        writer.write_vector(subset_ids);
+    }
+}
+
+static bool load_collection(utils::TableReader &reader,
+                            PDBCollection &pdbs,
+                            MaxAdditivePDBSubsets &max_additive_subsets) {
+    size_t num_pdbs = reader.read_value();
+    for (size_t i = 0; i < num_pdbs && reader.is_valid(); ++i)
+        pdbs.push_back(make_shared<PatternDatabase>(reader));
+    size_t num_subsets = reader.read_value();
+    for (size_t i = 0; i < num_subsets && reader.is_valid(); ++i) {
+        PDBCollection subset;
+        for (int pdb_id : reader.read_vector<int>()) {
+            if (pdb_id < 0 || pdb_id >= static_cast<int>(pdbs.size())) {
+                reader.mark_invalid();
+                break;
+            }
+            subset.push_back(pdbs[pdb_id]);
+        }
+        max_additive_subsets.push_back(move(subset));
+    }
+    return reader.is_valid();
+}
+
+static void dump_table_statistics(const PDBCollection &pdbs) {
+    size_t num_entries = 0;
+    size_t table_bytes = 0;
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        num_entries += pdb->get_size();
+        table_bytes += pdb->get_table_bytes();
+    }
+    cout << "PDB collection tables: " << num_entries << " entries, "
+         << table_bytes / 1024 << " KB" << endl;
+}
+
 CanonicalPDBs get_canonical_pdbs_from_options(
     const shared_ptr<AbstractTask> &task, const Options &opts) {
+    bool dominance_pruning = opts.get<bool>("dominance_pruning");
+    bool cache_tables = opts.get<bool>("cache_tables");
+    uint64_t key = 0;
+    string file_name;
+    if (cache_tables) {
+        key = utils::compute_table_key(
+            task_properties::compute_fingerprint(TaskProxy(*task)),
+            opts.get_unparsed_config());
+        file_name = utils::get_table_file_name("cpdbs", key);
+        utils::TableReader reader(file_name, "cpdbs", key);
+        shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>();
+        shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets =
+            make_shared<MaxAdditivePDBSubsets>();
+        if (reader.is_valid() &&
+            load_collection(reader, *pdbs, *max_additive_subsets)) {
+            cout << "Loaded PDB collection from " << file_name << endl;
+            dump_table_statistics(*pdbs);
+            return CanonicalPDBs(pdbs, max_additive_subsets, dominance_pruning);
+        }
+    }
+
     shared_ptr<PatternCollectionGenerator> pattern_generator =
         opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
     utils::Timer timer;
@@ -25,8 +104,14 @@ CanonicalPDBs get_canonical_pdbs_from_options(
     shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets =
         pattern_collection_info.get_max_additive_subsets();
     cout << "PDB collection construction time: " << timer << endl;
+    dump_table_statistics(*pdbs);
 
-    bool dominance_pruning = opts.get<bool>("dominance_pruning");
+    if (cache_tables) {
+        utils::TableWriter writer(file_name, "cpdbs", key);
+        save_collection(writer, *pdbs, *max_additive_subsets);
+        if (writer.commit())
+            cout << "Saved PDB collection to " << file_name << endl;
+    }
     return CanonicalPDBs(pdbs, max_additive_subsets, dominance_pruning);
 }
 
@@ -36,10 +121,33 @@ CanonicalPDBsHeuristic::CanonicalPDBsHeuristic(const Options &opts)
 }
 
 int CanonicalPDBsHeuristic::compute_heuristic(const GlobalState &global_state) {
+#ifdef EXTERNAL_SEARCH
+    if (can_view_packed_state()) {
+        int h = canonical_pdbs.get_value(view_packed_state(global_state));
+        if (h == numeric_limits<int>::max())
+            return DEAD_END;
+        return h;
+    }
+#endif
     State state = convert_global_state(global_state);
     return compute_heuristic(state);
 }
 
+void CanonicalPDBsHeuristic::compute_heuristic_batch(
+    const vector<GlobalState> &states, vector<int> &h_values) {
+#ifdef EXTERNAL_SEARCH
+    if (can_view_packed_state()) {
+        canonical_pdbs.get_values(view_packed_states(states), h_values);
+        for (int &h : h_values) {
+            if (h == numeric_limits<int>::max())
+                h = DEAD_END;
+        }
+        return;
+    }
+#endif
+    Heuristic::compute_heuristic_batch(states, h_values);
+}
+
 int CanonicalPDBsHeuristic::compute_heuristic(const State &state) const {
     int h = canonical_pdbs.get_value(state);
     if (h == numeric_limits<int>::max()) {
@@ -76,6 +184,13 @@ static Heuristic *_parse(OptionParser &parser) {
         "the heuristic value because there are dominating patterns in the "
         "collection.",
         "true");
+    parser.add_option<bool>(
+        "cache_tables",
+        "Store the pattern collection with its PDBs in a file below the "
+        "directory heuristic_tables. Later runs on the same task with the "
+        "same configuration load the PDBs from the file instead of "
+        "computing them again, and concurrent runs share its memory.",
+        "false");
 
     Heuristic::add_options_to_parser(parser);
 
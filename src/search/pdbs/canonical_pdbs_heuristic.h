@@ -12,6 +12,9 @@ class CanonicalPDBsHeuristic : public Heuristic {
 
 protected:
     virtual int compute_heuristic(const GlobalState &state) override;
+    virtual void compute_heuristic_batch(
+        const std::vector<GlobalState> &states,
+        std::vector<int> &h_values) override;
     /* TODO: we want to get rid of compute_heuristic(const GlobalState &state)
        and change the interface to only use State objects. While we are doing
        this, the following method already allows to get the heuristic value
@@ -21,6 +24,10 @@ protected:
 public:
     explicit CanonicalPDBsHeuristic(const options::Options &opts);
     virtual ~CanonicalPDBsHeuristic() = default;
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
 };
 }
 
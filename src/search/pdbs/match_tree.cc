@@ -150,7 +150,7 @@ void MatchTree::get_applicable_operators_recursive(
     if (node->is_leaf_node())
         return;
 
-    int temp = state_index / hash_multipliers[node->var_id];
+    size_t temp = state_index / hash_multipliers[node->var_id];
     int val = temp % node->var_domain_size;
 
     if (node->successors[val]) {
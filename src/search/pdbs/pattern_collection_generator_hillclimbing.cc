@@ -16,6 +16,7 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -37,6 +38,8 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
+      num_threads(opts.get<int>("threads") == 0 ?
+                  utils::get_hardware_threads() : opts.get<int>("threads")),
       rng(utils::parse_rng_from_options(opts)),
       num_rejected(0),
       hill_climbing_timer(0) {
@@ -50,7 +53,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     const causal_graph::CausalGraph &causal_graph = task_proxy.get_causal_graph();
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    vector<Pattern> new_patterns;
     for (int pattern_var : pattern) {
         /* Only consider variables used in preconditions for current
            variable from pattern. It would also make sense to consider
@@ -77,16 +80,26 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(new_pattern);
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    size_t first_new_pdb = candidate_pdbs.size();
+    candidate_pdbs.resize(first_new_pdb + new_patterns.size());
+    utils::run_for_each_in_parallel(
+        num_threads, new_patterns.size(), [&](size_t i) {
+            candidate_pdbs[first_new_pdb + i] =
+                make_shared<PatternDatabase>(task_proxy, new_patterns[i]);
+        });
+    int max_pdb_size = 0;
+    for (size_t i = first_new_pdb; i < candidate_pdbs.size(); ++i)
+        // PDBs in memory have at most numeric_limits<int>::max() states.
+        max_pdb_size = max(max_pdb_size,
+                           static_cast<int>(candidate_pdbs[i]->get_size()));
     return max_pdb_size;
 }
 
@@ -122,44 +135,62 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
+    /*
+      If a candidate's size added to the current collection's size exceeds
+      the maximum collection size, then forget the pdb.
+    */
+    vector<int> candidates;
     for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
         if (!pdb) {
             /* candidate pattern is too large or has already been added to
                the canonical heuristic. */
             continue;
         }
-        /*
-          If a candidate's size added to the current collection's size exceeds
-          the maximum collection size, then forget the pdb.
-        */
         int combined_size = current_pdbs->get_size() + pdb->get_size();
         if (combined_size > collection_max_size) {
             candidate_pdbs[i] = nullptr;
             continue;
         }
+        candidates.push_back(i);
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        MaxAdditivePDBSubsets max_additive_subsets =
-            current_pdbs->get_max_additive_subsets(pdb->get_pattern());
-        for (State &sample : samples) {
-            if (is_heuristic_improved(*pdb, sample, max_additive_subsets))
-                ++count;
-        }
+    // The h values of the current collection are the same for all candidates.
+    vector<int> sample_h_values;
+    sample_h_values.reserve(samples.size());
+    for (const State &sample : samples)
+        sample_h_values.push_back(current_pdbs->get_value(sample));
+
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    vector<int> counts(candidates.size(), 0);
+    utils::run_for_each_in_parallel(
+        num_threads, candidates.size(), [&](size_t candidate) {
+            if (hill_climbing_timer->is_expired())
+                throw HillClimbingTimeout();
+            const PatternDatabase &pdb = *candidate_pdbs[candidates[candidate]];
+            MaxAdditivePDBSubsets max_additive_subsets =
+                current_pdbs->get_max_additive_subsets(pdb.get_pattern());
+            int count = 0;
+            for (size_t j = 0; j < samples.size(); ++j) {
+                if (is_heuristic_improved(pdb, samples[j], sample_h_values[j],
+                                          max_additive_subsets))
+                    ++count;
+            }
+            counts[candidate] = count;
+        });
+
+    for (size_t candidate = 0; candidate < candidates.size(); ++candidate) {
+        int i = candidates[candidate];
+        int count = counts[candidate];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -174,8 +205,8 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
 }
 
 bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
-    const PatternDatabase &pdb, const State &sample,
-    const MaxAdditivePDBSubsets &max_additive_subsets) {
+    const PatternDatabase &pdb, const State &sample, int h_collection,
+    const MaxAdditivePDBSubsets &max_additive_subsets) const {
     // h_pattern: h-value of the new pattern
     int h_pattern = pdb.get_value(sample);
 
@@ -183,8 +214,6 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
         return true;
     }
 
-    // h_collection: h-value of the current collection heuristic
-    int h_collection = current_pdbs->get_value(sample);
     if (h_collection == numeric_limits<int>::max())
         return false;
 
@@ -362,6 +391,13 @@ void add_hillclimbing_options(OptionParser &parser) {
         "is performed at all.",
         "infinity",
         Bounds("0.0", "infinity"));
+    parser.add_option<int>(
+        "threads",
+        "number of threads for building and evaluating candidate PDBs "
+        "(0 uses all hardware threads). The resulting pattern collection "
+        "does not depend on the number of threads, unless max_time is hit.",
+        "1",
+        Bounds("0", "infinity"));
     utils::add_rng_options(parser);
 }
 
@@ -487,6 +523,11 @@ static Heuristic *_parse_ipdb(OptionParser &parser) {
         "the heuristic value because there are dominating patterns in the "
         "collection.",
         "true");
+    parser.add_option<bool>(
+        "cache_tables",
+        "store the resulting PDBs in a file below heuristic_tables and load "
+        "them from there instead of hill climbing in later runs (see cpdbs)",
+        "false");
 
     Heuristic::add_options_to_parser(parser);
 
@@ -505,12 +546,16 @@ static Heuristic *_parse_ipdb(OptionParser &parser) {
     Options heuristic_opts;
     heuristic_opts.set<shared_ptr<AbstractTask>>(
         "transform", opts.get<shared_ptr<AbstractTask>>("transform"));
+#ifndef EXTERNAL_SEARCH
     heuristic_opts.set<bool>(
         "cache_estimates", opts.get<bool>("cache_estimates"));
+#endif
     heuristic_opts.set<shared_ptr<PatternCollectionGenerator>>(
         "patterns", pgh);
     heuristic_opts.set<bool>(
         "dominance_pruning", opts.get<bool>("dominance_pruning"));
+    heuristic_opts.set<bool>("cache_tables", opts.get<bool>("cache_tables"));
+    heuristic_opts.set_unparsed_config(opts.get_unparsed_config());
 
     // Note: in the long run, this should return a shared pointer.
     return new CanonicalPDBsHeuristic(heuristic_opts);
@@ -37,6 +37,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     // minimal improvement required for hill climbing to continue search
     const int min_improvement;
     const double max_time;
+    // threads for building and evaluating candidate PDBs
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
@@ -50,7 +52,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
+      size limit, then the PDB is built and added to candidate_pdbs. The
+      PDBs are built in parallel, but added in the order of their patterns.
 
       The method returns the size of the largest PDB added to candidate_pdbs.
     */
@@ -79,7 +82,9 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     /*
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
-      the index of the best pdb in candidate_pdbs.
+      the index of the best pdb in candidate_pdbs. Candidates are evaluated in
+      parallel; ties are broken in favour of the lowest index, so the result
+      does not depend on the number of threads.
     */
     std::pair<int, int> find_best_improving_pdb(
         std::vector<State> &samples,
@@ -89,12 +94,13 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       Returns true iff the h-value of the new pattern (from pdb) plus the
       h-value of all maximal additive subsets from the current pattern
       collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
+      the h-value of the current pattern collection (h_collection).
     */
     bool is_heuristic_improved(
         const PatternDatabase &pdb,
         const State &sample,
-        const MaxAdditivePDBSubsets &max_additive_subsets);
+        int h_collection,
+        const MaxAdditivePDBSubsets &max_additive_subsets) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
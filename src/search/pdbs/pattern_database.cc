@@ -2,11 +2,14 @@
 
 #include "match_tree.h"
 
+#include "../packed_state_view.h"
+
 #include "../algorithms/priority_queues.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
-#include "../utils/math.h"
+#include "../utils/parallel.h"
+#include "../utils/table_file.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
@@ -70,8 +73,10 @@ PatternDatabase::PatternDatabase(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
     bool dump,
-    const vector<int> &operator_costs)
-    : pattern(pattern) {
+    const vector<int> &operator_costs,
+    int num_threads)
+    : pattern(pattern),
+      mapped_distances(nullptr) {
     task_properties::verify_no_axioms(task_proxy);
     task_properties::verify_no_conditional_effects(task_proxy);
     assert(operator_costs.empty() ||
@@ -79,23 +84,74 @@ PatternDatabase::PatternDatabase(
     assert(utils::is_sorted_unique(pattern));
 
     utils::Timer timer;
+    compute_hash_multipliers(task_proxy, numeric_limits<int>::max());
+    create_pdb(task_proxy, operator_costs, num_threads);
+    if (dump) {
+        cout << "PDB construction time: " << timer << endl;
+        cout << "PDB table: " << num_states << " entries of "
+             << entry_bytes << " bytes" << endl;
+    }
+}
+
+PatternDatabase::PatternDatabase(utils::TableReader &reader)
+    : pattern(reader.read_vector<int>()),
+      num_states(reader.read_value()),
+      entry_bytes(reader.read_value()),
+      mapped_distances(nullptr),
+      mapped_file(reader.get_file()),
+      hash_multipliers(reader.read_vector<size_t>()) {
+    size_t num_distances = 0;
+    switch (entry_bytes) {
+    case 1:
+        mapped_distances = reader.read_array<uint8_t>(num_distances);
+        break;
+    case 2:
+        mapped_distances = reader.read_array<uint16_t>(num_distances);
+        break;
+    case 4:
+        mapped_distances = reader.read_array<int32_t>(num_distances);
+        break;
+    default:
+        reader.mark_invalid();
+    }
+    if (num_distances != num_states || hash_multipliers.size() != pattern.size())
+        reader.mark_invalid();
+}
+
+void PatternDatabase::save(utils::TableWriter &writer) const {
+    writer.write_vector(pattern);
+    writer.write_value(num_states);
+    writer.write_value(entry_bytes);
+    writer.write_vector(hash_multipliers);
+    switch (entry_bytes) {
+    case 1:
+        writer.write_array(get_distances(distances8), num_states);
+        break;
+    case 2:
+        writer.write_array(get_distances(distances16), num_states);
+        break;
+    default:
+        writer.write_array(get_distances(distances32), num_states);
+        break;
+    }
+}
+
+void PatternDatabase::compute_hash_multipliers(
+    const TaskProxy &task_proxy, size_t max_num_states) {
     hash_multipliers.reserve(pattern.size());
     num_states = 1;
     for (int pattern_var_id : pattern) {
         hash_multipliers.push_back(num_states);
         VariableProxy var = task_proxy.get_variables()[pattern_var_id];
-        if (utils::is_product_within_limit(num_states, var.get_domain_size(),
-                                           numeric_limits<int>::max())) {
-            num_states *= var.get_domain_size();
+        size_t domain_size = var.get_domain_size();
+        if (num_states <= max_num_states / domain_size) {
+            num_states *= domain_size;
         } else {
             cerr << "Given pattern is too large! (Overflow occured): " << endl;
             cerr << pattern << endl;
             utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
         }
     }
-    create_pdb(task_proxy, operator_costs);
-    if (dump)
-        cout << "PDB construction time: " << timer << endl;
 }
 
 void PatternDatabase::multiply_out(
@@ -187,16 +243,93 @@ void PatternDatabase::build_abstract_operators(
                  variables, operators);
 }
 
-void PatternDatabase::create_pdb(
-    const TaskProxy &task_proxy, const vector<int> &operator_costs) {
+/*
+  Dijkstra search that settles all states with the smallest open
+  distance d at once. The states of such a layer are final, so their
+  regressions are independent: threads compute them for parts of the
+  layer and collect the improved predecessors, which are then applied in
+  thread order. With unit costs, this is a level-synchronous breadth-first
+  search. Zero-cost operators add states to the current layer, which is
+  processed again. The distances do not depend on the number of threads.
+*/
+static void compute_distances_in_parallel(
+    const MatchTree &match_tree, priority_queues::AdaptiveQueue<size_t> &pq,
+    vector<int> &distances, int num_threads) {
+    // bounds the memory for the improvements collected by the threads
+    const size_t max_chunk_size = 1 << 20;
+    // smaller chunks are regressed by a single thread
+    const size_t min_parallel_chunk_size = 1024;
+
+    vector<size_t> layer;
+    vector<vector<pair<size_t, int>>> improvements(num_threads);
+    while (!pq.empty()) {
+        pair<int, size_t> node = pq.pop();
+        int distance = node.first;
+        layer.clear();
+        while (true) {
+            if (node.first == distances[node.second])
+                layer.push_back(node.second);
+            if (pq.empty())
+                break;
+            node = pq.pop();
+            if (node.first != distance) {
+                pq.push(node.first, node.second);
+                break;
+            }
+        }
+        // a state can be queued several times with the same distance
+        sort(layer.begin(), layer.end());
+        layer.erase(unique(layer.begin(), layer.end()), layer.end());
+
+        for (size_t begin = 0; begin < layer.size(); begin += max_chunk_size) {
+            size_t end = min(begin + max_chunk_size, layer.size());
+            int num_tasks = end - begin < min_parallel_chunk_size ? 1 : num_threads;
+            utils::run_in_parallel(num_tasks, [&](int task) {
+                    vector<pair<size_t, int>> &task_improvements =
+                        improvements[task];
+                    task_improvements.clear();
+                    vector<const AbstractOperator *> applicable_operators;
+                    size_t task_begin = begin + (end - begin) * task / num_tasks;
+                    size_t task_end = begin + (end - begin) * (task + 1) / num_tasks;
+                    for (size_t i = task_begin; i < task_end; ++i) {
+                        size_t state_index = layer[i];
+                        applicable_operators.clear();
+                        match_tree.get_applicable_operators(
+                            state_index, applicable_operators);
+                        for (const AbstractOperator *op : applicable_operators) {
+                            size_t predecessor = state_index + op->get_hash_effect();
+                            int alternative_cost = distance + op->get_cost();
+                            // distances are only written between the parallel parts
+                            if (alternative_cost < distances[predecessor]) {
+                                task_improvements.emplace_back(
+                                    predecessor, alternative_cost);
+                            }
+                        }
+                    }
+                });
+            for (int task = 0; task < num_tasks; ++task) {
+                for (const pair<size_t, int> &improvement : improvements[task]) {
+                    size_t predecessor = improvement.first;
+                    int alternative_cost = improvement.second;
+                    if (alternative_cost < distances[predecessor]) {
+                        distances[predecessor] = alternative_cost;
+                        pq.push(alternative_cost, predecessor);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void PatternDatabase::compute_abstract_operators(
+    const TaskProxy &task_proxy, const vector<int> &operator_costs,
+    vector<AbstractOperator> &operators) {
     VariablesProxy variables = task_proxy.get_variables();
     vector<int> variable_to_index(variables.size(), -1);
     for (size_t i = 0; i < pattern.size(); ++i) {
         variable_to_index[pattern[i]] = i;
     }
 
-    // compute all abstract operators
-    vector<AbstractOperator> operators;
     for (OperatorProxy op : task_proxy.get_operators()) {
         int op_cost;
         if (operator_costs.empty()) {
@@ -207,6 +340,30 @@ void PatternDatabase::create_pdb(
         build_abstract_operators(
             op, op_cost, variable_to_index, variables, operators);
     }
+}
+
+vector<FactPair> PatternDatabase::compute_abstract_goals(
+    const TaskProxy &task_proxy) const {
+    vector<FactPair> abstract_goals;
+    for (FactProxy goal : task_proxy.get_goals()) {
+        int var_id = goal.get_variable().get_id();
+        int val = goal.get_value();
+        auto it = find(pattern.begin(), pattern.end(), var_id);
+        if (it != pattern.end()) {
+            abstract_goals.emplace_back(it - pattern.begin(), val);
+        }
+    }
+    return abstract_goals;
+}
+
+void PatternDatabase::create_pdb(
+    const TaskProxy &task_proxy, const vector<int> &operator_costs,
+    int num_threads) {
+    VariablesProxy variables = task_proxy.get_variables();
+
+    // compute all abstract operators
+    vector<AbstractOperator> operators;
+    compute_abstract_operators(task_proxy, operator_costs, operators);
 
     // build the match tree
     MatchTree match_tree(task_proxy, pattern, hash_multipliers);
@@ -215,15 +372,9 @@ void PatternDatabase::create_pdb(
     }
 
     // compute abstract goal var-val pairs
-    vector<FactPair> abstract_goals;
-    for (FactProxy goal : task_proxy.get_goals()) {
-        int var_id = goal.get_variable().get_id();
-        int val = goal.get_value();
-        if (variable_to_index[var_id] != -1) {
-            abstract_goals.emplace_back(variable_to_index[var_id], val);
-        }
-    }
+    vector<FactPair> abstract_goals = compute_abstract_goals(task_proxy);
 
+    vector<int> distances;
     distances.reserve(num_states);
     // first implicit entry: priority, second entry: index for an abstract state
     priority_queues::AdaptiveQueue<size_t> pq;
@@ -238,6 +389,12 @@ void PatternDatabase::create_pdb(
         }
     }
 
+    if (num_threads > 1) {
+        compute_distances_in_parallel(match_tree, pq, distances, num_threads);
+        store_distances(distances);
+        return;
+    }
+
     // Dijkstra loop
     while (!pq.empty()) {
         pair<int, size_t> node = pq.pop();
@@ -259,6 +416,38 @@ void PatternDatabase::create_pdb(
             }
         }
     }
+    store_distances(distances);
+}
+
+template<typename Entry>
+static void narrow_distances(const vector<int> &distances,
+                             vector<Entry> &narrow_distances) {
+    narrow_distances.reserve(distances.size());
+    for (int distance : distances) {
+        if (distance == numeric_limits<int>::max())
+            narrow_distances.push_back(numeric_limits<Entry>::max());
+        else
+            narrow_distances.push_back(distance);
+    }
+}
+
+void PatternDatabase::store_distances(const vector<int> &distances) {
+    int max_finite_distance = 0;
+    for (int distance : distances) {
+        if (distance != numeric_limits<int>::max())
+            max_finite_distance = max(max_finite_distance, distance);
+    }
+    // the largest value of each entry type is reserved for dead-ends
+    if (max_finite_distance < numeric_limits<uint8_t>::max()) {
+        entry_bytes = 1;
+        narrow_distances(distances, distances8);
+    } else if (max_finite_distance < numeric_limits<uint16_t>::max()) {
+        entry_bytes = 2;
+        narrow_distances(distances, distances16);
+    } else {
+        entry_bytes = 4;
+        distances32.assign(distances.begin(), distances.end());
+    }
 }
 
 bool PatternDatabase::is_goal_state(
@@ -269,7 +458,7 @@ bool PatternDatabase::is_goal_state(
         int pattern_var_id = abstract_goal.var;
         int var_id = pattern[pattern_var_id];
         VariableProxy var = variables[var_id];
-        int temp = state_index / hash_multipliers[pattern_var_id];
+        size_t temp = state_index / hash_multipliers[pattern_var_id];
         int val = temp % var.get_domain_size();
         if (val != abstract_goal.value) {
             return false;
@@ -286,15 +475,85 @@ size_t PatternDatabase::hash_index(const State &state) const {
     return index;
 }
 
+size_t PatternDatabase::hash_index(const PackedStateView &state) const {
+    size_t index = 0;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        index += hash_multipliers[i] * state[pattern[i]];
+    }
+    return index;
+}
+
+template<typename Entry>
+static inline int get_distance(const Entry *distances, size_t index) {
+    Entry distance = distances[index];
+    if (distance == numeric_limits<Entry>::max())
+        return numeric_limits<int>::max();
+    return distance;
+}
+
+template<typename Entry, typename StateType>
+int PatternDatabase::lookup(
+    const Entry *distances, const StateType &state) const {
+    return get_distance(distances, hash_index(state));
+}
+
 int PatternDatabase::get_value(const State &state) const {
-    return distances[hash_index(state)];
+    switch (entry_bytes) {
+    case 1:
+        return lookup(get_distances(distances8), state);
+    case 2:
+        return lookup(get_distances(distances16), state);
+    default:
+        return lookup(get_distances(distances32), state);
+    }
 }
 
-double PatternDatabase::compute_mean_finite_h() const {
+int PatternDatabase::get_value(const PackedStateView &state) const {
+    switch (entry_bytes) {
+    case 1:
+        return lookup(get_distances(distances8), state);
+    case 2:
+        return lookup(get_distances(distances16), state);
+    default:
+        return lookup(get_distances(distances32), state);
+    }
+}
+
+template<typename Entry>
+void PatternDatabase::lookup_values(
+    const Entry *distances, const vector<PackedStateView> &states,
+    vector<int> &values) const {
+    vector<size_t> indices(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        indices[i] = hash_index(states[i]);
+        __builtin_prefetch(&distances[indices[i]]);
+    }
+    values.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i)
+        values[i] = get_distance(distances, indices[i]);
+}
+
+void PatternDatabase::get_values(const vector<PackedStateView> &states,
+                                 vector<int> &values) const {
+    switch (entry_bytes) {
+    case 1:
+        lookup_values(get_distances(distances8), states, values);
+        break;
+    case 2:
+        lookup_values(get_distances(distances16), states, values);
+        break;
+    default:
+        lookup_values(get_distances(distances32), states, values);
+        break;
+    }
+}
+
+template<typename Entry>
+double PatternDatabase::compute_mean_finite_h(const Entry *distances) const {
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
+    for (size_t i = 0; i < num_states; ++i) {
+        if (distances[i] != numeric_limits<Entry>::max()) {
             sum += distances[i];
             ++size;
         }
@@ -306,6 +565,17 @@ double PatternDatabase::compute_mean_finite_h() const {
     }
 }
 
+double PatternDatabase::compute_mean_finite_h() const {
+    switch (entry_bytes) {
+    case 1:
+        return compute_mean_finite_h(get_distances(distances8));
+    case 2:
+        return compute_mean_finite_h(get_distances(distances16));
+    default:
+        return compute_mean_finite_h(get_distances(distances32));
+    }
+}
+
 bool PatternDatabase::is_operator_relevant(const OperatorProxy &op) const {
     for (EffectProxy effect : op.get_effects()) {
         int var_id = effect.get_fact().get_variable().get_id();
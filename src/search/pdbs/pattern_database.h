@@ -5,9 +5,20 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+class PackedStateView;
+
+namespace utils {
+class MappedFile;
+class TableReader;
+class TableWriter;
+}
+
 namespace pdbs {
 class AbstractOperator {
     /*
@@ -77,14 +88,32 @@ class PatternDatabase {
     std::size_t num_states;
 
     /*
-      final h-values for abstract-states.
-      dead-ends are represented by numeric_limits<int>::max()
+      final h-values for abstract-states, stored with the fewest bytes
+      (1, 2 or 4) that hold the largest finite value. The largest value
+      of the entry type represents dead-ends; lookups turn it into
+      numeric_limits<int>::max(). Only the table of entry_bytes is used.
+    */
+    int entry_bytes;
+    std::vector<std::uint8_t> distances8;
+    std::vector<std::uint16_t> distances16;
+    std::vector<std::int32_t> distances32;
+    /*
+      Distances of a PDB loaded from a file are used in place of the
+      memory mapping instead of being copied into the tables above.
     */
-    std::vector<int> distances;
+    const void *mapped_distances;
+    std::shared_ptr<utils::MappedFile> mapped_file;
 
     // multipliers for each variable for perfect hash function
     std::vector<std::size_t> hash_multipliers;
 
+    /*
+      Sets num_states and hash_multipliers for the pattern. Exits if the
+      pattern has more than max_num_states abstract states.
+    */
+    void compute_hash_multipliers(const TaskProxy &task_proxy,
+                                  std::size_t max_num_states);
+
     /*
       Recursive method; called by build_abstract_operators. In the case
       of a precondition with value = -1 in the concrete operator, all
@@ -113,16 +142,31 @@ class PatternDatabase {
         const VariablesProxy &variables,
         std::vector<AbstractOperator> &operators);
 
+    /*
+      Computes the abstract operators of all concrete operators, using
+      operator_costs as in create_pdb.
+    */
+    void compute_abstract_operators(
+        const TaskProxy &task_proxy,
+        const std::vector<int> &operator_costs,
+        std::vector<AbstractOperator> &operators);
+
+    // Returns the goal var-val pairs on pattern variables (by pattern index).
+    std::vector<FactPair> compute_abstract_goals(
+        const TaskProxy &task_proxy) const;
+
     /*
       Computes all abstract operators, builds the match tree (successor
       generator) and then does a Dijkstra regression search to compute
       all final h-values (stored in distances). operator_costs can
       specify individual operator costs for each operator for action
       cost partitioning. If left empty, default operator costs are used.
+      With num_threads > 1, the regression search runs in parallel.
     */
     void create_pdb(
         const TaskProxy &task_proxy,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs,
+        int num_threads);
 
     /*
       For a given abstract state (given as index), the according values
@@ -141,6 +185,25 @@ class PatternDatabase {
       (distances) during search.
     */
     std::size_t hash_index(const State &state) const;
+    std::size_t hash_index(const PackedStateView &state) const;
+
+    // Chooses the entry size and fills the matching table.
+    void store_distances(const std::vector<int> &distances);
+
+    template<typename Entry>
+    const Entry *get_distances(const std::vector<Entry> &owned_table) const {
+        if (mapped_distances)
+            return static_cast<const Entry *>(mapped_distances);
+        return owned_table.data();
+    }
+    template<typename Entry, typename StateType>
+    int lookup(const Entry *distances, const StateType &state) const;
+    template<typename Entry>
+    void lookup_values(const Entry *distances,
+                       const std::vector<PackedStateView> &states,
+                       std::vector<int> &values) const;
+    template<typename Entry>
+    double compute_mean_finite_h(const Entry *distances) const;
 public:
     /*
       Important: It is assumed that the pattern (passed via Options) is
@@ -151,15 +214,51 @@ public:
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       num_threads:    Number of threads for the regression search.
     */
     PatternDatabase(
         const TaskProxy &task_proxy,
         const Pattern &pattern,
         bool dump = false,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs = std::vector<int>(),
+        int num_threads = 1);
+#ifdef EXTERNAL_SEARCH
+    /*
+      Computes the PDB with a regression search that keeps its layers in
+      bucket files and its table in a memory-mapped file, for patterns
+      whose tables do not fit into memory (see
+      pattern_database_on_disk.cc). Duplicate detection works on one
+      bucket of states_per_bucket consecutive states at a time, so only
+      that part of the table needs to be in memory. The PDB is written to
+      file_name as by save() with the given key and used in place. The
+      number of abstract states may exceed numeric_limits<int>::max().
+    */
+    PatternDatabase(
+        const TaskProxy &task_proxy,
+        const Pattern &pattern,
+        const std::string &file_name,
+        std::uint64_t key,
+        std::size_t states_per_bucket,
+        bool dump = false);
+#endif
+    /*
+      Loads a PDB written by save(). The caller has to check that the
+      reader is still valid afterwards.
+    */
+    explicit PatternDatabase(utils::TableReader &reader);
     ~PatternDatabase() = default;
 
+    void save(utils::TableWriter &writer) const;
+
     int get_value(const State &state) const;
+    int get_value(const PackedStateView &state) const;
+    /*
+      Looks up the values of several states at once. All table indices
+      are computed and prefetched before the first value is read, so the
+      cache misses of independent states overlap.
+    */
+    void get_values(const std::vector<PackedStateView> &states,
+                    std::vector<int> &values) const;
 
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
@@ -167,10 +266,15 @@ public:
     }
 
     // Returns the size (number of abstract states) of the PDB
-    int get_size() const {
+    std::size_t get_size() const {
         return num_states;
     }
 
+    // Returns the number of bytes of the distance table
+    std::size_t get_table_bytes() const {
+        return num_states * entry_bytes;
+    }
+
     /*
       Returns the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
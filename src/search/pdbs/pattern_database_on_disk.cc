@@ -0,0 +1,400 @@
+#include "pattern_database.h"
+
+#include "match_tree.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+#include "../utils/table_file.h"
+#include "../utils/timer.h"
+
+#include "../external/utils/block_reader.h"
+#include "../external/utils/block_writer.h"
+#include "../external/utils/errors.h"
+#include "../external/utils/named_fstream.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+  Regression search for pattern databases whose tables do not fit into
+  memory, with delayed duplicate detection as in A*-DDD.
+
+  The table lives in a memory-mapped scratch file. States are only ever
+  handled as table indices, which are stored in bucket files: the states
+  of the current layer (the frontier) and, for every pending distance,
+  the generated predecessors (the candidates). Candidates are partitioned
+  by index range into buckets, so duplicate detection for a bucket only
+  touches its part of the table. Generating predecessors with the match
+  tree does not look at the table at all.
+
+  Layers are settled in order of increasing distance, so with general
+  costs this is Dijkstra's algorithm; zero-cost operators add candidates
+  to the current distance, which is then settled again.
+
+  Entries start with 8 bits and are widened when a distance does not fit
+  any more, so the scratch table is no larger than the final one.
+*/
+
+namespace pdbs {
+static const char *const BUCKET_DIRECTORY = "pdb_buckets";
+
+// Record of the bucket files: the table index of an abstract state.
+struct StateIndexRecord {
+    size_t index;
+
+    static size_t get_size_in_bytes() {
+        return sizeof(size_t);
+    }
+
+    void write(char *buffer) const {
+        memcpy(buffer, &index, sizeof(index));
+    }
+
+    void read(const char *buffer) {
+        memcpy(&index, buffer, sizeof(index));
+    }
+};
+
+class StateIndexFile {
+    named_fstream file;
+    BlockWriter<StateIndexRecord> writer;
+    size_t num_records;
+public:
+    explicit StateIndexFile(const string &file_name)
+        : file(file_name),
+          writer(file),
+          num_records(0) {
+    }
+
+    void add(size_t index) {
+        writer.write(StateIndexRecord {index});
+        ++num_records;
+    }
+
+    size_t size() const {
+        return num_records;
+    }
+
+    template<typename Callback>
+    void for_each(const Callback &callback) {
+        writer.flush();
+        file.clear();
+        file.seekg(0, ios::beg);
+        BlockReader<StateIndexRecord> reader(file);
+        StateIndexRecord record;
+        while (reader.read(record))
+            callback(record.index);
+    }
+};
+
+// A file of the given size that is mapped for reading and writing.
+class ScratchTable {
+    string file_name;
+    int fd;
+    char *data;
+    size_t size;
+public:
+    explicit ScratchTable(const string &file_name)
+        : file_name(file_name),
+          fd(open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)),
+          data(nullptr),
+          size(0) {
+        if (fd == -1)
+            throw IOException("Fail to create " + file_name);
+    }
+
+    ~ScratchTable() {
+        if (data)
+            munmap(data, size);
+        close(fd);
+        remove(file_name.c_str());
+    }
+
+    ScratchTable(const ScratchTable &) = delete;
+    ScratchTable &operator=(const ScratchTable &) = delete;
+
+    // Keeps the first min(size, new_size) bytes.
+    void resize(size_t new_size) {
+        if (data)
+            munmap(data, size);
+        data = nullptr;
+        size = new_size;
+        if (ftruncate(fd, size) != 0)
+            throw IOException("Fail to resize " + file_name);
+        void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            throw IOException("Fail to map " + file_name);
+        data = static_cast<char *>(mapping);
+    }
+
+    template<typename Entry>
+    Entry *get_entries() {
+        return reinterpret_cast<Entry *>(data);
+    }
+};
+
+/*
+  Converts the num_entries entries of From at the start of table into
+  entries of To in place, keeping the dead-end value. The table must be
+  large enough for the wider type. Entries are moved from the end, in
+  chunks through a buffer, so no entry is overwritten before it is read.
+*/
+template<typename From, typename To>
+static void widen_entries(ScratchTable &table, size_t num_entries) {
+    static_assert(sizeof(To) > sizeof(From), "entries must get wider");
+    const size_t chunk_size = 1 << 16;
+    vector<From> from(chunk_size);
+    vector<To> to(chunk_size);
+    char *data = table.get_entries<char>();
+    size_t end = num_entries;
+    while (end > 0) {
+        size_t begin = end - min(end, chunk_size);
+        size_t count = end - begin;
+        memcpy(from.data(), data + begin * sizeof(From), count * sizeof(From));
+        for (size_t i = 0; i < count; ++i) {
+            if (from[i] == numeric_limits<From>::max())
+                to[i] = numeric_limits<To>::max();
+            else
+                to[i] = from[i];
+        }
+        memcpy(data + begin * sizeof(To), to.data(), count * sizeof(To));
+        end = begin;
+    }
+}
+
+class OnDiskRegression {
+    const MatchTree &match_tree;
+    const size_t num_states;
+    const size_t states_per_bucket;
+    const size_t num_buckets;
+
+    // Candidates for each pending distance, one file per bucket or nullptr.
+    map<int, vector<unique_ptr<StateIndexFile>>> candidates;
+    unique_ptr<StateIndexFile> frontier;
+    int frontier_distance;
+    int num_files;
+    int num_layers;
+    size_t max_layer_size;
+
+    unique_ptr<StateIndexFile> create_file() {
+        return utils::make_unique_ptr<StateIndexFile>(
+            string(BUCKET_DIRECTORY) + "/" + to_string(num_files++) +
+            ".bucket");
+    }
+
+    void add_candidate(int distance, size_t index) {
+        vector<unique_ptr<StateIndexFile>> &buckets = candidates[distance];
+        if (buckets.empty())
+            buckets.resize(num_buckets);
+        unique_ptr<StateIndexFile> &bucket = buckets[index / states_per_bucket];
+        if (!bucket)
+            bucket = create_file();
+        bucket->add(index);
+    }
+
+    // Writes the predecessors of the frontier to the candidate buckets.
+    void expand_frontier() {
+        vector<const AbstractOperator *> applicable_operators;
+        frontier->for_each([&](size_t state_index) {
+                applicable_operators.clear();
+                match_tree.get_applicable_operators(
+                    state_index, applicable_operators);
+                for (const AbstractOperator *op : applicable_operators) {
+                    add_candidate(frontier_distance + op->get_cost(),
+                                  state_index + op->get_hash_effect());
+                }
+            });
+        max_layer_size = max(max_layer_size, frontier->size());
+        frontier = nullptr;
+    }
+
+    /*
+      Turns the candidates with the smallest pending distance that are not
+      in the table yet into the new frontier, bucket by bucket.
+    */
+    template<typename Entry>
+    void settle_next_layer(Entry *table) {
+        auto next = candidates.begin();
+        frontier_distance = next->first;
+        vector<unique_ptr<StateIndexFile>> buckets = move(next->second);
+        candidates.erase(next);
+        frontier = create_file();
+        for (unique_ptr<StateIndexFile> &bucket : buckets) {
+            if (!bucket)
+                continue;
+            bucket->for_each([&](size_t state_index) {
+                    if (table[state_index] == numeric_limits<Entry>::max()) {
+                        table[state_index] = frontier_distance;
+                        frontier->add(state_index);
+                    }
+                });
+            // removes the file
+            bucket = nullptr;
+        }
+        ++num_layers;
+    }
+public:
+    OnDiskRegression(const MatchTree &match_tree, size_t num_states,
+                     size_t states_per_bucket)
+        : match_tree(match_tree),
+          num_states(num_states),
+          states_per_bucket(states_per_bucket),
+          num_buckets((num_states + states_per_bucket - 1) / states_per_bucket),
+          frontier_distance(0),
+          num_files(0),
+          num_layers(0),
+          max_layer_size(0) {
+        mkdir(BUCKET_DIRECTORY, 0744);
+    }
+
+    ~OnDiskRegression() {
+        candidates.clear();
+        frontier = nullptr;
+        rmdir(BUCKET_DIRECTORY);
+    }
+
+    // Fills the 8-bit table with the goal states at distance 0.
+    template<typename IsGoal>
+    void initialize(uint8_t *table, const IsGoal &is_goal) {
+        frontier = create_file();
+        frontier_distance = 0;
+        for (size_t state_index = 0; state_index < num_states; ++state_index) {
+            if (is_goal(state_index)) {
+                table[state_index] = 0;
+                frontier->add(state_index);
+            } else {
+                table[state_index] = numeric_limits<uint8_t>::max();
+            }
+        }
+        ++num_layers;
+        expand_frontier();
+    }
+
+    /*
+      Settles layers until no candidates are left, in which case it
+      returns true, or until the next distance does not fit into Entry
+      (the largest value marks dead ends), in which case it returns false.
+    */
+    template<typename Entry>
+    bool run(Entry *table) {
+        while (!candidates.empty()) {
+            if (candidates.begin()->first >= numeric_limits<Entry>::max())
+                return false;
+            settle_next_layer(table);
+            expand_frontier();
+        }
+        return true;
+    }
+
+    // The largest finite distance, once run() has returned true.
+    int get_max_distance() const {
+        return frontier_distance;
+    }
+
+    void dump_statistics() const {
+        cout << "PDB regression on disk: " << num_layers << " layers, "
+             << "largest layer " << max_layer_size << " states, "
+             << num_buckets << " buckets of at most " << states_per_bucket
+             << " states" << endl;
+    }
+};
+
+PatternDatabase::PatternDatabase(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const string &file_name,
+    uint64_t key,
+    size_t states_per_bucket,
+    bool dump)
+    : pattern(pattern),
+      mapped_distances(nullptr) {
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+    assert(states_per_bucket > 0);
+
+    utils::Timer timer;
+    // The table is addressed by size_t, also for 4-byte entries.
+    compute_hash_multipliers(
+        task_proxy, numeric_limits<size_t>::max() / sizeof(int32_t));
+    vector<AbstractOperator> operators;
+    compute_abstract_operators(task_proxy, vector<int>(), operators);
+    MatchTree match_tree(task_proxy, pattern, hash_multipliers);
+    for (const AbstractOperator &op : operators) {
+        match_tree.insert(op);
+    }
+    vector<FactPair> abstract_goals = compute_abstract_goals(task_proxy);
+    VariablesProxy variables = task_proxy.get_variables();
+
+    try {
+        mkdir(utils::TABLE_DIRECTORY, 0777);
+        ScratchTable table(file_name + ".distances");
+        OnDiskRegression regression(match_tree, num_states, states_per_bucket);
+
+        table.resize(num_states * sizeof(uint8_t));
+        regression.initialize(
+            table.get_entries<uint8_t>(), [&](size_t state_index) {
+                return is_goal_state(state_index, abstract_goals, variables);
+            });
+        entry_bytes = 1;
+        if (!regression.run(table.get_entries<uint8_t>())) {
+            table.resize(num_states * sizeof(uint16_t));
+            widen_entries<uint8_t, uint16_t>(table, num_states);
+            entry_bytes = 2;
+            if (!regression.run(table.get_entries<uint16_t>())) {
+                table.resize(num_states * sizeof(int32_t));
+                widen_entries<uint16_t, int32_t>(table, num_states);
+                entry_bytes = 4;
+                if (!regression.run(table.get_entries<int32_t>())) {
+                    cerr << "PDB distances exceed the table entries." << endl;
+                    utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+                }
+            }
+        }
+        if (dump)
+            regression.dump_statistics();
+
+        mapped_distances = table.get_entries<char>();
+        utils::TableWriter writer(file_name, "pdb", key);
+        save(writer);
+        mapped_distances = nullptr;
+        if (!writer.commit())
+            utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    } catch (const IOException &exception) {
+        cerr << exception.what() << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+
+    // Use the written table in place, like a PDB loaded from the file.
+    utils::TableReader reader(file_name, "pdb", key);
+    PatternDatabase loaded(reader);
+    if (!reader.is_valid()) {
+        cerr << "Could not read " << file_name << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+    mapped_distances = loaded.mapped_distances;
+    mapped_file = loaded.mapped_file;
+
+    if (dump) {
+        cout << "PDB construction time: " << timer << endl;
+        cout << "PDB table: " << num_states << " entries of "
+             << entry_bytes << " bytes" << endl;
+    }
+}
+}
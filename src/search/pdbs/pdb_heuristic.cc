@@ -6,6 +6,12 @@
 #include "../plugin.h"
 #include "../task_proxy.h"
 
+#include "../task_utils/task_properties.h"
+#include "../utils/parallel.h"
+#include "../utils/table_file.h"
+
+#include <cstdio>
+#include <iostream>
 #include <limits>
 #include <memory>
 
@@ -14,11 +20,58 @@ using namespace std;
 namespace pdbs {
 PatternDatabase get_pdb_from_options(const shared_ptr<AbstractTask> &task,
                                      const Options &opts) {
+    TaskProxy task_proxy(*task);
+    bool cache_tables = opts.get<bool>("cache_tables");
+#ifdef EXTERNAL_SEARCH
+    bool on_disk = opts.get<bool>("on_disk");
+#else
+    bool on_disk = false;
+#endif
+    uint64_t key = 0;
+    string file_name;
+    if (cache_tables || on_disk) {
+        key = utils::compute_table_key(
+            task_properties::compute_fingerprint(task_proxy),
+            opts.get_unparsed_config());
+        file_name = utils::get_table_file_name("pdb", key);
+    }
+    if (cache_tables) {
+        utils::TableReader reader(file_name, "pdb", key);
+        if (reader.is_valid()) {
+            PatternDatabase pdb(reader);
+            if (reader.is_valid()) {
+                cout << "Loaded PDB from " << file_name << endl;
+                return pdb;
+            }
+        }
+    }
+
     shared_ptr<PatternGenerator> pattern_generator =
         opts.get<shared_ptr<PatternGenerator>>("pattern");
     Pattern pattern = pattern_generator->generate(task);
-    TaskProxy task_proxy(*task);
-    return PatternDatabase(task_proxy, pattern, true);
+#ifdef EXTERNAL_SEARCH
+    if (on_disk) {
+        PatternDatabase pdb(task_proxy, pattern, file_name, key,
+                            opts.get<int>("states_per_bucket"), true);
+        // the PDB keeps the file mapped, so it can be removed right away
+        if (cache_tables)
+            cout << "Saved PDB to " << file_name << endl;
+        else
+            remove(file_name.c_str());
+        return pdb;
+    }
+#endif
+    int num_threads = opts.get<int>("threads");
+    if (num_threads == 0)
+        num_threads = utils::get_hardware_threads();
+    PatternDatabase pdb(task_proxy, pattern, true, vector<int>(), num_threads);
+    if (cache_tables) {
+        utils::TableWriter writer(file_name, "pdb", key);
+        pdb.save(writer);
+        if (writer.commit())
+            cout << "Saved PDB to " << file_name << endl;
+    }
+    return pdb;
 }
 
 PDBHeuristic::PDBHeuristic(const Options &opts)
@@ -27,10 +80,33 @@ PDBHeuristic::PDBHeuristic(const Options &opts)
 }
 
 int PDBHeuristic::compute_heuristic(const GlobalState &global_state) {
+#ifdef EXTERNAL_SEARCH
+    if (can_view_packed_state()) {
+        int h = pdb.get_value(view_packed_state(global_state));
+        if (h == numeric_limits<int>::max())
+            return DEAD_END;
+        return h;
+    }
+#endif
     State state = convert_global_state(global_state);
     return compute_heuristic(state);
 }
 
+void PDBHeuristic::compute_heuristic_batch(const vector<GlobalState> &states,
+                                           vector<int> &h_values) {
+#ifdef EXTERNAL_SEARCH
+    if (can_view_packed_state()) {
+        pdb.get_values(view_packed_states(states), h_values);
+        for (int &h : h_values) {
+            if (h == numeric_limits<int>::max())
+                h = DEAD_END;
+        }
+        return;
+    }
+#endif
+    Heuristic::compute_heuristic_batch(states, h_values);
+}
+
 int PDBHeuristic::compute_heuristic(const State &state) const {
     int h = pdb.get_value(state);
     if (h == numeric_limits<int>::max())
@@ -52,6 +128,35 @@ static Heuristic *_parse(OptionParser &parser) {
         "pattern",
         "pattern generation method",
         "greedy()");
+    parser.add_option<bool>(
+        "cache_tables",
+        "store the PDB in a file below the directory heuristic_tables and "
+        "load it from there in later runs with the same task and "
+        "configuration",
+        "false");
+    parser.add_option<int>(
+        "threads",
+        "number of threads for the regression search that computes the "
+        "PDB (0 uses all hardware threads)",
+        "1",
+        Bounds("0", "infinity"));
+#ifdef EXTERNAL_SEARCH
+    parser.add_option<bool>(
+        "on_disk",
+        "compute the PDB with a regression search that keeps its layers in "
+        "bucket files and the table in a file below heuristic_tables, for "
+        "patterns whose tables do not fit into memory. Unlike PDBs in "
+        "memory, the pattern may have more than 2^31 abstract states "
+        "(ignores threads)",
+        "false");
+    parser.add_option<int>(
+        "states_per_bucket",
+        "number of consecutive abstract states per bucket of the on-disk "
+        "regression; duplicate detection keeps one bucket of the table in "
+        "memory at a time",
+        "100000000",
+        Bounds("1", "infinity"));
+#endif
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
@@ -18,6 +18,9 @@ class PDBHeuristic : public Heuristic {
     PatternDatabase pdb;
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
+    virtual void compute_heuristic_batch(
+        const std::vector<GlobalState> &states,
+        std::vector<int> &h_values) override;
     /* TODO: we want to get rid of compute_heuristic(const GlobalState &state)
        and change the interface to only use State objects. While we are doing
        this, the following method already allows to get the heuristic value
@@ -35,6 +38,10 @@ public:
     */
     PDBHeuristic(const options::Options &opts);
     virtual ~PDBHeuristic() override = default;
+
+    virtual bool supports_concurrent_evaluation() const override {
+        return true;
+    }
 };
 }
 
@@ -2,6 +2,7 @@
 
 #include "pattern_database.h"
 
+#include "../packed_state_view.h"
 #include "../task_proxy.h"
 
 #include "../utils/logging.h"
@@ -39,7 +40,8 @@ ZeroOnePDBs::ZeroOnePDBs(
 }
 
 
-int ZeroOnePDBs::get_value(const State &state) const {
+template<typename StateType>
+int ZeroOnePDBs::compute_value(const StateType &state) const {
     /*
       Because we use cost partitioning, we can simply add up all
       heuristic values of all patterns in the pattern collection.
@@ -54,6 +56,14 @@ int ZeroOnePDBs::get_value(const State &state) const {
     return h_val;
 }
 
+int ZeroOnePDBs::get_value(const State &state) const {
+    return compute_value(state);
+}
+
+int ZeroOnePDBs::get_value(const PackedStateView &state) const {
+    return compute_value(state);
+}
+
 double ZeroOnePDBs::compute_approx_mean_finite_h() const {
     double approx_mean_finite_h = 0;
     for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
@@ -3,17 +3,22 @@
 
 #include "types.h"
 
+class PackedStateView;
 class State;
 class TaskProxy;
 
 namespace pdbs {
 class ZeroOnePDBs {
     PDBCollection pattern_databases;
+
+    template<typename StateType>
+    int compute_value(const StateType &state) const;
 public:
     ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns);
     ~ZeroOnePDBs() = default;
 
     int get_value(const State &state) const;
+    int get_value(const PackedStateView &state) const;
     /*
       Returns the sum of all mean finite h-values of every PDB.
       This is an approximation of the real mean finite h-value of the Heuristic,
@@ -27,6 +27,14 @@ ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
 }
 
 int ZeroOnePDBsHeuristic::compute_heuristic(const GlobalState &global_state) {
+#ifdef EXTERNAL_SEARCH
+    if (can_view_packed_state()) {
+        int h = zero_one_pdbs.get_value(view_packed_state(global_state));
+        if (h == numeric_limits<int>::max())
+            return DEAD_END;
+        return h;
+    }
+#endif
     State state = convert_global_state(global_state);
     return compute_heuristic(state);
 }
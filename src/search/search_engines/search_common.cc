@@ -10,7 +10,10 @@
 #ifdef EXTERNAL_SEARCH
 #include "../external/closed_list_factory.h"
 #include "../external/closed_lists/compress/compress_closed_list.h"
+#include "../external/closed_lists/in_memory/in_memory_closed_list.h"
+#include "../external/open_lists/external_greedy_open_list.h"
 #include "../external/open_lists/external_tiebreaking_open_list.h"
+#include "../external/open_lists/in_memory_tiebreaking_open_list.h"
 #include "../external/open_lists/external_astar_open_list.h"
 #include "../external/open_lists/astar_ddd_open_list.h"
 
@@ -30,20 +33,47 @@ using GEval = g_evaluator::GEvaluator;
 using SumEval = sum_evaluator::SumEvaluator;
 using WeightedEval = weighted_evaluator::WeightedEvaluator;
 
+/*
+  Helper function for creating a single g + w * h evaluator
+  for weighted A*-style search.
+
+  If w = 1, we do not introduce an unnecessary weighted evaluator:
+  we use g + h instead of g + 1 * h.
+
+  If w = 0, we omit the heuristic altogether:
+  we use g instead of g + 0 * h.
+*/
+static Evaluator *create_wastar_eval(GEval *g_eval, int w, Evaluator *h_eval) {
+    if (w == 0)
+        return g_eval;
+    Evaluator *w_h_eval = nullptr;
+    if (w == 1)
+        w_h_eval = h_eval;
+    else
+        w_h_eval = new WeightedEval(h_eval, w);
+    return new SumEval(vector<Evaluator *>({g_eval, w_h_eval}));
+}
+
 #ifdef EXTERNAL_SEARCH
+    static shared_ptr<OpenListFactory>
+    create_external_tiebreaking_open_list_factory(Evaluator *f, Evaluator *h) {
+        vector<Evaluator *> evals = {f, h};
+        Options options;
+        options.set("evals", evals);
+        return make_shared<external_tiebreaking_open_list::
+                           ExternalTieBreakingOpenListFactory>(options);
+    }
+
     tuple<shared_ptr<OpenListFactory>, shared_ptr<ClosedListFactory>, Evaluator *>
     create_compress_factories_and_f_eval(const options::Options &opts) {
             GEval *g = new GEval();
             Evaluator *h = opts.get<Evaluator *>("eval");
-            Evaluator *f = new SumEval(vector<Evaluator *>({g, h}));
-            vector<Evaluator *> evals = {f, h};
+            Evaluator *f = create_wastar_eval(g, opts.get<int>("w"), h);
 
-            Options options;
-            options.set("evals", evals);
             shared_ptr<OpenListFactory> open =
-                make_shared<external_tiebreaking_open_list::
-                            ExternalTieBreakingOpenListFactory>(options);
-            
+                create_external_tiebreaking_open_list_factory(f, h);
+
+            Options options;
             options.set("reopen_closed", opts.get<bool>("reopen_closed"));
             options.set("enable_partitioning", true); // set this as user option?
             options.set("double_hashing", true); // set this as user option?
@@ -53,15 +83,81 @@ using WeightedEval = weighted_evaluator::WeightedEvaluator;
             return make_tuple(open, closed, f);
     }
 
+    vector<shared_ptr<OpenListFactory> >
+    create_anytime_open_list_factories(const options::Options &opts) {
+        vector<shared_ptr<OpenListFactory> > factories;
+        if (!opts.get<bool>("anytime"))
+            return factories;
+        GEval *g = new GEval();
+        Evaluator *h = opts.get<Evaluator *>("eval");
+        for (int w = opts.get<int>("w") - 1; w >= 1; --w) {
+            factories.push_back(create_external_tiebreaking_open_list_factory(
+                                    create_wastar_eval(g, w, h), h));
+        }
+        return factories;
+    }
+
+    tuple<shared_ptr<OpenListFactory>, shared_ptr<ClosedListFactory> >
+    create_greedy_factories(const options::Options &opts) {
+        Options options;
+        options.set("eval", opts.get<Evaluator *>("eval"));
+        options.set("use_preferred",
+                    !opts.get_list<Heuristic *>("preferred").empty());
+        options.set("boost", opts.get<int>("boost"));
+        shared_ptr<OpenListFactory> open =
+            make_shared<external_greedy_open_list::
+                        ExternalGreedyOpenListFactory>(options);
+
+        options.set("reopen_closed", opts.get<bool>("reopen_closed"));
+        options.set("enable_partitioning", true);
+        options.set("double_hashing", true);
+        shared_ptr<ClosedListFactory> closed =
+            make_shared<compress_closed_list::
+                        CompressClosedListFactory>(options);
+        return make_tuple(open, closed);
+    }
+
+    tuple<shared_ptr<OpenListFactory>, shared_ptr<ClosedListFactory>,
+          shared_ptr<OpenListFactory>, shared_ptr<ClosedListFactory>,
+          Evaluator *>
+    create_hybrid_factories_and_f_eval(const options::Options &opts) {
+        GEval *g = new GEval();
+        Evaluator *h = opts.get<Evaluator *>("eval");
+        Evaluator *f = create_wastar_eval(g, opts.get<int>("w"), h);
+        vector<Evaluator *> evals = {f, h};
+
+        Options options;
+        options.set("evals", evals);
+        options.set("reopen_closed", opts.get<bool>("reopen_closed"));
+        shared_ptr<OpenListFactory> open =
+            make_shared<in_memory_tiebreaking_open_list::
+                        InMemoryTieBreakingOpenListFactory>(options);
+        shared_ptr<ClosedListFactory> closed =
+            make_shared<in_memory_closed_list::
+                        InMemoryClosedListFactory>(options);
+
+        options.set("enable_partitioning", true);
+        options.set("double_hashing", true);
+        shared_ptr<OpenListFactory> external_open =
+            make_shared<external_tiebreaking_open_list::
+                        ExternalTieBreakingOpenListFactory>(options);
+        shared_ptr<ClosedListFactory> external_closed =
+            make_shared<compress_closed_list::
+                        CompressClosedListFactory>(options);
+        return make_tuple(open, closed, external_open, external_closed, f);
+    }
+
     tuple<shared_ptr<OpenListFactory>, Evaluator *>
     create_external_astar_open_list_factory_and_f_eval(const options::Options &opts) {
         GEval *g = new GEval();
         Evaluator *h = opts.get<Evaluator *>("eval");
-        Evaluator *f = new SumEval(vector<Evaluator *>({g, h}));
+        Evaluator *f = create_wastar_eval(g, opts.get<int>("w"), h);
         vector<Evaluator *> evals = {f, h};
         
         Options options;
         options.set("evals", evals);
+        options.set("threads", opts.get<int>("threads"));
+        options.set("compress", opts.get<bool>("compress"));
         // set size of merge runs here instead of hardcoding?
         shared_ptr<OpenListFactory> open =
             make_shared<external_astar_open_list::
@@ -73,7 +169,7 @@ using WeightedEval = weighted_evaluator::WeightedEvaluator;
     create_astar_ddd_open_list_factory_and_f_eval(const options::Options &opts) {
         GEval *g = new GEval();
         Evaluator *h = opts.get<Evaluator *>("eval");
-        Evaluator *f = new SumEval(vector<Evaluator *>({g, h}));
+        Evaluator *f = create_wastar_eval(g, opts.get<int>("w"), h);
         vector<Evaluator *> evals = {f, h};
         
         Options options;
@@ -138,27 +234,6 @@ shared_ptr<OpenListFactory> create_greedy_open_list_factory(
         options.get<int>("boost"));
 }
 
-/*
-  Helper function for creating a single g + w * h evaluator
-  for weighted A*-style search.
-
-  If w = 1, we do not introduce an unnecessary weighted evaluator:
-  we use g + h instead of g + 1 * h.
-
-  If w = 0, we omit the heuristic altogether:
-  we use g instead of g + 0 * h.
-*/
-static Evaluator *create_wastar_eval(GEval *g_eval, int w, Evaluator *h_eval) {
-    if (w == 0)
-        return g_eval;
-    Evaluator *w_h_eval = nullptr;
-    if (w == 1)
-        w_h_eval = h_eval;
-    else
-        w_h_eval = new WeightedEval(h_eval, w);
-    return new SumEval(vector<Evaluator *>({g_eval, w_h_eval}));
-}
-
 shared_ptr<OpenListFactory> create_wastar_open_list_factory(
     const Options &options) {
     vector<Evaluator *> base_evals =
@@ -22,6 +22,7 @@
 
 #ifdef EXTERNAL_SEARCH
 #include <tuple>
+#include <vector>
 #endif
 
 class Evaluator;
@@ -39,10 +40,42 @@ namespace search_common {
 
 #ifdef EXTERNAL_SEARCH
 
+/*
+  The external factories below order nodes by g + w * h, using "eval" as
+  the h evaluator and "w" as the weight (see create_wastar_open_list_factory).
+*/
 extern std::tuple<std::shared_ptr<OpenListFactory>,
                   std::shared_ptr<ClosedListFactory>, Evaluator *>
 create_compress_factories_and_f_eval(const options::Options& opts);
 
+/*
+  Create external tie-breaking open list factories ordered by g + w' * h
+  for w' = w - 1, ..., 1, used by anytime search to tighten the weight after
+  each solution. Returns an empty vector unless "anytime" is set.
+*/
+extern std::vector<std::shared_ptr<OpenListFactory> >
+create_anytime_open_list_factories(const options::Options& opts);
+
+/*
+  Create the external open list factory for greedy best-first search on
+  "eval", with a queue for preferred successors if "preferred" is non-empty
+  (boosted by "boost"), and a compress closed list factory.
+*/
+extern std::tuple<std::shared_ptr<OpenListFactory>,
+                  std::shared_ptr<ClosedListFactory> >
+create_greedy_factories(const options::Options& opts);
+
+/*
+  Create in-memory open and closed list factories for the first phase of the
+  hybrid engine, the external (compress) factories it switches to when memory
+  runs low, and the f evaluator shared by both phases.
+*/
+extern std::tuple<std::shared_ptr<OpenListFactory>,
+                  std::shared_ptr<ClosedListFactory>,
+                  std::shared_ptr<OpenListFactory>,
+                  std::shared_ptr<ClosedListFactory>, Evaluator *>
+create_hybrid_factories_and_f_eval(const options::Options& opts);
+
 extern std::tuple<std::shared_ptr<OpenListFactory>, Evaluator *>
 create_external_astar_open_list_factory_and_f_eval(const options::Options& opts);
 
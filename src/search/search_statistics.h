@@ -49,6 +49,7 @@ public:
     size_t get_evaluations() const {return evaluations; }
     size_t get_generated() const {return generated_states; }
     size_t get_reopened() const {return reopened_states; }
+    size_t get_dead_ends() const {return dead_end_states; }
     size_t get_generated_ops() const {return generated_ops; }
 
     /*
@@ -5,7 +5,7 @@
 using namespace std;
 
 #ifdef EXTERNAL_SEARCH
-std::size_t StateID::value_counter = 0;
+std::atomic<std::size_t> StateID::value_counter(0);
 //#include <limits>
 const StateID StateID::no_state = StateID();
 #else
@@ -5,15 +5,18 @@
 #include <iostream>
 
 #ifdef EXTERNAL_SEARCH
+#include <atomic>
 
 class StateID {
     friend std::ostream &operator<<(std::ostream &os, StateID id);
+    friend class GlobalState; // stores values in compact node records
     
-    static std::size_t value_counter;
+    // atomic, since parallel engines generate states on several threads
+    static std::atomic<std::size_t> value_counter;
     
     std::size_t value;
     
-    // StateID(std::size_t value) : value(value) {} //only for no_state
+    explicit StateID(std::size_t value) : value(value) {}
     
  public:
     StateID() : value(++value_counter) {}
@@ -6,6 +6,7 @@
 #include "algorithms/int_packer.h"
 #include "global_operator.h"
 #include "global_state.h"
+#include "globals.h"
 #include "operator_cost.h"
 
 #include <vector>
@@ -22,7 +23,49 @@ StateRegistry::StateRegistry(
       axiom_evaluator(axiom_evaluator),
       initial_state_data(initial_state_data),
       num_variables(initial_state_data.size()),
-      cost_type(cost_type) {}
+      cost_type(cost_type) {
+    compile_operators();
+}
+
+void StateRegistry::compile_operators() {
+    compiled_operators.resize(g_operators.size());
+    vector<bool> has_effect(num_variables, false);
+    for (size_t op_id = 0; op_id < g_operators.size(); ++op_id) {
+        const vector<GlobalEffect> &effects = g_operators[op_id].get_effects();
+        CompiledOperator &compiled = compiled_operators[op_id];
+        bool mergeable = true;
+        for (const GlobalEffect &effect : effects) {
+            if (!effect.conditions.empty() || has_effect[effect.var])
+                mergeable = false;
+            has_effect[effect.var] = true;
+        }
+        for (const GlobalEffect &effect : effects)
+            has_effect[effect.var] = false;
+
+        if (!mergeable) {
+            for (const GlobalEffect &effect : effects)
+                compiled.unmerged_effects.push_back(&effect);
+            continue;
+        }
+        for (const GlobalEffect &effect : effects) {
+            int_packer::IntPacker::VariableLocation location =
+                state_packer.get_location(effect.var);
+            auto update = find_if(compiled.bin_updates.begin(),
+                                  compiled.bin_updates.end(),
+                                  [&](const BinUpdate &update) {
+                    return update.bin_index == location.bin_index;
+                });
+            if (update == compiled.bin_updates.end()) {
+                compiled.bin_updates.push_back({location.bin_index,
+                                                ~PackedStateBin(0), 0});
+                update = compiled.bin_updates.end() - 1;
+            }
+            update->clear_mask &= ~location.mask;
+            update->set_bits |= PackedStateBin(effect.val) << location.shift;
+            compiled.effects.emplace_back(effect.var, effect.val);
+        }
+    }
+}
 
 
 int StateRegistry::get_bins_per_state() const {
@@ -49,32 +92,55 @@ const GlobalState StateRegistry::get_initial_state() {
         state_packer.set(&buffer[0], i, initial_state_data[i]);
     }
     axiom_evaluator.evaluate(&buffer[0], state_packer);
-    // seems costly to copy buffer each time in constructor
-    // TODO:: use move semantics for buffer
-    return GlobalState(buffer);
+    return GlobalState(&buffer[0]);
 }
     
     
 GlobalState StateRegistry::
 get_successor_state(const GlobalState &predecessor, const GlobalOperator *op) {
     assert(!op.is_axiom());
-    std::vector<PackedStateBin> buffer(predecessor.get_packed_vec());
-    for (size_t i = 0; i < op->get_effects().size(); ++i) {
-        const GlobalEffect &effect = op->get_effects()[i];
-        if (effect.does_fire(predecessor))
-            state_packer.set(&buffer[0], effect.var, effect.val);
+    size_t parent_hash_value = predecessor.get_hash_value();
+    // effects are applied in place to the packed state of the new node
+    GlobalState successor(predecessor.get_packed_buffer(),
+                          predecessor.get_state_id(),
+                          get_op_index_hacked(op),
+                          predecessor.get_g() +
+                          get_adjusted_action_cost(*op, cost_type),
+                          parent_hash_value);
+    PackedStateBin *buffer = successor.get_packed_buffer();
+    const CompiledOperator &compiled =
+        compiled_operators[get_op_index_hacked(op)];
+    // Derived variables change outside of effects, so with axioms the hash
+    // value is computed from scratch when it is needed.
+    bool incremental_hash =
+        GlobalState::has_incremental_hash_function() && !has_axioms();
+    size_t hash_value = parent_hash_value;
+    if (incremental_hash) {
+        for (const FactPair &effect : compiled.effects) {
+            int old_value = state_packer.get(buffer, effect.var);
+            hash_value = GlobalState::update_hash_value(
+                hash_value, effect.var, old_value, effect.value);
+        }
     }
-    axiom_evaluator.evaluate(&buffer[0], state_packer);
-
-    auto parent_hash_value = predecessor.get_hash_value();
-    // seems costly to copy buffer each time in constructor
-    // TODO:: use move semantics for buffer
-    return GlobalState(buffer,
-                       predecessor.get_state_id(),
-                       get_op_index_hacked(op),
-                       predecessor.get_g() +
-                       get_adjusted_action_cost(*op, cost_type),
-                       parent_hash_value);
+    for (const BinUpdate &update : compiled.bin_updates) {
+        PackedStateBin &bin = buffer[update.bin_index];
+        bin = (bin & update.clear_mask) | update.set_bits;
+    }
+    for (const GlobalEffect *effect : compiled.unmerged_effects) {
+        if (effect->does_fire(predecessor)) {
+            if (incremental_hash) {
+                int old_value = state_packer.get(buffer, effect->var);
+                hash_value = GlobalState::update_hash_value(
+                    hash_value, effect->var, old_value, effect->val);
+            }
+            state_packer.set(buffer, effect->var, effect->val);
+        }
+    }
+    axiom_evaluator.evaluate_successor(buffer, state_packer,
+                                       get_op_index_hacked(op));
+    if (incremental_hash)
+        successor.set_hash_value(hash_value);
+    return successor;
 }
 
 int StateRegistry::get_state_size_in_bytes() const {
@@ -166,7 +232,8 @@ GlobalState StateRegistry::get_successor_state(const GlobalState &predecessor, c
         if (effect.does_fire(predecessor))
             state_packer.set(buffer, effect.var, effect.val);
     }
-    axiom_evaluator.evaluate(buffer, state_packer);
+    axiom_evaluator.evaluate_successor(buffer, state_packer,
+                                       get_op_index_hacked(&op));
     StateID id = insert_id_or_pop_state();
     return lookup_state(id);
 }
@@ -24,14 +24,34 @@
 
 
 class StateRegistry {
+    /*
+      Operators are compiled for the packed state layout when the registry
+      is created. Unconditional effects are merged into one word operation
+      per bin. Operators with conditional effects, or with several effects
+      on one variable, apply their effects one by one instead.
+    */
+    struct BinUpdate {
+        int bin_index;
+        PackedStateBin clear_mask;
+        PackedStateBin set_bits;
+    };
+    struct CompiledOperator {
+        std::vector<BinUpdate> bin_updates;
+        // the effects merged into bin_updates, for incremental hashing
+        std::vector<FactPair> effects;
+        std::vector<const GlobalEffect *> unmerged_effects;
+    };
+
     const AbstractTask &task;
     const int_packer::IntPacker &state_packer;
     AxiomEvaluator &axiom_evaluator;
     const std::vector<int> &initial_state_data;
     const int num_variables;
     OperatorCost cost_type;
+    std::vector<CompiledOperator> compiled_operators;
     
     int get_bins_per_state() const;
+    void compile_operators();
  public:
     StateRegistry(
         const AbstractTask &task,
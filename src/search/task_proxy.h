@@ -684,6 +684,10 @@ public:
     }
 
     const causal_graph::CausalGraph &get_causal_graph() const;
+
+    bool operator==(const TaskProxy &other) const {
+        return task == other.task;
+    }
 };
 
 
@@ -1,6 +1,7 @@
 #include "successor_generator.h"
 
 #include "../global_state.h"
+#include "../globals.h"
 
 #include "../utils/collections.h"
 
@@ -9,144 +10,17 @@
 
 using namespace std;
 
-/* NOTE on possible optimizations:
-
-   * Sharing "GeneratorEmpty" instances might help quite a bit with
-     reducing memory usage and possibly even speed, because there are
-     bound to be many instance of those. However, it complicates
-     deleting the successor generator, and memory doesn't seem to be
-     an issue. Speed appears to be fine now, too. So this is probably
-     an unnecessary complication.
-
-   * Using slist instead of list led to a further 10% speedup on the
-     largest Logistics instance, logistics-98/prob28.pddl. It would of
-     course also reduce memory usage. However, it would make the code
-     g++-specific, so it's probably not worth it.
-
-*/
-
 namespace successor_generator {
+static const int NO_NODE = -1;
+static const int LEAF = -1;
+
 bool smaller_variable_id(const FactProxy &f1, const FactProxy &f2) {
     return f1.get_variable().get_id() < f2.get_variable().get_id();
 }
 
-class GeneratorBase {
-public:
-    virtual ~GeneratorBase() = default;
-    virtual void generate_applicable_ops(
-        const State &state, vector<OperatorID> &applicable_ops) const = 0;
-    // Transitional method, used until the search is switched to the new task interface.
-    virtual void generate_applicable_ops(
-        const GlobalState &state, vector<OperatorID> &applicable_ops) const = 0;
-};
-
-class GeneratorSwitch : public GeneratorBase {
-    VariableProxy switch_var;
-    list<OperatorID> immediate_operators;
-    vector<GeneratorBase *> generator_for_value;
-    GeneratorBase *default_generator;
-public:
-    ~GeneratorSwitch();
-    GeneratorSwitch(const VariableProxy &switch_var,
-                    list<OperatorID> &&immediate_operators,
-                    const vector<GeneratorBase *> &&generator_for_value,
-                    GeneratorBase *default_generator);
-    virtual void generate_applicable_ops(
-        const State &state, vector<OperatorID> &applicable_ops) const;
-    // Transitional method, used until the search is switched to the new task interface.
-    virtual void generate_applicable_ops(
-        const GlobalState &state, vector<OperatorID> &applicable_ops) const;
-};
-
-class GeneratorLeaf : public GeneratorBase {
-    list<OperatorID> applicable_operators;
-public:
-    GeneratorLeaf(list<OperatorID> &&applicable_operators);
-    virtual void generate_applicable_ops(
-        const State &state, vector<OperatorID> &applicable_ops) const;
-    // Transitional method, used until the search is switched to the new task interface.
-    virtual void generate_applicable_ops(
-        const GlobalState &state, vector<OperatorID> &applicable_ops) const;
-};
-
-class GeneratorEmpty : public GeneratorBase {
-public:
-    virtual void generate_applicable_ops(
-        const State &state, vector<OperatorID> &applicable_ops) const;
-    // Transitional method, used until the search is switched to the new task interface.
-    virtual void generate_applicable_ops(
-        const GlobalState &state, vector<OperatorID> &applicable_ops) const;
-};
-
-GeneratorSwitch::GeneratorSwitch(
-    const VariableProxy &switch_var, list<OperatorID> &&immediate_operators,
-    const vector<GeneratorBase *> &&generator_for_value,
-    GeneratorBase *default_generator)
-    : switch_var(switch_var),
-      immediate_operators(move(immediate_operators)),
-      generator_for_value(move(generator_for_value)),
-      default_generator(default_generator) {
-}
-
-GeneratorSwitch::~GeneratorSwitch() {
-    for (GeneratorBase *generator : generator_for_value)
-        delete generator;
-    delete default_generator;
-}
-
-void GeneratorSwitch::generate_applicable_ops(
-    const State &state, vector<OperatorID> &applicable_ops) const {
-    /* A loop over push_back is faster than using insert in this situation
-       because the lists are typically very small. We measured this in issue688. */
-    for (OperatorID id : immediate_operators) {
-        applicable_ops.push_back(id);
-    }
-    int val = state[switch_var].get_value();
-    generator_for_value[val]->generate_applicable_ops(state, applicable_ops);
-    default_generator->generate_applicable_ops(state, applicable_ops);
-}
-
-void GeneratorSwitch::generate_applicable_ops(
-    const GlobalState &state, vector<OperatorID> &applicable_ops) const {
-    // See above for the reason for using push_back instead of insert.
-    for (OperatorID id : immediate_operators) {
-        applicable_ops.push_back(id);
-    }
-    int val = state[switch_var.get_id()];
-    generator_for_value[val]->generate_applicable_ops(state, applicable_ops);
-    default_generator->generate_applicable_ops(state, applicable_ops);
-}
-
-GeneratorLeaf::GeneratorLeaf(list<OperatorID> &&applicable_operators)
-    : applicable_operators(move(applicable_operators)) {
-}
-
-void GeneratorLeaf::generate_applicable_ops(
-    const State &, vector<OperatorID> &applicable_ops) const {
-    // See above for the reason for using push_back instead of insert.
-    for (OperatorID id : applicable_operators) {
-        applicable_ops.push_back(id);
-    }
-}
-
-void GeneratorLeaf::generate_applicable_ops(
-    const GlobalState &, vector<OperatorID> &applicable_ops) const {
-    // See above for the reason for using push_back instead of insert.
-    for (OperatorID id : applicable_operators) {
-        applicable_ops.push_back(id);
-    }
-}
-
-void GeneratorEmpty::generate_applicable_ops(
-    const State &, vector<OperatorID> &) const {
-}
-
-void GeneratorEmpty::generate_applicable_ops(
-    const GlobalState &, vector<OperatorID> &) const {
-}
-
 SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
-    : task_proxy(task_proxy) {
+    : task_proxy(task_proxy),
+      is_root_task(task_proxy == TaskProxy(*g_root_task())) {
     OperatorsProxy operators = task_proxy.get_operators();
     // We need the iterators to conditions to be stable:
     conditions.reserve(operators.size());
@@ -164,7 +38,10 @@ SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
         next_condition_by_op.push_back(conditions.back().begin());
     }
 
-    root = unique_ptr<GeneratorBase>(construct_recursive(0, move(all_operators)));
+    root = construct_recursive(0, move(all_operators));
+    nodes.shrink_to_fit();
+    child_nodes.shrink_to_fit();
+    node_operators.shrink_to_fit();
     utils::release_vector_memory(conditions);
     utils::release_vector_memory(next_condition_by_op);
 }
@@ -172,10 +49,26 @@ SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
 SuccessorGenerator::~SuccessorGenerator() {
 }
 
-GeneratorBase *SuccessorGenerator::construct_recursive(
+int SuccessorGenerator::add_node(int var, list<OperatorID> &&operators) {
+    Node node;
+    node.ops_begin = node_operators.size();
+    node_operators.insert(node_operators.end(),
+                          operators.begin(), operators.end());
+    node.ops_end = node_operators.size();
+    node.var = var;
+    node.children_begin = 0;
+    node.default_child = NO_NODE;
+    node.location = int_packer::IntPacker::VariableLocation {0, 0, 0};
+    if (var != LEAF && is_root_task && g_state_packer)
+        node.location = g_state_packer->get_location(var);
+    nodes.push_back(node);
+    return nodes.size() - 1;
+}
+
+int SuccessorGenerator::construct_recursive(
     int switch_var_id, list<OperatorID> &&operator_queue) {
     if (operator_queue.empty())
-        return new GeneratorEmpty;
+        return NO_NODE;
 
     VariablesProxy variables = task_proxy.get_variables();
     int num_variables = variables.size();
@@ -183,7 +76,7 @@ GeneratorBase *SuccessorGenerator::construct_recursive(
     while (true) {
         // Test if no further switch is necessary (or possible).
         if (switch_var_id == num_variables)
-            return new GeneratorLeaf(move(operator_queue));
+            return add_node(LEAF, move(operator_queue));
 
         VariableProxy switch_var = variables[switch_var_id];
         int number_of_children = switch_var.get_domain_size();
@@ -223,19 +116,22 @@ GeneratorBase *SuccessorGenerator::construct_recursive(
         }
 
         if (all_ops_are_immediate) {
-            return new GeneratorLeaf(move(applicable_operators));
+            return add_node(LEAF, move(applicable_operators));
         } else if (var_is_interesting) {
-            vector<GeneratorBase *> generator_for_val;
-            for (list<OperatorID> &ops : operators_for_val) {
-                generator_for_val.push_back(
-                    construct_recursive(switch_var_id + 1, move(ops)));
+            int node_id = add_node(switch_var_id, move(applicable_operators));
+            // children are added behind their parent, value subtrees first
+            int children_begin = child_nodes.size();
+            child_nodes.resize(children_begin + number_of_children, NO_NODE);
+            for (int val = 0; val < number_of_children; ++val) {
+                int child = construct_recursive(
+                    switch_var_id + 1, move(operators_for_val[val]));
+                child_nodes[children_begin + val] = child;
             }
-            GeneratorBase *default_generator = construct_recursive(
+            int default_child = construct_recursive(
                 switch_var_id + 1, move(default_operators));
-            return new GeneratorSwitch(switch_var,
-                                       move(applicable_operators),
-                                       move(generator_for_val),
-                                       default_generator);
+            nodes[node_id].children_begin = children_begin;
+            nodes[node_id].default_child = default_child;
+            return node_id;
         } else {
             // this switch var can be left out because no operator depends on it
             ++switch_var_id;
@@ -244,14 +140,53 @@ GeneratorBase *SuccessorGenerator::construct_recursive(
     }
 }
 
+template<typename ValueReader>
+void SuccessorGenerator::generate_recursive(
+    int node_id, const ValueReader &read_value,
+    vector<OperatorID> &applicable_ops) const {
+    while (node_id != NO_NODE) {
+        const Node &node = nodes[node_id];
+        /* A loop over push_back is faster than using insert in this situation
+           because the lists are typically very small. We measured this in issue688. */
+        for (int i = node.ops_begin; i < node.ops_end; ++i) {
+            applicable_ops.push_back(node_operators[i]);
+        }
+        if (node.var == LEAF)
+            return;
+        int child = child_nodes[node.children_begin + read_value(node)];
+        if (child != NO_NODE)
+            generate_recursive(child, read_value, applicable_ops);
+        // the default subtree is visited without recursion
+        node_id = node.default_child;
+    }
+}
+
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
-    root->generate_applicable_ops(state, applicable_ops);
+    generate_recursive(
+        root, [&state](const Node &node) {
+            return state[node.var].get_value();
+        }, applicable_ops);
 }
 
-
 void SuccessorGenerator::generate_applicable_ops(
     const GlobalState &state, vector<OperatorID> &applicable_ops) const {
-    root->generate_applicable_ops(state, applicable_ops);
+    assert(is_root_task);
+#ifdef EXTERNAL_SEARCH
+    // read switch values directly from the packed bins
+    const PackedStateBin *buffer = state.get_packed_buffer();
+    generate_recursive(
+        root, [buffer](const Node &node) {
+            const int_packer::IntPacker::VariableLocation &location =
+                node.location;
+            return static_cast<int>(
+                (buffer[location.bin_index] & location.mask) >> location.shift);
+        }, applicable_ops);
+#else
+    generate_recursive(
+        root, [&state](const Node &node) {
+            return state[node.var];
+        }, applicable_ops);
+#endif
 }
 }
@@ -3,16 +3,15 @@
 
 #include "../task_proxy.h"
 
+#include "../algorithms/int_packer.h"
+
 #include <list>
-#include <memory>
 #include <vector>
 
 class GlobalOperator;
 class GlobalState;
 
 namespace successor_generator {
-class GeneratorBase;
-
 /*
   NOTE: SuccessorGenerator keeps a reference to the task proxy passed to the
   constructor. Therefore, users of the class must ensure that the task lives at
@@ -20,13 +19,41 @@ class GeneratorBase;
 */
 
 class SuccessorGenerator {
+    /*
+      The decision tree is compiled into flat arrays. A node contributes
+      the operators [ops_begin, ops_end) of node_operators. A switch
+      node continues with child_nodes[children_begin + value] for the
+      value of its variable and then with its default child. Empty
+      subtrees are NO_NODE. Nodes are stored in depth-first order.
+    */
+    struct Node {
+        int ops_begin;
+        int ops_end;
+        // switch variable, or -1 for leaves
+        int var;
+        int children_begin;
+        int default_child;
+        // position of var in packed GlobalStates, only for the root task
+        int_packer::IntPacker::VariableLocation location;
+    };
+
     TaskProxy task_proxy;
+    // GlobalStates hold the variables of the root task only
+    bool is_root_task;
 
-    std::unique_ptr<GeneratorBase> root;
+    std::vector<Node> nodes;
+    std::vector<int> child_nodes;
+    std::vector<OperatorID> node_operators;
+    int root;
 
     typedef std::vector<FactProxy> Condition;
-    GeneratorBase *construct_recursive(
+    int construct_recursive(
         int switch_var_id, std::list<OperatorID> &&operator_queue);
+    int add_node(int var, std::list<OperatorID> &&operators);
+
+    template<typename ValueReader>
+    void generate_recursive(int node_id, const ValueReader &read_value,
+                            std::vector<OperatorID> &applicable_ops) const;
 
     std::vector<Condition> conditions;
     std::vector<Condition::const_iterator> next_condition_by_op;
@@ -1,5 +1,6 @@
 #include "task_properties.h"
 
+#include "../utils/hash.h"
 #include "../utils/system.h"
 
 #include <algorithm>
@@ -82,4 +83,50 @@ int get_min_operator_cost(TaskProxy task_proxy) {
     }
     return min_cost;
 }
+
+static void feed_facts(utils::StableHash &hash, const vector<FactPair> &facts) {
+    hash.feed(facts.size());
+    for (const FactPair &fact : facts) {
+        hash.feed(fact.var);
+        hash.feed(fact.value);
+    }
+}
+
+template<typename OperatorCollection>
+static void feed_operators(utils::StableHash &hash,
+                           const OperatorCollection &operators) {
+    hash.feed(operators.size());
+    for (OperatorProxy op : operators) {
+        hash.feed(op.get_cost());
+        feed_facts(hash, get_fact_pairs(op.get_preconditions()));
+        EffectsProxy effects = op.get_effects();
+        hash.feed(effects.size());
+        for (EffectProxy effect : effects) {
+            feed_facts(hash, get_fact_pairs(effect.get_conditions()));
+            hash.feed(effect.get_fact().get_variable().get_id());
+            hash.feed(effect.get_fact().get_value());
+        }
+    }
+}
+
+uint64_t compute_fingerprint(TaskProxy task_proxy) {
+    utils::StableHash hash;
+    VariablesProxy variables = task_proxy.get_variables();
+    hash.feed(variables.size());
+    for (VariableProxy var : variables) {
+        hash.feed(var.get_domain_size());
+        hash.feed(var.is_derived());
+        if (var.is_derived()) {
+            hash.feed(var.get_axiom_layer());
+            hash.feed(var.get_default_axiom_value());
+        }
+    }
+    State initial_state = task_proxy.get_initial_state();
+    for (int value : initial_state.get_values())
+        hash.feed(value);
+    feed_facts(hash, get_fact_pairs(task_proxy.get_goals()));
+    feed_operators(hash, task_proxy.get_operators());
+    feed_operators(hash, task_proxy.get_axioms());
+    return hash.get_value();
+}
 }
@@ -3,6 +3,8 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+
 namespace task_properties {
 inline bool is_applicable(OperatorProxy op, const State &state) {
     for (FactProxy precondition : op.get_preconditions()) {
@@ -50,6 +52,16 @@ extern std::vector<int> get_operator_costs(const TaskProxy &task_proxy);
 extern double get_average_operator_cost(TaskProxy task_proxy);
 extern int get_min_operator_cost(TaskProxy task_proxy);
 
+/*
+  Return a hash of everything that defines the task: the variables, the
+  initial state, the goal, the operators with their costs and the axioms.
+  Unlike std::hash, the value is the same in every run, so it can identify
+  files with precomputed data for the task.
+
+  Runtime: O(n), where n is the size of the task.
+*/
+extern std::uint64_t compute_fingerprint(TaskProxy task_proxy);
+
 template<class FactProxyCollection>
 std::vector<FactPair> get_fact_pairs(const FactProxyCollection &facts) {
     std::vector<FactPair> fact_pairs;
@@ -75,6 +75,61 @@ std::vector<T> sorted(Collection &&collection) {
     std::sort(vec.begin(), vec.end());
     return vec;
 }
+
+// Ids stored contiguously in an array, for range-based for loops.
+class IdRange {
+    const int *first;
+    const int *last;
+public:
+    IdRange(const int *first, const int *last)
+        : first(first), last(last) {
+    }
+
+    const int *begin() const {
+        return first;
+    }
+
+    const int *end() const {
+        return last;
+    }
+
+    std::size_t size() const {
+        return last - first;
+    }
+};
+
+/*
+  Returns the ids of the given index in a compressed array: the ids of
+  index i are ids[starts[i]..starts[i + 1]).
+*/
+inline IdRange get_id_range(const std::vector<int> &starts,
+                            const std::vector<int> &ids, int index) {
+    return IdRange(ids.data() + starts[index],
+                   ids.data() + starts[index + 1]);
+}
+
+/*
+  Inverts a compressed array that maps indices to ids in [0, num_ids):
+  afterwards, the indices of id j are
+  indices[index_starts[j]..index_starts[j + 1]), in increasing order.
+*/
+inline void invert_id_ranges(const std::vector<int> &starts,
+                             const std::vector<int> &ids, int num_ids,
+                             std::vector<int> &index_starts,
+                             std::vector<int> &indices) {
+    index_starts.assign(num_ids + 1, 0);
+    for (int id : ids)
+        ++index_starts[id + 1];
+    for (int id = 0; id < num_ids; ++id)
+        index_starts[id + 1] += index_starts[id];
+    indices.resize(ids.size());
+    std::vector<int> positions(index_starts.begin(), index_starts.end() - 1);
+    int num_indices = starts.size() - 1;
+    for (int index = 0; index < num_indices; ++index) {
+        for (int i = starts[index]; i < starts[index + 1]; ++i)
+            indices[positions[ids[i]]++] = index;
+    }
+}
 }
 
 #endif
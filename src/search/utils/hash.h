@@ -1,7 +1,9 @@
 #ifndef UTILS_HASH_H
 #define UTILS_HASH_H
 
+#include <cstdint>
 #include <functional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -30,6 +32,38 @@ size_t hash_sequence(const Sequence &data, size_t length) {
     }
     return hash;
 }
+
+/*
+  64-bit FNV-1a hash. Unlike std::hash, its values do not depend on the
+  platform or standard library, so they can identify data in files that
+  outlive a planner run.
+*/
+class StableHash {
+    std::uint64_t hash;
+public:
+    StableHash()
+        : hash(14695981039346656037ULL) {
+    }
+
+    void feed(std::uint64_t value) {
+        for (int byte = 0; byte < 8; ++byte) {
+            hash ^= (value >> (8 * byte)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    void feed(const std::string &value) {
+        feed(value.size());
+        for (char c : value) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    std::uint64_t get_value() const {
+        return hash;
+    }
+};
 }
 
 namespace std {
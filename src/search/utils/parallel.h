@@ -0,0 +1,85 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  Call task(i) for every i in [0, num_tasks), each on its own thread, and
+  wait for all of them. If num_tasks is 1, the task runs on the calling
+  thread. The first exception thrown by any task is rethrown after all
+  threads have been joined.
+*/
+template<typename Task>
+void run_in_parallel(int num_tasks, const Task &task) {
+    if (num_tasks == 1) {
+        task(0);
+        return;
+    }
+    std::vector<std::exception_ptr> exceptions(num_tasks);
+    std::vector<std::thread> threads;
+    threads.reserve(num_tasks);
+    for (int i = 0; i < num_tasks; ++i) {
+        threads.emplace_back([&task, &exceptions, i]() {
+                try {
+                    task(i);
+                } catch (...) {
+                    exceptions[i] = std::current_exception();
+                }
+            });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    for (const std::exception_ptr &exception : exceptions)
+        if (exception)
+            std::rethrow_exception(exception);
+}
+
+/*
+  Call function(i) for every i in [0, num_items) on up to num_threads
+  threads. Items are handed out one at a time, so items of very different
+  cost are balanced across threads; callers that need deterministic
+  results store them by item index. After an exception, the threads stop
+  taking new items and the exception is rethrown as in run_in_parallel.
+*/
+template<typename Function>
+void run_for_each_in_parallel(
+    int num_threads, std::size_t num_items, const Function &function) {
+    if (num_threads == 1 || num_items <= 1) {
+        for (std::size_t i = 0; i < num_items; ++i)
+            function(i);
+        return;
+    }
+    if (static_cast<std::size_t>(num_threads) > num_items)
+        num_threads = num_items;
+    std::atomic<std::size_t> next_item(0);
+    run_in_parallel(num_threads, [&](int) {
+            while (true) {
+                std::size_t i = next_item++;
+                if (i >= num_items)
+                    break;
+                try {
+                    function(i);
+                } catch (...) {
+                    next_item = num_items;
+                    throw;
+                }
+            }
+        });
+}
+
+/*
+  Number of threads to use if the user asks for "as many as possible".
+  Falls back to 1 if the hardware concurrency is unknown.
+*/
+inline int get_hardware_threads() {
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+}
+
+#endif
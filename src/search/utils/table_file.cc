@@ -0,0 +1,172 @@
+#include "table_file.h"
+
+#include "hash.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace utils {
+static const char MAGIC[8] = {'F', 'D', 'T', 'A', 'B', 'L', 'E', 'S'};
+static const uint32_t VERSION = 2;
+static const size_t ALIGNMENT = 8;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t unused;
+    char kind[16];
+    uint64_t key;
+    // total size including the header, written on commit
+    uint64_t file_size;
+};
+
+static FileHeader create_header(const string &kind, uint64_t key) {
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    strncpy(header.kind, kind.c_str(), sizeof(header.kind) - 1);
+    header.key = key;
+    return header;
+}
+
+MappedFile::MappedFile(const string &file_name)
+    : data(nullptr),
+      size(0) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd == -1)
+        return;
+    struct stat file_status;
+    if (fstat(fd, &file_status) == 0 && file_status.st_size > 0) {
+        void *mapping = mmap(nullptr, file_status.st_size, PROT_READ,
+                             MAP_SHARED, fd, 0);
+        if (mapping != MAP_FAILED) {
+            data = static_cast<const char *>(mapping);
+            size = file_status.st_size;
+        }
+    }
+    // the mapping stays valid after closing the file
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data)
+        munmap(const_cast<char *>(data), size);
+}
+
+uint64_t compute_table_key(uint64_t task_fingerprint, const string &config) {
+    StableHash hash;
+    hash.feed(task_fingerprint);
+    hash.feed(config);
+    return hash.get_value();
+}
+
+const char *const TABLE_DIRECTORY = "heuristic_tables";
+
+string get_table_file_name(const string &kind, uint64_t key) {
+    ostringstream name;
+    name << TABLE_DIRECTORY << "/" << kind << "-" << hex << setw(16)
+         << setfill('0') << key << ".tables";
+    return name.str();
+}
+
+TableWriter::TableWriter(
+    const string &file_name, const string &kind, uint64_t key)
+    : file_name(file_name),
+      temp_file_name(file_name + ".tmp." + to_string(getpid())),
+      position(0) {
+    size_t slash = file_name.rfind('/');
+    if (slash != string::npos && slash > 0)
+        mkdir(file_name.substr(0, slash).c_str(), 0777);
+    file.open(temp_file_name, ios::binary | ios::trunc);
+    FileHeader header = create_header(kind, key);
+    write_bytes(&header, sizeof(header));
+}
+
+TableWriter::~TableWriter() {
+    if (file.is_open()) {
+        file.close();
+        remove(temp_file_name.c_str());
+    }
+}
+
+void TableWriter::write_bytes(const void *bytes, size_t count) {
+    file.write(static_cast<const char *>(bytes), count);
+    position += count;
+    static const char zeros[ALIGNMENT] = {};
+    size_t padding = (ALIGNMENT - position % ALIGNMENT) % ALIGNMENT;
+    file.write(zeros, padding);
+    position += padding;
+}
+
+void TableWriter::write_value(uint64_t value) {
+    write_bytes(&value, sizeof(value));
+}
+
+bool TableWriter::commit() {
+    // fill in the size, which readers check before trusting the arrays
+    file.seekp(offsetof(FileHeader, file_size));
+    file.write(reinterpret_cast<const char *>(&position), sizeof(position));
+    file.close();
+    if (file.fail() || rename(temp_file_name.c_str(), file_name.c_str()) != 0) {
+        cerr << "Could not write " << file_name << endl;
+        remove(temp_file_name.c_str());
+        return false;
+    }
+    return true;
+}
+
+TableReader::TableReader(
+    const string &file_name, const string &kind, uint64_t key)
+    : file(make_shared<MappedFile>(file_name)),
+      position(sizeof(FileHeader)),
+      valid(false) {
+    if (!file->is_open() || file->get_size() < sizeof(FileHeader))
+        return;
+    FileHeader expected = create_header(kind, key);
+    FileHeader header;
+    memcpy(&header, file->get_data(), sizeof(header));
+    valid = memcmp(header.magic, expected.magic, sizeof(MAGIC)) == 0 &&
+        header.version == expected.version &&
+        memcmp(header.kind, expected.kind, sizeof(header.kind)) == 0 &&
+        header.key == expected.key &&
+        header.file_size == file->get_size();
+    if (valid) {
+        // tables are looked up at random
+        madvise(const_cast<char *>(file->get_data()), file->get_size(),
+                MADV_RANDOM);
+    }
+}
+
+const char *TableReader::read_bytes(size_t count) {
+    if (!valid || count > file->get_size() - position) {
+        valid = false;
+        return nullptr;
+    }
+    const char *bytes = file->get_data() + position;
+    position += (count + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    if (position > file->get_size())
+        position = file->get_size();
+    return bytes;
+}
+
+uint64_t TableReader::read_value() {
+    const char *bytes = read_bytes(sizeof(uint64_t));
+    if (!bytes)
+        return 0;
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+}
@@ -0,0 +1,150 @@
+#ifndef UTILS_TABLE_FILE_H
+#define UTILS_TABLE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+  Binary files for tables that heuristics precompute for a task, such as
+  pattern databases, so that later runs on the same task can skip the
+  construction.
+
+  A file starts with a header that names the kind of the tables, the
+  format version and a key that identifies the task and the heuristic
+  configuration. It continues with arrays, each stored as its length
+  followed by its entries, padded to 8 bytes. Readers map the file into
+  memory and use the arrays in place, so processes that load the same
+  file share its pages.
+
+  The files are only meant to be read on the machine that wrote them:
+  entries are stored in native byte order.
+*/
+
+namespace utils {
+// Read-only memory mapping of a whole file.
+class MappedFile {
+    const char *data;
+    std::size_t size;
+public:
+    // Leaves the object empty if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string &file_name);
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    bool is_open() const {
+        return data != nullptr;
+    }
+
+    const char *get_data() const {
+        return data;
+    }
+
+    std::size_t get_size() const {
+        return size;
+    }
+};
+
+/*
+  Combines the fingerprint of a task with the configuration string of the
+  heuristic that computes tables for it.
+*/
+extern std::uint64_t compute_table_key(
+    std::uint64_t task_fingerprint, const std::string &config);
+// Files are kept in TABLE_DIRECTORY below the working directory.
+extern const char *const TABLE_DIRECTORY;
+extern std::string get_table_file_name(const std::string &kind,
+                                       std::uint64_t key);
+
+/*
+  Writes to a temporary file that commit() renames to the final name, so
+  concurrent readers never see partial files.
+*/
+class TableWriter {
+    std::string file_name;
+    std::string temp_file_name;
+    std::ofstream file;
+    std::uint64_t position;
+
+    void write_bytes(const void *bytes, std::size_t count);
+public:
+    TableWriter(const std::string &file_name, const std::string &kind,
+                std::uint64_t key);
+    ~TableWriter();
+
+    void write_value(std::uint64_t value);
+
+    template<typename T>
+    void write_array(const T *values, std::size_t count) {
+        write_value(count);
+        write_bytes(values, count * sizeof(T));
+    }
+
+    template<typename T>
+    void write_vector(const std::vector<T> &values) {
+        write_array(values.data(), values.size());
+    }
+
+    // Returns false if the file could not be written.
+    bool commit();
+};
+
+/*
+  Reads the arrays of a file in the order they were written. A missing
+  file, a file of another kind, version or key and reads beyond the end
+  of the file all make the reader invalid; callers check is_valid() after
+  reading and compute the tables themselves if it fails.
+*/
+class TableReader {
+    std::shared_ptr<MappedFile> file;
+    std::size_t position;
+    bool valid;
+
+    const char *read_bytes(std::size_t count);
+public:
+    TableReader(const std::string &file_name, const std::string &kind,
+                std::uint64_t key);
+
+    bool is_valid() const {
+        return valid;
+    }
+
+    // For callers that find the data of a valid file inconsistent.
+    void mark_invalid() {
+        valid = false;
+    }
+
+    std::uint64_t read_value();
+
+    // The returned entries live as long as the mapping, see get_file().
+    template<typename T>
+    const T *read_array(std::size_t &count) {
+        count = read_value();
+        if (count > file->get_size() / sizeof(T)) {
+            valid = false;
+            count = 0;
+            return nullptr;
+        }
+        return reinterpret_cast<const T *>(read_bytes(count * sizeof(T)));
+    }
+
+    template<typename T>
+    std::vector<T> read_vector() {
+        std::size_t count;
+        const T *values = read_array<T>(count);
+        if (!values)
+            return std::vector<T>();
+        return std::vector<T>(values, values + count);
+    }
+
+    const std::shared_ptr<MappedFile> &get_file() const {
+        return file;
+    }
+};
+}
+
+#endif